@@ -0,0 +1,616 @@
+/*
+ * AnalysisConfig.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "AnalysisConfig.h"
+#include "DataPresenceException.h"
+#include "SignalFilter.h"
+#include "EdgeFitter.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+
+//configuration set by AnalysisConfig::setCurrent(...)
+static AnalysisConfig configured;
+//configuration that is currently used, set by AnalysisConfig::setCurrent(...) and AnalysisConfig::Scope
+static const AnalysisConfig* currentConfig = &configured;
+
+/**
+ * Parses a value of a configuration key. The whole value must be a number of the given type.
+ *
+ * @param key Key, for the error message
+ * @param value The value
+ * @return The parsed value
+ *
+ * @throw invalid_argument if the value is no such number
+ */
+template<typename T>
+static T parseValue(const string& key, const string& value)
+{
+	stringstream stream(value);
+	T result;
+	if(!(stream >> result) || !(stream >> ws).eof())
+	{
+		throw invalid_argument("AnalysisConfig: invalid value '" + value + "' for " + key);
+	}
+	return result;
+}
+
+/**
+ * Removes leading and trailing whitespace.
+ *
+ * @param text The text
+ * @return The trimmed text
+ */
+static string trim(const string& text)
+{
+	const size_t first = text.find_first_not_of(" \t\r");
+	if(first == string::npos)
+	{
+		return "";
+	}
+	return text.substr(first,text.find_last_not_of(" \t\r") - first + 1);
+}
+
+/**
+ * Constructor. Creates the default configuration from the constants in globals.h. Zero suppression is on, if the
+ * program was built with ZEROSUP.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+AnalysisConfig::AnalysisConfig()
+{
+	m_offset = ABSOLUTE_OFFSET_ZERO_VOLTAGE;
+	m_threshold = ABSOLUTE_EVENT_THRESHOLD_VOLTAGE;
+	m_negative = true;
+	m_bins_to_time = ADC_BINS_TO_TIME;
+	m_trigger_bin = ADC_TRIGGERPOS_BIN;
+	m_tube_radius = DRIFT_TUBE_RADIUS;
+#ifdef ZEROSUP
+	m_zero_suppression = true;
+#else
+	m_zero_suppression = false;
+#endif
+	m_baseline_bins = 0;
+	m_relative_threshold = RELATIVE_THRESHOLD_VOLTAGE;
+	m_timing = THRESHOLD;
+	m_cfd_fraction = 0.3;
+	m_cfd_window = 10;
+	m_edge_model = EdgeFitter::FERMI;
+	m_sub_bins = 1;
+	m_saturation = SATURATION_MARGIN;
+}
+
+AnalysisConfig::~AnalysisConfig()
+{
+}
+
+/**
+ * Reads a configuration file of key = value lines, see set(...) for the keys. Empty lines and lines starting with # are
+ * ignored, keys that are not in the file keep their default value.
+ *
+ * @brief Read a configuration file
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param filename Path to the file
+ * @return The configuration
+ *
+ * @throw DataPresenceException if the file cannot be opened
+ * @throw invalid_argument for malformed lines, unknown keys and invalid values
+ */
+AnalysisConfig AnalysisConfig::load(const string& filename)
+{
+	ifstream file(filename);
+	if(!file.is_open())
+	{
+		throw DataPresenceException();
+	}
+
+	AnalysisConfig config;
+	string line;
+	while(getline(file,line))
+	{
+		line = trim(line);
+		if(line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+		size_t equalSignPos = line.find('=');
+		if(equalSignPos == string::npos)
+		{
+			throw invalid_argument("AnalysisConfig::load: missing '=' in line '" + line + "'");
+		}
+		const string key = trim(line.substr(0,equalSignPos));
+		if(!config.set(key,trim(line.substr(equalSignPos + 1))))
+		{
+			throw invalid_argument("AnalysisConfig::load: unknown key " + key);
+		}
+	}
+	return config;
+}
+
+/**
+ * Sets one value of the configuration. Known keys are:
+ * 	offset - FADC offset of the zero voltage in channels
+ * 	threshold - event threshold in channels relative to the offset, its sign must match the polarity
+ * 	polarity - negative or positive, whether signals undershoot or exceed the threshold. A threshold of the other
+ * 	polarity is mirrored at the offset, so the polarity is set before the threshold.
+ * 	binstotime - time per FADC bin in ns
+ * 	triggerbin - FADC bin of the trigger
+ * 	radius - tube radius in mm
+ * 	zerosuppression - 1 to reject events without signal while reading, 0 to keep them
+ * 	baselinebins - number of samples at the begin of each event for its baseline and noise, 0 to use the offset
+ * 	relativethreshold - minimum threshold in multiples of the noise of an event, used with baselinebins > 0. Like the
+ * 	threshold it lies in the direction of the polarity, its sign is ignored.
+ * 	filter - filter chain applied to the raw data before the discrimination, see SignalFilter::parse(...)
+ * 	timing - threshold, interpolated or cfd, how the drift time is found within the bin of the threshold crossing
+ * 	cfdfraction - fraction of the pulse amplitude for the constant fraction discriminator, between 0 and 1
+ * 	cfdwindow - number of bins after the threshold crossing, in which the amplitude of the pulse is searched
+ * 	edgefit - fermi or linear, the model of the edges of the drift time spectrum, see EdgeFitter
+ * 	subbins - number of drift time spectrum bins per FADC bin, for interpolated or cfd timing
+ * 	saturation - distance in channels from the end of the FADC range, within which signals are saturated
+ *
+ * @brief Set a value
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param key The key
+ * @param value The value as text
+ * @return False if the key is unknown, nothing is changed then
+ *
+ * @throw invalid_argument if the value is invalid for the key, or a threshold does not match the polarity
+ */
+bool AnalysisConfig::set(const string& key, const string& value)
+{
+	if(key == "offset")
+	{
+		m_offset = parseValue<uint16_t>(key,value);
+	}
+	else if(key == "threshold")
+	{
+		short threshold = parseValue<short>(key,value);
+		if(m_negative ? threshold > 0 : threshold < 0)
+		{
+			throw invalid_argument("AnalysisConfig: the sign of threshold must match the polarity");
+		}
+		m_threshold = threshold;
+	}
+	else if(key == "polarity")
+	{
+		if(value != "negative" && value != "positive")
+		{
+			throw invalid_argument("AnalysisConfig: polarity must be negative or positive");
+		}
+		const bool negative = value == "negative";
+		m_threshold = negative != m_negative ? -m_threshold : m_threshold;
+		m_negative = negative;
+	}
+	else if(key == "binstotime")
+	{
+		short binsToTime = parseValue<short>(key,value);
+		if(binsToTime <= 0)
+		{
+			throw invalid_argument("AnalysisConfig: binstotime must be positive");
+		}
+		m_bins_to_time = binsToTime;
+	}
+	else if(key == "triggerbin")
+	{
+		m_trigger_bin = parseValue<unsigned short>(key,value);
+	}
+	else if(key == "radius")
+	{
+		m_tube_radius = parseValue<double>(key,value);
+		if(m_tube_radius <= 0)
+		{
+			throw invalid_argument("AnalysisConfig: radius must be positive");
+		}
+	}
+	else if(key == "zerosuppression")
+	{
+		m_zero_suppression = parseValue<bool>(key,value);
+	}
+	else if(key == "baselinebins")
+	{
+		m_baseline_bins = parseValue<unsigned short>(key,value);
+	}
+	else if(key == "relativethreshold")
+	{
+		m_relative_threshold = parseValue<short>(key,value);
+	}
+	else if(key == "filter")
+	{
+		//only to check the chain, the filters are built where they are used
+		SignalFilter::parse(value);
+		m_filter = value;
+	}
+	else if(key == "timing")
+	{
+		if(value == "threshold")
+		{
+			m_timing = THRESHOLD;
+		}
+		else if(value == "interpolated")
+		{
+			m_timing = INTERPOLATED;
+		}
+		else if(value == "cfd")
+		{
+			m_timing = CONSTANT_FRACTION;
+		}
+		else
+		{
+			throw invalid_argument("AnalysisConfig: timing must be threshold, interpolated or cfd");
+		}
+	}
+	else if(key == "cfdfraction")
+	{
+		float fraction = parseValue<float>(key,value);
+		if(!(fraction > 0 && fraction < 1))
+		{
+			throw invalid_argument("AnalysisConfig: cfdfraction must be between 0 and 1");
+		}
+		m_cfd_fraction = fraction;
+	}
+	else if(key == "cfdwindow")
+	{
+		unsigned short window = parseValue<unsigned short>(key,value);
+		if(window == 0)
+		{
+			throw invalid_argument("AnalysisConfig: cfdwindow must be positive");
+		}
+		m_cfd_window = window;
+	}
+	else if(key == "edgefit")
+	{
+		if(value == "fermi")
+		{
+			m_edge_model = EdgeFitter::FERMI;
+		}
+		else if(value == "linear")
+		{
+			m_edge_model = EdgeFitter::LINEAR;
+		}
+		else
+		{
+			throw invalid_argument("AnalysisConfig: edgefit must be fermi or linear");
+		}
+	}
+	else if(key == "subbins")
+	{
+		unsigned short subBins = parseValue<unsigned short>(key,value);
+		if(subBins == 0)
+		{
+			throw invalid_argument("AnalysisConfig: subbins must be positive");
+		}
+		m_sub_bins = subBins;
+	}
+	else if(key == "saturation")
+	{
+		unsigned short saturation = parseValue<unsigned short>(key,value);
+		if(saturation > ADC_MAX_CHANNEL)
+		{
+			throw invalid_argument("AnalysisConfig: saturation must be within the FADC range");
+		}
+		m_saturation = saturation;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Getter for the FADC offset of the zero voltage.
+ *
+ * @brief Getter for the offset
+ *
+ * @return Offset in channels
+ */
+uint16_t AnalysisConfig::getOffset() const
+{
+	return m_offset;
+}
+
+/**
+ * Getter for the event threshold relative to the offset.
+ *
+ * @brief Getter for the threshold
+ *
+ * @return Threshold in channels relative to the offset
+ */
+short AnalysisConfig::getThreshold() const
+{
+	return m_threshold;
+}
+
+/**
+ * Getter for the event threshold as FADC value, thus offset plus threshold, limited to the range of the FADC.
+ *
+ * @brief Getter for the absolute threshold
+ *
+ * @return Threshold in channels
+ */
+uint16_t AnalysisConfig::getAbsoluteThreshold() const
+{
+	const int threshold = (int)m_offset + m_threshold;
+	return threshold < 0 ? 0 : (threshold > UINT16_MAX ? UINT16_MAX : threshold);
+}
+
+/**
+ * Threshold of an event with its own baseline and noise. The threshold is relative to the baseline, it is the configured
+ * threshold or relativethreshold times the noise, whichever is further from the baseline, in the direction of the
+ * polarity. Without noise, or with the offset as baseline, this is getAbsoluteThreshold().
+ *
+ * @brief Threshold for a baseline and noise
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param baseline Baseline of the event in channels
+ * @param noise RMS of the noise of the event in channels
+ * @return Threshold in channels, limited to the range of the FADC
+ */
+uint16_t AnalysisConfig::getAbsoluteThreshold(const float baseline, const float noise) const
+{
+	const float distance = max((float)abs(m_threshold),abs(m_relative_threshold) * noise);
+	const float threshold = baseline + (m_negative ? -distance : distance);
+	return threshold < 0 ? 0 : (threshold > UINT16_MAX ? UINT16_MAX : (uint16_t)lround(threshold));
+}
+
+/**
+ * Getter for the polarity of the signals.
+ *
+ * @brief Getter for the polarity
+ *
+ * @return True if signals undershoot the threshold, false if they exceed it
+ */
+bool AnalysisConfig::isNegative() const
+{
+	return m_negative;
+}
+
+/**
+ * Getter for the time per FADC bin.
+ *
+ * @brief Getter for the time per bin
+ *
+ * @return Time per bin in ns
+ */
+short AnalysisConfig::getBinsToTime() const
+{
+	return m_bins_to_time;
+}
+
+/**
+ * Getter for the FADC bin of the trigger.
+ *
+ * @brief Getter for the trigger bin
+ *
+ * @return Trigger bin
+ */
+unsigned short AnalysisConfig::getTriggerBin() const
+{
+	return m_trigger_bin;
+}
+
+/**
+ * Getter for the tube radius used, if no chamber geometry gives one.
+ *
+ * @brief Getter for the tube radius
+ *
+ * @return Radius in mm
+ */
+double AnalysisConfig::getTubeRadius() const
+{
+	return m_tube_radius;
+}
+
+/**
+ * Getter for the zero suppression. With zero suppression, events without signal are rejected while reading the data.
+ *
+ * @brief Getter for the zero suppression
+ *
+ * @return True if zero suppression is on
+ */
+bool AnalysisConfig::isZeroSuppressed() const
+{
+	return m_zero_suppression;
+}
+
+/**
+ * Getter for the number of samples at the begin of each event, from which its baseline and noise are estimated.
+ *
+ * @brief Getter for the number of baseline samples
+ *
+ * @return Number of samples, 0 if the offset is used as baseline for all events
+ */
+unsigned short AnalysisConfig::getBaselineBins() const
+{
+	return m_baseline_bins;
+}
+
+/**
+ * Getter for the minimum threshold relative to the noise of an event.
+ *
+ * @brief Getter for the relative threshold
+ *
+ * @return Threshold in multiples of the noise RMS
+ */
+short AnalysisConfig::getRelativeThreshold() const
+{
+	return m_relative_threshold;
+}
+
+/**
+ * Getter for the filter chain, that is applied to the raw data before the discrimination.
+ *
+ * @brief Getter for the filter chain
+ *
+ * @return Filter chain as text, see SignalFilter::parse(...), empty for no filter
+ */
+const string& AnalysisConfig::getFilter() const
+{
+	return m_filter;
+}
+
+/**
+ * Getter for the timing method within the bin of the threshold crossing.
+ *
+ * @brief Getter for the timing
+ *
+ * @return One of Timing
+ */
+uint8_t AnalysisConfig::getTiming() const
+{
+	return m_timing;
+}
+
+/**
+ * Getter for the fraction of the pulse amplitude used by the constant fraction discriminator.
+ *
+ * @brief Getter for the constant fraction
+ *
+ * @return Fraction between 0 and 1
+ */
+float AnalysisConfig::getCfdFraction() const
+{
+	return m_cfd_fraction;
+}
+
+/**
+ * Getter for the number of bins after the threshold crossing, in which the constant fraction discriminator searches the
+ * amplitude of the pulse.
+ *
+ * @brief Getter for the constant fraction window
+ *
+ * @return Number of bins
+ */
+unsigned short AnalysisConfig::getCfdWindow() const
+{
+	return m_cfd_window;
+}
+
+/**
+ * Getter for the model of the edges of the drift time spectrum.
+ *
+ * @brief Getter for the edge model
+ *
+ * @return One of EdgeFitter::Model
+ */
+uint8_t AnalysisConfig::getEdgeModel() const
+{
+	return m_edge_model;
+}
+
+/**
+ * Getter for the number of drift time spectrum bins per FADC bin.
+ *
+ * @brief Getter for the sub-bins
+ *
+ * @return Number of bins, at least 1
+ */
+unsigned short AnalysisConfig::getSubBins() const
+{
+	return m_sub_bins;
+}
+
+/**
+ * Getter for the bin width of the drift time spectra and rt-relations, the time per FADC bin divided by the sub-bins.
+ *
+ * @brief Getter for the spectrum bin width
+ *
+ * @return Bin width in ns
+ */
+double AnalysisConfig::getSpectrumBinWidth() const
+{
+	return m_bins_to_time / (double)m_sub_bins;
+}
+
+/**
+ * Getter for the saturation level of the FADC. Signals reaching it are saturated, so their amplitude is unknown. The level
+ * is saturation channels from the end of the FADC range the signals move to, depending on the polarity.
+ *
+ * @brief Getter for the saturation level
+ *
+ * @return Raw FADC value, at or below which negative and at or above which positive signals are saturated
+ */
+uint16_t AnalysisConfig::getSaturationLevel() const
+{
+	return m_negative ? m_saturation : ADC_MAX_CHANNEL - m_saturation;
+}
+
+/**
+ * Getter for the current configuration, that is used by the analysis classes.
+ *
+ * @brief Current configuration
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @return The current configuration, the default configuration if none was set
+ */
+const AnalysisConfig& AnalysisConfig::current()
+{
+	return *currentConfig;
+}
+
+/**
+ * Sets the current configuration, usually once at program start. The configuration is copied. While a Scope is active,
+ * the configuration of the Scope stays current until it ends.
+ *
+ * @brief Set the current configuration
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param config The configuration
+ */
+void AnalysisConfig::setCurrent(const AnalysisConfig& config)
+{
+	configured = config;
+}
+
+/**
+ * Makes the passed configuration the current one. It is not copied and must outlive the Scope.
+ *
+ * @brief ctor
+ *
+ * @param config The configuration to use
+ */
+AnalysisConfig::Scope::Scope(const AnalysisConfig& config)
+{
+	m_previous = currentConfig;
+	currentConfig = &config;
+}
+
+/**
+ * Restores the previously current configuration.
+ *
+ * @brief dtor
+ */
+AnalysisConfig::Scope::~Scope()
+{
+	currentConfig = m_previous;
+}
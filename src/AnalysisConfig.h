@@ -0,0 +1,136 @@
+/*
+ * AnalysisConfig.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef ANALYSISCONFIG_H_
+#define ANALYSISCONFIG_H_
+
+#include <string>
+#include <cstdint>
+#include "globals.h"
+
+/**
+ * Runtime configuration of the analysis. It holds the values that used to be fixed at compile time: FADC offset, event
+ * threshold and its polarity, time per FADC bin, trigger position, tube radius and zero suppression. A default
+ * constructed configuration has the values of globals.h, zero suppression is on if the program was built with ZEROSUP.
+ * The values are read from a file of key = value lines or set one by one, e.g. from command line arguments:
+ * @code
+ * # comments start with #
+ * offset = 2200
+ * polarity = negative
+ * threshold = -300
+ * binstotime = 4
+ * triggerbin = 0
+ * radius = 18.15
+ * zerosuppression = 1
+ * baselinebins = 0
+ * relativethreshold = -5
+ * filter = average:3
+ * timing = threshold
+ * cfdfraction = 0.3
+ * cfdwindow = 10
+ * edgefit = fermi
+ * subbins = 1
+ * saturation = 25
+ * @endcode
+ * With baselinebins > 0, every event gets its own baseline and noise, the mean and RMS of its first baselinebins samples
+ * (see DataProcessor::estimateBaseline(...)). The threshold of the event is then relative to its baseline instead of the
+ * offset, and at least relativethreshold times its noise, see getAbsoluteThreshold(...).
+ * The filter chain (see SignalFilter::parse(...)) is applied to the raw data of every event before its baseline and drift
+ * time are found, by default there is none.
+ * The timing selects how the drift time is found within the bin of the first threshold crossing: threshold uses the bin
+ * itself, interpolated the linear interpolation of the crossing between two samples, cfd a constant fraction
+ * discriminator, see DataProcessor::refineDriftTimeBin(...).
+ * The edges of the drift time spectrum, t0 and tmax, are fitted with Fermi functions or straight lines, see EdgeFitter.
+ * With subbins > 1 the drift time spectra have that many bins per FADC bin, so that the sub-bin resolution of interpolated
+ * or cfd timing is kept. The rt-relations and everything that looks up a time in them use the bin width of the spectra,
+ * see getSpectrumBinWidth().
+ * Signals are saturated within saturation channels of the end of the FADC range they move to, the lower end for negative
+ * and the upper end for positive signals, see getSaturationLevel().
+ * The analysis classes use the current configuration (see current()), which is set once before the data is read, or for
+ * a limited time with an AnalysisConfig::Scope. The hot kernels (see DataProcessor::findDriftTimeBin(...) and
+ * Archive::convertEvents(...)) are templates over zero suppression, polarity and event size. A dispatcher chooses the
+ * instantiation for the current configuration once per data set, so that the configuration costs no branch per sample.
+ * The polarity is used for the drift time, the pulses, the amplitudes and the saturation.
+ *
+ * @brief Runtime configuration of the analysis
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @warning Changing the current configuration while an analysis is running is not thread safe.
+ */
+class AnalysisConfig
+{
+public:
+	AnalysisConfig();
+	~AnalysisConfig();
+
+	static AnalysisConfig load(const std::string& filename);
+	bool set(const std::string& key, const std::string& value);
+
+	uint16_t getOffset() const;
+	short getThreshold() const;
+	uint16_t getAbsoluteThreshold() const;
+	uint16_t getAbsoluteThreshold(const float baseline, const float noise) const;
+	bool isNegative() const;
+	short getBinsToTime() const;
+	unsigned short getTriggerBin() const;
+	double getTubeRadius() const;
+	bool isZeroSuppressed() const;
+	unsigned short getBaselineBins() const;
+	short getRelativeThreshold() const;
+	const std::string& getFilter() const;
+	uint8_t getTiming() const;
+	float getCfdFraction() const;
+	unsigned short getCfdWindow() const;
+	uint8_t getEdgeModel() const;
+	unsigned short getSubBins() const;
+	double getSpectrumBinWidth() const;
+	uint16_t getSaturationLevel() const;
+
+	enum Timing : uint8_t {THRESHOLD, INTERPOLATED, CONSTANT_FRACTION};
+
+	static const AnalysisConfig& current();
+	static void setCurrent(const AnalysisConfig& config);
+
+	/**
+	 * RAII helper that makes a configuration the current one for its lifetime. The previous configuration is restored on
+	 * destruction, so scopes can be nested. Unlike MemoryArena::Scope this is not per thread, OpenMP threads of an
+	 * analysis see the configuration of the thread that started it.
+	 *
+	 * @brief Sets the current configuration
+	 */
+	class Scope
+	{
+	public:
+		Scope(const AnalysisConfig& config);
+		~Scope();
+	private:
+		const AnalysisConfig* m_previous;
+	};
+
+private:
+	uint16_t m_offset; //channels
+	short m_threshold; //channels relative to m_offset
+	bool m_negative; //signals undershoot the threshold
+	short m_bins_to_time; //ns per bin
+	unsigned short m_trigger_bin;
+	double m_tube_radius; //mm
+	bool m_zero_suppression;
+	unsigned short m_baseline_bins; //0 for the fixed offset
+	short m_relative_threshold; //times the noise of the event
+	std::string m_filter; //see SignalFilter::parse(...)
+	uint8_t m_timing; //one of Timing
+	float m_cfd_fraction;
+	unsigned short m_cfd_window; //bins after the threshold crossing, in which the peak is searched
+	uint8_t m_edge_model; //one of EdgeFitter::Model
+	unsigned short m_sub_bins; //drift time spectrum bins per FADC bin
+	unsigned short m_saturation; //channels from the end of the FADC range
+};
+
+#endif /* ANALYSISCONFIG_H_ */
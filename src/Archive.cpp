@@ -5,6 +5,7 @@
  */
 
 #include "Archive.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -20,9 +21,19 @@ using namespace std;
  * @version Alpha 2.0
  *
  * @param filename relative path to the .drift-file containing the raw data
+ * @param hugePages if true, the memory for the Events is backed by transparent huge pages
+ * @param geometryFilename path to the chamber geometry file, if empty a single layer of tubes is assumed
+ *
+ * @throw DataPresenceException if the geometry file cannot be read, the data file is truncated or a channel in the data
+ * file is not in the geometry
  */
-Archive::Archive(string filename)
+Archive::Archive(string filename, const bool hugePages, const string geometryFilename)
 {
+	m_huge_pages = hugePages;
+	if(!geometryFilename.empty())
+	{
+		m_geometry = ChamberGeometry::load(geometryFilename);
+	}
 	convertAllEntries(filename);
 
 	m_directory = parseDir(filename);
@@ -93,6 +104,22 @@ const vector<unique_ptr<Drifttube>>& Archive::getTubes() const
 	return m_tubes;
 }
 
+/**
+ * Getter for the geometry of the chamber, from which the tubes were placed.
+ *
+ * @brief Getter for the chamber geometry
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @return Const reference to the chamber geometry
+ */
+const ChamberGeometry& Archive::getGeometry() const
+{
+	return m_geometry;
+}
+
 //TODO test
 //TODO probably don't want to calculate integrals in here but have them persistent for later use.
 /**
@@ -133,6 +160,7 @@ void Archive::writeToFile(const string& filename)
 	file.write((char*)&nEvents,sizeof(uint32_t));
 	file.write((char*)&eventSize,sizeof(uint32_t));
 
+	const uint16_t offset = AnalysisConfig::current().getOffset();
 	//loop over tubes
 	for(uint32_t i = 0; i < m_tubes.size(); ++i)
 	{
@@ -142,7 +170,7 @@ void Archive::writeToFile(const string& filename)
 			try
 			{
 				Event e = m_tubes[i]->getDataSet()[j];
-				vector<int> integral = DataProcessor::integrate(e,ABSOLUTE_OFFSET_ZERO_VOLTAGE);
+				vector<int> integral = DataProcessor::integrate(e,offset);
 
 				//write eventnumber
 
@@ -150,7 +178,7 @@ void Archive::writeToFile(const string& filename)
 				//write event
 				for(size_t k = 0; k < e.getSize(); ++k)
 				{
-					double datum = (e[k] - ABSOLUTE_OFFSET_ZERO_VOLTAGE) * ADC_CHANNELS_TO_VOLTAGE;
+					double datum = (e[k] - offset) * ADC_CHANNELS_TO_VOLTAGE;
 					file.write((char*)&datum,sizeof(double));
 				}
 				//write integral
@@ -180,7 +208,12 @@ void Archive::writeToFile(const string& filename)
 
 /**
  * Converts all event data stored in a binary file to the data types needed internally
- * The converted data is stored in DataSets for each drifttube.
+ * The converted data is stored in DataSets for each drifttube. The file is read in chunks of events into a buffer and the
+ * drift time is searched directly in that buffer by the kernel chosen for the current AnalysisConfig, see
+ * selectConvertKernel(...). If the configuration has a filter chain, it is applied to a copy of the chunk in a second
+ * reused buffer and the discrimination runs on the copy, while the Events keep the raw samples. With zero suppression, events without drift time are rejected at this point, so that neither
+ * their data nor an Event object is ever allocated. They are stored as nullptr in the DataSet, which keeps the event
+ * numbers and thus the efficiency exact.
  *
  * @brief Convert all data in the file to datatypes used internally
  *
@@ -189,6 +222,8 @@ void Archive::writeToFile(const string& filename)
  * @version Alpha 2.0
  *
  * @param filename relative path of the file containing raw data
+ *
+ * @throw DataPresenceException if the file holds less data than its header claims
  */
 void Archive::convertAllEntries(const string filename)
 {
@@ -204,40 +239,151 @@ void Archive::convertAllEntries(const string filename)
 	cout << "Events: " << nEvents << endl << "tubes: " << nTubes << endl << "Bins per event: " << par.eventSize << endl;
 	file.seekg(par.endOfHeader);
 
+	const AnalysisConfig& config = AnalysisConfig::current();
+	const ConvertKernel convertEvents = selectConvertKernel(config,eventSize);
+	//pole-zero takes the baseline of each event from its baseline bins, else from the samples before the trigger
+	const unsigned short baselineBins = config.getBaselineBins() > 0 ? config.getBaselineBins() : config.getTriggerBin();
+	SignalFilter filter = SignalFilter::parse(config.getFilter(),config.getOffset(),baselineBins);
+	//the raw data is read in chunks of this many events into one reused buffer
+	const uint32_t chunkSize = 4096;
+	vector<uint16_t> buffer((size_t)chunkSize * eventSize);
+	vector<uint16_t> filtered(filter.empty() ? 0 : buffer.size());
+	if(m_geometry.getNumberOfTubes() == 0)
+	{
+		m_geometry = ChamberGeometry::singleLayer(nTubes,config.getTubeRadius());
+	}
+
 	for(uint32_t i = 0; i < nTubes; ++i)
 	{
+		//one arena per tube for all Event objects of the tube
+		shared_ptr<MemoryArena> arena = make_shared<MemoryArena>(1 << 21, m_huge_pages);
+		MemoryArena::Scope scope(arena.get());
 		vector<unique_ptr<Event>> events(nEvents);
-//		cout << "vector with events initialized. Size: " << events.size() << endl;
-		for(size_t j = 0; j < events.size(); ++j)
+		for(uint32_t first = 0; first < nEvents; first += chunkSize)
 		{
-			unique_ptr<vector<uint16_t>> arr(new vector<uint16_t>(eventSize));
-//			cout << "Array for event #" << j << " initialized. Size: " << arr->size() << endl;
-			for(size_t k = 0; k < arr->size(); ++k)
+			uint32_t nChunk = nEvents - first < chunkSize ? nEvents - first : chunkSize;
+			const streamsize chunkBytes = (streamsize)nChunk * eventSize * sizeof(uint16_t);
+			file.read((char*)buffer.data(), chunkBytes);
+			if(!file || file.gcount() != chunkBytes)
 			{
-				uint16_t buffer;
-				file.read((char*)&buffer,sizeof(uint16_t));
-				(*arr)[k] = buffer;
+				//the file is shorter than its header claims
+				throw DataPresenceException();
 			}
-			unique_ptr<Event> e(new Event(j,move(arr)));
-			//zero supression - if no valid drift time was found: reject (a.k.a store nullptr)
-	#ifdef ZEROSUP
-			if(e->getDriftTime() < 0)
+			const uint16_t* discriminated = buffer.data();
+			if(!filter.empty())
 			{
-//				cout << "Rejected event #" << e->getEventNumber() << endl;
-				e.reset();
+				copy(buffer.begin(),buffer.begin() + (size_t)nChunk * eventSize,filtered.begin());
+				filter.apply(filtered.data(),nChunk,eventSize);
+				discriminated = filtered.data();
 			}
-	#endif
-			events[j] = move(e);
+			convertEvents(buffer.data(),discriminated,first,nChunk,eventSize,config,events);
 		}
-		//TODO implement positions init
-		unique_ptr<DataSet> set(new DataSet(events));
+		unique_ptr<DataSet> set(new DataSet(events,arena));
 
-		m_tubes.push_back(unique_ptr<Drifttube>(new Drifttube(1,2,move(set))));
+		int index = m_geometry.findChannel(i);
+		if(index < 0)
+		{
+			throw DataPresenceException();
+		}
+		const TubeGeometry& geometry = m_geometry[index];
+		m_tubes.push_back(unique_ptr<Drifttube>(new Drifttube(geometry.x,geometry.y,move(set),geometry.radius)));
 	}
 	file.close();
 	cout << "file closed" << endl;
 }
 
+/**
+ * Kernel that creates the Events of a chunk of raw data. Zero suppression, polarity and, if NSamples is not 0, the event
+ * size are template parameters, so the loops over the samples contain no branch on the configuration. With baseline
+ * bins, the baseline and noise of each event are estimated right before its drift time is searched, while its samples are
+ * in the cache, and the threshold of the event is relative to them. The drift time is refined to sub-bin resolution
+ * according to the timing of the configuration while the samples around the crossing are still in the cache.
+ * Drift time and threshold are found in the filtered data, the Events hold the raw data. If both differ, the baseline and
+ * noise stored in the Event are those of the raw samples.
+ *
+ * @brief Convert a chunk of events
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @tparam ZeroSuppression If true, events without drift time are rejected (kept as nullptr)
+ * @tparam Negative If true, signals undershoot the threshold
+ * @tparam NSamples Number of samples per event, 0 to use eventSize
+ * @param buffer Raw data of the chunk
+ * @param filtered Filtered data of the chunk, the same pointer as buffer without filter
+ * @param first Event number of the first event in the chunk
+ * @param nEvents Number of events in the chunk
+ * @param eventSize Number of samples per event
+ * @param config Configuration with threshold, baseline bins and timing
+ * @param events Events of the tube, the events of the chunk are set
+ */
+template<bool ZeroSuppression, bool Negative, uint32_t NSamples>
+void Archive::convertEvents(const uint16_t* buffer, const uint16_t* filtered, const uint32_t first, const uint32_t nEvents, const uint32_t eventSize,
+		const AnalysisConfig& config, vector<unique_ptr<Event>>& events)
+{
+	const uint32_t size = NSamples > 0 ? NSamples : eventSize;
+	const uint32_t baselineBins = config.getBaselineBins() < size ? config.getBaselineBins() : size;
+	uint16_t threshold = config.getAbsoluteThreshold();
+	float baseline = config.getOffset();
+	float noise = 0;
+	for(uint32_t j = 0; j < nEvents; ++j)
+	{
+		const uint16_t* samples = &filtered[(size_t)j * size];
+		if(baselineBins > 0)
+		{
+			DataProcessor::estimateBaseline(samples,baselineBins,baseline,noise);
+			threshold = config.getAbsoluteThreshold(baseline,noise);
+		}
+		short driftTimeBin = DataProcessor::findDriftTimeBin<Negative,NSamples>(samples,size,threshold);
+		//zero supression - if no valid drift time was found: reject (a.k.a keep the nullptr) before anything is allocated
+		if(ZeroSuppression && driftTimeBin < 0)
+		{
+			continue;
+		}
+		const float driftTime = DataProcessor::refineDriftTimeBin(samples,size,driftTimeBin,threshold,baseline,config);
+		const uint16_t* raw = &buffer[(size_t)j * size];
+		float rawBaseline = baseline;
+		float rawNoise = noise;
+		if(raw != samples && baselineBins > 0)
+		{
+			DataProcessor::estimateBaseline(raw,baselineBins,rawBaseline,rawNoise);
+		}
+		events[first + j] = unique_ptr<Event>(new Event(first + j,raw,size,driftTime,rawBaseline,rawNoise));
+	}
+}
+
+/**
+ * Chooses the instantiation of convertEvents(...) for a configuration and an event size. Events of FADC_EVENT_SIZE
+ * samples have their own kernels, other sizes use the ones with a runtime event size.
+ *
+ * @brief Dispatcher for the conversion kernels
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param config Configuration with zero suppression and polarity
+ * @param eventSize Number of samples per event
+ * @return The kernel
+ */
+Archive::ConvertKernel Archive::selectConvertKernel(const AnalysisConfig& config, const uint32_t eventSize)
+{
+	//kernels[zero suppression][negative][fixed event size]
+	static const ConvertKernel kernels[2][2][2] =
+	{
+		{
+			{&convertEvents<false,false,0>,&convertEvents<false,false,FADC_EVENT_SIZE>},
+			{&convertEvents<false,true,0>,&convertEvents<false,true,FADC_EVENT_SIZE>}
+		},
+		{
+			{&convertEvents<true,false,0>,&convertEvents<true,false,FADC_EVENT_SIZE>},
+			{&convertEvents<true,true,0>,&convertEvents<true,true,FADC_EVENT_SIZE>}
+		}
+	};
+	return kernels[config.isZeroSuppressed()][config.isNegative()][eventSize == FADC_EVENT_SIZE];
+}
+
 /**
  * Parses the directory from the given String containing the full path to file.
  *
@@ -304,7 +450,7 @@ string Archive::parseFile(string filename)
  */
 FileParams Archive::readHeader(ifstream& file)
 {
-	uint32_t nTubes, eventSize, nEvents;
+	uint32_t nTubes = 0, eventSize = 0, nEvents = 0;
 	if(file.is_open())
 	{
 		file.seekg(0,ios::beg);
@@ -16,6 +16,9 @@
 #include "DataPresenceException.h"
 #include "globals.h"
 #include "Drifttube.h"
+#include "ChamberGeometry.h"
+#include "AnalysisConfig.h"
+#include "SignalFilter.h"
 
 using namespace std;
 
@@ -41,6 +44,10 @@ typedef struct
 
 /**
  * A class that archives processed data and manages writing it to files.
+ * The Events of each tube are placed in one MemoryArena per tube, that is owned by the tube's DataSet.
+ * Position and radius of each tube are taken from a ChamberGeometry by its FADC channel.
+ * Threshold, polarity, offset, baseline estimation, filter chain and zero suppression are taken from the current
+ * AnalysisConfig.
  *
  * @brief Archiving tool
  *
@@ -51,22 +58,34 @@ typedef struct
 class Archive
 {
 public:
-	Archive(const std::string filename);
+	Archive(const std::string filename, const bool hugePages = false, const std::string geometryFilename = "");
 	~Archive();
 
 	const std::string& getFilename() const;
 	const std::string& getDirname() const;
 	const std::vector<std::unique_ptr<Drifttube>>& getTubes() const;
+	const ChamberGeometry& getGeometry() const;
 	void writeToFile(const std::string& filename);
 
+	static const uint32_t FADC_EVENT_SIZE = 800; //samples per event of the FADC, has its own conversion kernels
+
 private:
+	typedef void (*ConvertKernel)(const uint16_t* buffer, const uint16_t* filtered, const uint32_t first, const uint32_t nEvents, const uint32_t eventSize,
+			const AnalysisConfig& config, std::vector<std::unique_ptr<Event>>& events);
+
 	void convertAllEntries(const std::string filename);
+	template<bool ZeroSuppression, bool Negative, uint32_t NSamples>
+	static void convertEvents(const uint16_t* buffer, const uint16_t* filtered, const uint32_t first, const uint32_t nEvents, const uint32_t eventSize,
+			const AnalysisConfig& config, std::vector<std::unique_ptr<Event>>& events);
+	static ConvertKernel selectConvertKernel(const AnalysisConfig& config, const uint32_t eventSize);
 	std::string parseDir(const std::string filename);
 	std::string parseFile(const std::string filename);
 	FileParams readHeader(ifstream& file);
 
 
 	std::vector<unique_ptr<Drifttube>> m_tubes;
+	ChamberGeometry m_geometry;
+	bool m_huge_pages;
 	std::string m_directory;
 	std::string m_file;
 };
@@ -0,0 +1,368 @@
+/*
+ * ChamberGeometry.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "ChamberGeometry.h"
+#include "DataPresenceException.h"
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Default constructor. Creates a chamber without tubes.
+ *
+ * @brief ctor
+ */
+ChamberGeometry::ChamberGeometry()
+{
+	m_min_x = 0;
+	m_min_y = 0;
+	m_cell_size = 1;
+	m_n_cells_x = 0;
+	m_n_cells_y = 0;
+}
+
+/**
+ * Constructor. Stores the passed tubes and builds the spatial index.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param tubes Geometry of all tubes of the chamber
+ */
+ChamberGeometry::ChamberGeometry(const vector<TubeGeometry>& tubes)
+{
+	m_tubes = tubes;
+	buildIndex();
+}
+
+ChamberGeometry::~ChamberGeometry()
+{
+}
+
+/**
+ * Reads a chamber geometry from a text file, see the class documentation for the format.
+ *
+ * @brief Load geometry from file
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param filename Path to the geometry file
+ * @return The chamber geometry
+ *
+ * @throw DataPresenceException if the file cannot be read
+ */
+ChamberGeometry ChamberGeometry::load(const string& filename)
+{
+	ifstream file(filename);
+	if(!file.is_open())
+	{
+		throw DataPresenceException();
+	}
+
+	vector<TubeGeometry> tubes;
+	string line;
+	while(getline(file,line))
+	{
+		if(line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+		stringstream stream(line);
+		TubeGeometry tube;
+		if(!(stream >> tube.channel >> tube.x >> tube.y))
+		{
+			continue;
+		}
+		if(!(stream >> tube.radius))
+		{
+			tube.radius = AnalysisConfig::current().getTubeRadius();
+		}
+		tubes.push_back(tube);
+	}
+
+	return ChamberGeometry(tubes);
+}
+
+/**
+ * Creates the geometry of a single layer of touching tubes along the x-axis, channel i at x = 2 * i * radius. This is
+ * used if no geometry file is given.
+ *
+ * @brief Geometry of a single layer
+ *
+ * @param nTubes Number of tubes
+ * @param radius Radius of the tubes in mm
+ * @return The chamber geometry
+ */
+ChamberGeometry ChamberGeometry::singleLayer(const unsigned int nTubes, const double radius)
+{
+	vector<TubeGeometry> tubes(nTubes);
+	for(unsigned int i = 0; i < nTubes; ++i)
+	{
+		tubes[i].channel = i;
+		tubes[i].x = 2 * i * radius;
+		tubes[i].y = 0;
+		tubes[i].radius = radius;
+	}
+	return ChamberGeometry(tubes);
+}
+
+/**
+ * Getter for the number of tubes in the chamber.
+ *
+ * @brief Getter for the number of tubes
+ *
+ * @return Number of tubes
+ */
+size_t ChamberGeometry::getNumberOfTubes() const
+{
+	return m_tubes.size();
+}
+
+/**
+ * Getter for the geometry of all tubes, in the order of the geometry file.
+ *
+ * @brief Getter for the tubes
+ *
+ * @return Const reference to the tubes
+ */
+const vector<TubeGeometry>& ChamberGeometry::getTubes() const
+{
+	return m_tubes;
+}
+
+/**
+ * Finds the tube, that is read out by the given FADC channel.
+ *
+ * @brief Channel mapping
+ *
+ * @param channel FADC channel
+ * @return Index of the tube or -1 if no tube is connected to the channel
+ */
+int ChamberGeometry::findChannel(const unsigned int channel) const
+{
+	return channel < m_channel_index.size() ? m_channel_index[channel] : -1;
+}
+
+/**
+ * Finds all tubes crossed by a track, see tubesCrossedBy(const Track& track, vector<unsigned int>& indices).
+ *
+ * @brief Tubes crossed by a track
+ *
+ * @param track The track
+ * @return Indices of the crossed tubes in ascending order
+ */
+vector<unsigned int> ChamberGeometry::tubesCrossedBy(const Track& track) const
+{
+	vector<unsigned int> indices;
+	tubesCrossedBy(track,indices);
+	return indices;
+}
+
+/**
+ * Finds all tubes crossed by a track, thus tubes whose wire is closer to the track than the tube radius. The track is
+ * clipped to the grid and the cells along it are visited with a digital differential analyser, only the tubes stored in
+ * these cells are tested.
+ *
+ * @brief Tubes crossed by a track
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param track The track
+ * @param indices Vector that is cleared and filled with the indices of the crossed tubes in ascending order. Passing
+ * the same vector for many tracks avoids allocations.
+ */
+void ChamberGeometry::tubesCrossedBy(const Track& track, vector<unsigned int>& indices) const
+{
+	indices.clear();
+	if(m_tubes.empty())
+	{
+		return;
+	}
+
+	const double cosTheta = cos(track.getTheta());
+	const double sinTheta = sin(track.getTheta());
+	const double origin[2] = {track.getDistance() * cosTheta, track.getDistance() * sinTheta};
+	const double direction[2] = {-sinTheta, cosTheta};
+	const double lower[2] = {m_min_x, m_min_y};
+	const double upper[2] = {m_min_x + m_n_cells_x * m_cell_size, m_min_y + m_n_cells_y * m_cell_size};
+
+	//clip the line to the grid
+	double tMin = -numeric_limits<double>::infinity();
+	double tMax = numeric_limits<double>::infinity();
+	for(unsigned int axis = 0; axis < 2; ++axis)
+	{
+		if(fabs(direction[axis]) < 1e-12)
+		{
+			if(origin[axis] < lower[axis] || origin[axis] > upper[axis])
+			{
+				return;
+			}
+			continue;
+		}
+		double t1 = (lower[axis] - origin[axis]) / direction[axis];
+		double t2 = (upper[axis] - origin[axis]) / direction[axis];
+		tMin = max(tMin,min(t1,t2));
+		tMax = min(tMax,max(t1,t2));
+	}
+	if(tMin > tMax)
+	{
+		return;
+	}
+
+	//walk along the cells
+	const unsigned int nCells[2] = {m_n_cells_x, m_n_cells_y};
+	int cell[2];
+	int step[2];
+	double tNext[2];
+	double tDelta[2];
+	for(unsigned int axis = 0; axis < 2; ++axis)
+	{
+		double entry = origin[axis] + tMin * direction[axis];
+		int c = (int)floor((entry - lower[axis]) / m_cell_size);
+		cell[axis] = c < 0 ? 0 : (c >= (int)nCells[axis] ? nCells[axis] - 1 : c);
+		if(fabs(direction[axis]) < 1e-12)
+		{
+			step[axis] = 0;
+			tNext[axis] = numeric_limits<double>::infinity();
+			tDelta[axis] = numeric_limits<double>::infinity();
+			continue;
+		}
+		step[axis] = direction[axis] > 0 ? 1 : -1;
+		double boundary = lower[axis] + (cell[axis] + (step[axis] > 0 ? 1 : 0)) * m_cell_size;
+		tNext[axis] = (boundary - origin[axis]) / direction[axis];
+		tDelta[axis] = m_cell_size / fabs(direction[axis]);
+	}
+
+	while(true)
+	{
+		unsigned int index = cell[1] * m_n_cells_x + cell[0];
+		for(unsigned int i = m_cell_start[index]; i < m_cell_start[index + 1]; ++i)
+		{
+			const TubeGeometry& tube = m_tubes[m_cell_tubes[i]];
+			if(fabs(track.distanceTo(tube.x,tube.y)) < tube.radius)
+			{
+				indices.push_back(m_cell_tubes[i]);
+			}
+		}
+		unsigned int axis = tNext[0] < tNext[1] ? 0 : 1;
+		if(tNext[axis] > tMax)
+		{
+			break;
+		}
+		cell[axis] += step[axis];
+		if(cell[axis] < 0 || cell[axis] >= (int)nCells[axis])
+		{
+			break;
+		}
+		tNext[axis] += tDelta[axis];
+	}
+
+	//a tube is stored in every cell it overlaps
+	sort(indices.begin(),indices.end());
+	indices.erase(unique(indices.begin(),indices.end()),indices.end());
+}
+
+/**
+ * Access operator for the geometry of a tube.
+ *
+ * @param index Index of the tube
+ * @return Const reference to the tube geometry
+ */
+const TubeGeometry& ChamberGeometry::operator[](const unsigned int index) const
+{
+	return m_tubes[index];
+}
+
+/**
+ * Builds the channel mapping and the uniform grid. The cells are as large as the largest tube diameter, so that every
+ * tube overlaps at most four cells.
+ *
+ * @brief Build the spatial index
+ */
+void ChamberGeometry::buildIndex()
+{
+	m_channel_index.clear();
+	m_cell_start.clear();
+	m_cell_tubes.clear();
+	m_min_x = m_min_y = 0;
+	m_cell_size = 1;
+	m_n_cells_x = m_n_cells_y = 0;
+	if(m_tubes.empty())
+	{
+		return;
+	}
+
+	double maxX, maxY, maxRadius = 0;
+	m_min_x = maxX = m_tubes[0].x;
+	m_min_y = maxY = m_tubes[0].y;
+	for(unsigned int i = 0; i < m_tubes.size(); ++i)
+	{
+		const TubeGeometry& tube = m_tubes[i];
+		m_min_x = min(m_min_x,tube.x - tube.radius);
+		m_min_y = min(m_min_y,tube.y - tube.radius);
+		maxX = max(maxX,tube.x + tube.radius);
+		maxY = max(maxY,tube.y + tube.radius);
+		maxRadius = max(maxRadius,tube.radius);
+		if(tube.channel >= m_channel_index.size())
+		{
+			m_channel_index.resize(tube.channel + 1,-1);
+		}
+		m_channel_index[tube.channel] = i;
+	}
+	m_cell_size = maxRadius > 0 ? 2 * maxRadius : 1;
+	m_n_cells_x = (unsigned int)floor((maxX - m_min_x) / m_cell_size) + 1;
+	m_n_cells_y = (unsigned int)floor((maxY - m_min_y) / m_cell_size) + 1;
+
+	//count the tubes per cell, then fill the cells
+	m_cell_start.assign(m_n_cells_x * m_n_cells_y + 1,0);
+	for(unsigned int pass = 0; pass < 2; ++pass)
+	{
+		vector<unsigned int> fillPosition(m_cell_start.begin(),m_cell_start.end() - 1);
+		for(unsigned int i = 0; i < m_tubes.size(); ++i)
+		{
+			const TubeGeometry& tube = m_tubes[i];
+			unsigned int firstX = (unsigned int)floor((tube.x - tube.radius - m_min_x) / m_cell_size);
+			unsigned int lastX = min((unsigned int)floor((tube.x + tube.radius - m_min_x) / m_cell_size),m_n_cells_x - 1);
+			unsigned int firstY = (unsigned int)floor((tube.y - tube.radius - m_min_y) / m_cell_size);
+			unsigned int lastY = min((unsigned int)floor((tube.y + tube.radius - m_min_y) / m_cell_size),m_n_cells_y - 1);
+			for(unsigned int y = firstY; y <= lastY; ++y)
+			{
+				for(unsigned int x = firstX; x <= lastX; ++x)
+				{
+					unsigned int cell = y * m_n_cells_x + x;
+					if(pass == 0)
+					{
+						++m_cell_start[cell + 1];
+					}
+					else
+					{
+						m_cell_tubes[fillPosition[cell]++] = i;
+					}
+				}
+			}
+		}
+		if(pass == 0)
+		{
+			for(unsigned int cell = 0; cell < m_n_cells_x * m_n_cells_y; ++cell)
+			{
+				m_cell_start[cell + 1] += m_cell_start[cell];
+			}
+			m_cell_tubes.resize(m_cell_start.back());
+		}
+	}
+}
@@ -0,0 +1,85 @@
+/*
+ * ChamberGeometry.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef CHAMBERGEOMETRY_H_
+#define CHAMBERGEOMETRY_H_
+
+#include <string>
+#include <vector>
+#include "Track.h"
+#include "globals.h"
+#include "AnalysisConfig.h"
+
+/**
+ * Geometry of one drift tube of the chamber.
+ *
+ * @brief Tube geometry
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	unsigned int channel; //FADC channel, thus the index of the tube in the .drift file
+	double x; //wire position [mm]
+	double y; //wire position [mm]
+	double radius; //[mm]
+} TubeGeometry;
+
+/**
+ * Description of the drift tube chamber: wire position, radius and FADC channel of every tube. The geometry is read
+ * from a plain text file with one tube per line:
+ * @code
+ * # channel x[mm] y[mm] radius[mm]
+ * 0 0.0  0.0  18.15
+ * 1 21.0 36.4
+ * @endcode
+ * The radius is optional and defaults to the radius of the current AnalysisConfig, lines starting with # are ignored.
+ * The tubes are put into a uniform grid with cells of the size of the largest tube diameter, each tube is stored in all
+ * cells it overlaps. Finding the tubes crossed by a line only visits the cells along the line, so that its cost grows
+ * with the number of tubes crossed instead of the number of tubes in the chamber.
+ *
+ * @brief Chamber geometry with spatial index
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+class ChamberGeometry
+{
+public:
+	ChamberGeometry();
+	ChamberGeometry(const std::vector<TubeGeometry>& tubes);
+	~ChamberGeometry();
+
+	static ChamberGeometry load(const std::string& filename);
+	static ChamberGeometry singleLayer(const unsigned int nTubes, const double radius = AnalysisConfig::current().getTubeRadius());
+
+	size_t getNumberOfTubes() const;
+	const std::vector<TubeGeometry>& getTubes() const;
+	int findChannel(const unsigned int channel) const;
+	std::vector<unsigned int> tubesCrossedBy(const Track& track) const;
+	void tubesCrossedBy(const Track& track, std::vector<unsigned int>& indices) const;
+
+	const TubeGeometry& operator[](const unsigned int index) const;
+
+private:
+	void buildIndex();
+
+	std::vector<TubeGeometry> m_tubes;
+	std::vector<int> m_channel_index; //tube index for each channel, -1 if the channel is not connected
+	double m_min_x; //mm
+	double m_min_y; //mm
+	double m_cell_size; //mm
+	unsigned int m_n_cells_x;
+	unsigned int m_n_cells_y;
+	std::vector<unsigned int> m_cell_start; //tubes of cell i are m_cell_tubes[m_cell_start[i]] to m_cell_tubes[m_cell_start[i + 1] - 1]
+	std::vector<unsigned int> m_cell_tubes;
+};
+
+#endif /* CHAMBERGEOMETRY_H_ */
@@ -0,0 +1,309 @@
+/*
+ * CoincidenceAnalysis.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "CoincidenceAnalysis.h"
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Constructor. Creates empty histograms for all pairs of tubes. The drift time differences are histogrammed in
+ * [-maxDeltaT,maxDeltaT), differences outside are not counted in the histogram but still in the multiplicities.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param nTubes Number of tubes
+ * @param maxDeltaT Range of the drift time difference histograms in ns
+ * @param binWidth Bin width of the drift time difference histograms in ns
+ */
+CoincidenceAnalysis::CoincidenceAnalysis(const size_t nTubes, const double maxDeltaT, const double binWidth)
+{
+	m_n_tubes = nTubes;
+	m_max_delta_t = maxDeltaT;
+	m_bin_width = binWidth;
+	m_n_bins = (unsigned int)ceil(2 * maxDeltaT / binWidth);
+	m_n_triggers = 0;
+	m_delta_t.resize(getNumberOfPairs() * m_n_bins,0);
+	m_pair_multiplicity.resize(getNumberOfPairs() * (nTubes + 1),0);
+	m_hits.resize(nTubes,0);
+	m_multiplicity.resize(nTubes + 1,0);
+}
+
+CoincidenceAnalysis::~CoincidenceAnalysis()
+{
+}
+
+/**
+ * Fills the histograms with all triggers of a TriggerEventCollection. The triggers are processed in parallel, the hits
+ * of a trigger are first gathered into a short list, so that the loop over the pairs only visits tubes with hit.
+ *
+ * @brief Fill the histograms
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param hits Trigger aligned hits, must contain the number of tubes passed to the constructor
+ *
+ * @throw invalid_argument if the number of tubes differs
+ */
+void CoincidenceAnalysis::fill(const TriggerEventCollection& hits)
+{
+	if(hits.getNumberOfTubes() != m_n_tubes)
+	{
+		throw invalid_argument("CoincidenceAnalysis::fill: different number of tubes");
+	}
+	const long nTriggers = hits.getNumberOfTriggers();
+	const double inverseWidth = 1 / m_bin_width;
+
+	#pragma omp parallel
+	{
+		CoincidenceAnalysis threadAnalysis(m_n_tubes,m_max_delta_t,m_bin_width);
+		vector<unsigned int> hitTubes(m_n_tubes);
+		vector<float> hitTimes(m_n_tubes);
+
+		#pragma omp for schedule(static,1024)
+		for(long trigger = 0; trigger < nTriggers; ++trigger)
+		{
+			const Hit* triggerHits = hits.getHits(trigger);
+			size_t n = 0;
+			for(size_t tube = 0; tube < m_n_tubes; ++tube)
+			{
+				if(TriggerEventCollection::isHit(triggerHits[tube]))
+				{
+					hitTubes[n] = tube;
+					hitTimes[n] = triggerHits[tube].driftTime;
+					++threadAnalysis.m_hits[tube];
+					++n;
+				}
+			}
+			++threadAnalysis.m_multiplicity[n];
+			for(size_t i = 0; i < n; ++i)
+			{
+				for(size_t j = i + 1; j < n; ++j)
+				{
+					size_t pair = getPairIndex(hitTubes[i],hitTubes[j]);
+					++threadAnalysis.m_pair_multiplicity[pair * (m_n_tubes + 1) + n];
+					double bin = floor((hitTimes[j] - hitTimes[i] + m_max_delta_t) * inverseWidth);
+					if(bin >= 0 && bin < m_n_bins)
+					{
+						++threadAnalysis.m_delta_t[pair * m_n_bins + (unsigned int)bin];
+					}
+				}
+			}
+		}
+
+		#pragma omp critical
+		{
+			merge(threadAnalysis);
+		}
+	}
+	m_n_triggers += nTriggers;
+}
+
+/**
+ * Adds the histograms of another analysis, e.g. of another file of the same run.
+ *
+ * @brief Merge two analyses
+ *
+ * @param other Analysis with the same number of tubes and the same binning
+ *
+ * @throw invalid_argument if the number of tubes or the binning differ
+ */
+void CoincidenceAnalysis::merge(const CoincidenceAnalysis& other)
+{
+	if(other.m_n_tubes != m_n_tubes || other.m_n_bins != m_n_bins || other.m_max_delta_t != m_max_delta_t)
+	{
+		throw invalid_argument("CoincidenceAnalysis::merge: different binning");
+	}
+	for(size_t i = 0; i < m_delta_t.size(); ++i)
+	{
+		m_delta_t[i] += other.m_delta_t[i];
+	}
+	for(size_t i = 0; i < m_pair_multiplicity.size(); ++i)
+	{
+		m_pair_multiplicity[i] += other.m_pair_multiplicity[i];
+	}
+	for(size_t i = 0; i < m_n_tubes; ++i)
+	{
+		m_hits[i] += other.m_hits[i];
+	}
+	for(size_t i = 0; i < m_multiplicity.size(); ++i)
+	{
+		m_multiplicity[i] += other.m_multiplicity[i];
+	}
+	m_n_triggers += other.m_n_triggers;
+}
+
+/**
+ * Getter for the number of tubes.
+ *
+ * @brief Getter for the number of tubes
+ *
+ * @return Number of tubes
+ */
+size_t CoincidenceAnalysis::getNumberOfTubes() const
+{
+	return m_n_tubes;
+}
+
+/**
+ * Getter for the number of pairs of different tubes, n * (n - 1) / 2.
+ *
+ * @brief Getter for the number of pairs
+ *
+ * @return Number of pairs
+ */
+size_t CoincidenceAnalysis::getNumberOfPairs() const
+{
+	return m_n_tubes * (m_n_tubes - 1) / 2;
+}
+
+/**
+ * Computes the index of a pair of tubes. The pairs are ordered (0,1), (0,2), ..., (0,n-1), (1,2), ...
+ *
+ * @brief Index of a pair
+ *
+ * @param first Index of one tube
+ * @param second Index of the other tube, must differ from first
+ * @return Index of the pair, the same for both orders of the tubes
+ */
+size_t CoincidenceAnalysis::getPairIndex(const unsigned int first, const unsigned int second) const
+{
+	size_t lower = first < second ? first : second;
+	size_t upper = first < second ? second : first;
+	return lower * m_n_tubes - lower * (lower + 1) / 2 + upper - lower - 1;
+}
+
+/**
+ * Getter for the number of triggers filled so far.
+ *
+ * @brief Getter for the number of triggers
+ *
+ * @return Number of triggers
+ */
+unsigned long CoincidenceAnalysis::getNumberOfTriggers() const
+{
+	return m_n_triggers;
+}
+
+/**
+ * Getter for the number of bins of the drift time difference histograms.
+ *
+ * @brief Getter for the number of bins
+ *
+ * @return Number of bins
+ */
+unsigned int CoincidenceAnalysis::getNumberOfBins() const
+{
+	return m_n_bins;
+}
+
+/**
+ * Getter for the bin width of the drift time difference histograms.
+ *
+ * @brief Getter for the bin width
+ *
+ * @return Bin width in ns
+ */
+double CoincidenceAnalysis::getBinWidth() const
+{
+	return m_bin_width;
+}
+
+/**
+ * Computes the drift time difference at the center of a bin.
+ *
+ * @brief Bin center
+ *
+ * @param bin Bin number
+ * @return Drift time difference in ns
+ */
+double CoincidenceAnalysis::getBinCenter(const unsigned int bin) const
+{
+	return -m_max_delta_t + (bin + 0.5) * m_bin_width;
+}
+
+/**
+ * Getter for the drift time difference histogram of a pair of tubes. The histogram holds the drift time of the tube
+ * with the higher index minus the drift time of the tube with the lower index.
+ *
+ * @brief Drift time difference histogram
+ *
+ * @param first Index of one tube
+ * @param second Index of the other tube
+ * @return Pointer to the first of getNumberOfBins() bins
+ */
+const unsigned int* CoincidenceAnalysis::getDeltaTHistogram(const unsigned int first, const unsigned int second) const
+{
+	return m_delta_t.data() + getPairIndex(first,second) * m_n_bins;
+}
+
+/**
+ * Getter for the multiplicity distribution of a pair of tubes, thus the number of tubes hit in the triggers, in which
+ * both tubes of the pair were hit.
+ *
+ * @brief Multiplicity distribution of a pair
+ *
+ * @param first Index of one tube
+ * @param second Index of the other tube
+ * @return Pointer to getNumberOfTubes() + 1 entries, indexed by the multiplicity
+ */
+const unsigned int* CoincidenceAnalysis::getMultiplicity(const unsigned int first, const unsigned int second) const
+{
+	return m_pair_multiplicity.data() + getPairIndex(first,second) * (m_n_tubes + 1);
+}
+
+/**
+ * Getter for the number of triggers, in which both tubes of a pair were hit.
+ *
+ * @brief Getter for the coincidences of a pair
+ *
+ * @param first Index of one tube
+ * @param second Index of the other tube
+ * @return Number of coincidences
+ */
+unsigned long CoincidenceAnalysis::getCoincidences(const unsigned int first, const unsigned int second) const
+{
+	const unsigned int* multiplicity = getMultiplicity(first,second);
+	unsigned long sum = 0;
+	for(size_t i = 0; i <= m_n_tubes; ++i)
+	{
+		sum += multiplicity[i];
+	}
+	return sum;
+}
+
+/**
+ * Getter for the number of triggers, in which a tube was hit.
+ *
+ * @brief Getter for the hits of a tube
+ *
+ * @param tube Index of the tube
+ * @return Number of hits
+ */
+unsigned long CoincidenceAnalysis::getHits(const unsigned int tube) const
+{
+	return m_hits[tube];
+}
+
+/**
+ * Getter for the multiplicity distribution of all triggers.
+ *
+ * @brief Multiplicity distribution
+ *
+ * @return Number of triggers indexed by the number of tubes hit
+ */
+const vector<unsigned long>& CoincidenceAnalysis::getMultiplicity() const
+{
+	return m_multiplicity;
+}
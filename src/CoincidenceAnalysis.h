@@ -0,0 +1,64 @@
+/*
+ * CoincidenceAnalysis.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef COINCIDENCEANALYSIS_H_
+#define COINCIDENCEANALYSIS_H_
+
+#include <vector>
+#include "TriggerEventCollection.h"
+#include "globals.h"
+#include "AnalysisConfig.h"
+
+/**
+ * Time correlation of the hits of all pairs of tubes. For every trigger, every pair of tubes (i,j) with i < j that both
+ * have a hit fills the drift time difference t_j - t_i into the histogram of the pair and the number of tubes hit in
+ * the trigger into the multiplicity distribution of the pair. Crosstalk shows up as a narrow peak at small time
+ * differences with low multiplicity, tracks as broad distributions with the multiplicity of the chamber.
+ * All pairs are filled in a single pass over the trigger-major hits of a TriggerEventCollection, each thread fills its
+ * own histograms, which are merged afterwards.
+ *
+ * @brief All pairs drift time differences and multiplicities
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+class CoincidenceAnalysis
+{
+public:
+	CoincidenceAnalysis(const size_t nTubes, const double maxDeltaT = 800, const double binWidth = AnalysisConfig::current().getBinsToTime());
+	~CoincidenceAnalysis();
+
+	void fill(const TriggerEventCollection& hits);
+	void merge(const CoincidenceAnalysis& other);
+
+	size_t getNumberOfTubes() const;
+	size_t getNumberOfPairs() const;
+	size_t getPairIndex(const unsigned int first, const unsigned int second) const;
+	unsigned long getNumberOfTriggers() const;
+	unsigned int getNumberOfBins() const;
+	double getBinWidth() const;
+	double getBinCenter(const unsigned int bin) const;
+	const unsigned int* getDeltaTHistogram(const unsigned int first, const unsigned int second) const;
+	const unsigned int* getMultiplicity(const unsigned int first, const unsigned int second) const;
+	unsigned long getCoincidences(const unsigned int first, const unsigned int second) const;
+	unsigned long getHits(const unsigned int tube) const;
+	const std::vector<unsigned long>& getMultiplicity() const;
+
+private:
+	size_t m_n_tubes;
+	double m_max_delta_t; //ns
+	double m_bin_width; //ns
+	unsigned int m_n_bins;
+	unsigned long m_n_triggers;
+	std::vector<unsigned int> m_delta_t; //m_delta_t[pair * m_n_bins + bin]
+	std::vector<unsigned int> m_pair_multiplicity; //m_pair_multiplicity[pair * (m_n_tubes + 1) + multiplicity]
+	std::vector<unsigned long> m_hits; //triggers with hit per tube
+	std::vector<unsigned long> m_multiplicity; //triggers per number of tubes hit
+};
+
+#endif /* COINCIDENCEANALYSIS_H_ */
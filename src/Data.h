@@ -29,6 +29,9 @@
  * { ... }
  * @endcode
  *
+ * The values are stored with the given allocator. Events use an ArenaAllocator, so that their samples are placed in the
+ * same MemoryArena as the Event objects.
+ *
  * @brief Data class, wrapper for arrays
  *
  * @author Stefan Bieschke
@@ -37,13 +40,13 @@
  *
  * @warning Abstract class, cannot be instantiated.
  */
-template<typename T = uint16_t>
+template<typename T = uint16_t, typename Allocator = std::allocator<T>>
 class Data
 {
 public:
 	virtual ~Data() = 0; //not meant for instantiation
 
-	const std::vector<T>& getData() const;
+	const std::vector<T,Allocator>& getData() const;
 	T& operator[](const unsigned short bin);
 	const T& operator[](const unsigned short bin) const;
 	std::unique_ptr<std::vector<double>> normalized() const;
@@ -51,19 +54,20 @@ public:
 
 
 protected:
-	Data<T>& operator=(const Data<T>& rhs);
-	Data(std::unique_ptr<std::vector<T>> data);
-	Data(const Data<T>& data);
+	Data<T,Allocator>& operator=(const Data<T,Allocator>& rhs);
+	Data(std::unique_ptr<std::vector<T,Allocator>> data);
+	Data(const T* begin, const T* end, const Allocator& allocator);
+	Data(const Data<T,Allocator>& data, const Allocator& allocator = Allocator());
 
-	std::unique_ptr<std::vector<T>> m_data;
+	std::vector<T,Allocator> m_data;
 };
 
 
 using namespace std;
 
 /**
- * Constructor of the Data class. This is protected, Data objects are not meant to be instantiated. This transfers ownership of the passed
- * array to the member m_data.
+ * Constructor of the Data class. This is protected, Data objects are not meant to be instantiated. The content of the passed
+ * vector is moved to the member m_data.
  *
  * @brief Constructor (protected)
  *
@@ -75,10 +79,29 @@ using namespace std;
  *
  * @warning Protected: should only be called by inheriting class' constructors
  */
-template<typename T>
-Data<T>::Data(unique_ptr<vector<T>> data)
+template<typename T, typename Allocator>
+Data<T,Allocator>::Data(unique_ptr<vector<T,Allocator>> data) : m_data(move(*data))
+{
+}
+
+/**
+ * Constructor of the Data class that copies the values from a buffer into storage of the passed allocator.
+ *
+ * @brief Constructor from a buffer (protected)
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param begin Pointer to the first value
+ * @param end Pointer behind the last value
+ * @param allocator Allocator for the storage
+ *
+ * @warning Protected: should only be called by inheriting class' constructors
+ */
+template<typename T, typename Allocator>
+Data<T,Allocator>::Data(const T* begin, const T* end, const Allocator& allocator) : m_data(begin,end,allocator)
 {
-	m_data = move(data);
 }
 
 
@@ -90,30 +113,26 @@ Data<T>::Data(unique_ptr<vector<T>> data)
  * @version Alpha 2.0
  *
  * @param data constant reference to the object that should be copied
+ * @param allocator Allocator for the storage of the copy
  *
  * @warning Protected: should only be called by inheriting class' constructors
  */
-template<typename T>
-Data<T>::Data(const Data<T>& data)
+template<typename T, typename Allocator>
+Data<T,Allocator>::Data(const Data<T,Allocator>& data, const Allocator& allocator) : m_data(data.m_data.size(),T(),allocator)
 {
-	unique_ptr<vector<T>> temp(new vector<T>);
-	temp->resize(data.m_data->size());
-
 	//deep copy
 	#pragma omp parallel for
-	for(int i = 0; i < data.m_data->size(); ++i)
+	for(int i = 0; i < data.m_data.size(); ++i)
 	{
-		(*temp)[i] = (*data.m_data)[i];
+		m_data[i] = data.m_data[i];
 	}
-
-	m_data = move(temp);
 }
 
 /**
  * Virtual destructor. Does nothing, object tears down automatically when out of scope.
  */
-template<typename T>
-Data<T>::~Data()
+template<typename T, typename Allocator>
+Data<T,Allocator>::~Data()
 {
 }
 
@@ -128,10 +147,10 @@ Data<T>::~Data()
  *
  * @return Reference to the array that is contained
  */
-template<typename T>
-const vector<T>& Data<T>::getData() const
+template<typename T, typename Allocator>
+const vector<T,Allocator>& Data<T,Allocator>::getData() const
 {
-	return *m_data;
+	return m_data;
 }
 
 /**
@@ -147,10 +166,10 @@ const vector<T>& Data<T>::getData() const
  * @param bin Number of the bin as a @c size_t, which is basically an unsigned integer
  * @return Content of the requested bin. This is a reference to the content so that it can be used as lvalue. E.g. @c data[i] = 5;
  */
-template<typename T>
-const T& Data<T>::operator[](const unsigned short bin) const
+template<typename T, typename Allocator>
+const T& Data<T,Allocator>::operator[](const unsigned short bin) const
 {
-	return (*m_data)[bin];
+	return m_data[bin];
 }
 
 /**
@@ -166,14 +185,14 @@ const T& Data<T>::operator[](const unsigned short bin) const
  * @param rhs const reference to the @c Data<T> object on the right hand side of the assignment
  * @return Reference to the lhs object - basically the address that the lhs is assigned to
  */
-template<typename T>
-Data<T>& Data<T>::operator=(const Data<T>& rhs)
+template<typename T, typename Allocator>
+Data<T,Allocator>& Data<T,Allocator>::operator=(const Data<T,Allocator>& rhs)
 {
 	//TODO check for same sizes
 	//TODO if not of the same size: Fix LHS size
-	for(size_t i = 0; i < m_data->size(); ++i)
+	for(size_t i = 0; i < m_data.size(); ++i)
 	{
-		(*m_data)[i] = (*rhs.m_data)[i];
+		m_data[i] = rhs.m_data[i];
 	}
 	return *this;
 }
@@ -190,20 +209,20 @@ Data<T>& Data<T>::operator=(const Data<T>& rhs)
  *
  * @return @c std::unique_ptr<std::array<double,800>> containing the normalized data
  */
-template<typename T>
-unique_ptr<vector<double>> Data<T>::normalized() const
+template<typename T, typename Allocator>
+unique_ptr<vector<double>> Data<T,Allocator>::normalized() const
 {
-	unique_ptr<vector<double>> result(new vector<double>(m_data->size()));
+	unique_ptr<vector<double>> result(new vector<double>(m_data.size()));
 	//TODO include DataProcessor and let it perform the integration
 
 	double integral = 0;
 //	#pragma omp parallel for reduction(+,integral)
-	for(size_t i = 0; i < m_data->size(); ++i)
+	for(size_t i = 0; i < m_data.size(); ++i)
 	{
-		integral += (*m_data)[i];
+		integral += m_data[i];
 	}
 
-	for(size_t i = 0; i < m_data->size(); ++i)
+	for(size_t i = 0; i < m_data.size(); ++i)
 	{
 		(*result)[i] = (*this)[i] / integral;
 	}
@@ -225,10 +244,10 @@ unique_ptr<vector<double>> Data<T>::normalized() const
  *
  * @return The size of the data array stored in this Data object as @c size_t
  */
-template<typename T>
-const size_t Data<T>::getSize() const
+template<typename T, typename Allocator>
+const size_t Data<T,Allocator>::getSize() const
 {
-	return m_data->size();
+	return m_data.size();
 }
 
 /**
@@ -244,10 +263,10 @@ const size_t Data<T>::getSize() const
  * @param bin Number of the bin as a @c size_t, which is basically an unsigned integer
  * @return Content of the requested bin. This is a reference to the content so that it can be used as lvalue. E.g. @c data[i] = 5;
  */
-template<typename T>
-T& Data<T>::operator[](const unsigned short bin)
+template<typename T, typename Allocator>
+T& Data<T,Allocator>::operator[](const unsigned short bin)
 {
-	return (*m_data)[bin];
+	return m_data[bin];
 }
 
 #endif /* DATA_H_ */
@@ -1,4 +1,6 @@
 #include "DataProcessor.h"
+#include "TriggerEventCollection.h"
+#include "LegendreTrackFinder.h"
 
 using namespace std;
 
@@ -72,7 +74,7 @@ int DataProcessor::computeIntegral(const Event& data)
  */
 const vector<int> DataProcessor::integrate(const Event& data)
 {
-	vector<uint16_t> dataArray = data.getData();
+	vector<uint16_t> dataArray(data.getData().begin(),data.getData().end());
 	//TODO check if returning a copy isn't too slow
 	return integrate(dataArray);
 }
@@ -96,7 +98,7 @@ const vector<int> DataProcessor::integrate(const Event& data)
  */
 const vector<int> DataProcessor::integrate(const Event& data, const uint16_t error)
 {
-	vector<uint16_t> dataArray = data.getData();
+	vector<uint16_t> dataArray(data.getData().begin(),data.getData().end());
 	return integrate(dataArray,error);
 }
 
@@ -161,7 +163,7 @@ const vector<int> DataProcessor::integrate(const vector<uint16_t>& data, const u
 
 /**
  * Find the position of the minimum of the given data. Will only find the absolute
- * minimum. Can not yet find more than one negative peak.
+ * minimum, see PeakFinder for all peaks.
  *
  * @author Stefan
  * @date June 8, 2017
@@ -184,6 +186,8 @@ unsigned short DataProcessor::findMinimumBin(const Event& data)
  * Calculates the spectrum of drifttimes for the data given in a DataSet object containing raw data.
  * The result is a histogram containing the spectrum. Note, that in order to find the correct drift time spectrum, the
  * parameters defined in globals.h must be defined for the used experiment.
+ * The DataSet fills its drift time histogram whenever an Event is added, so this only copies the histogram and runs in
+ * O(bins) instead of looping over all Events.
  *
  * @author Stefan
  * @date November 21, 2016
@@ -195,69 +199,51 @@ unsigned short DataProcessor::findMinimumBin(const Event& data)
  */
 const DriftTimeSpectrum DataProcessor::calculateDriftTimeSpectrum(const DataSet& data)
 {
-	if(data.getSize() == 0)
-	{
-		unique_ptr<vector<uint32_t>> empty(new vector<uint32_t>(0));
-		return DriftTimeSpectrum(move(empty), 0, 0);
-	}
-	//can not run in parallel - at least not this way
-
-	unsigned int rejected = 0;
+	unique_ptr<vector<uint32_t>> result(new vector<uint32_t>(data.getDriftTimeHistogram()));
+	return DriftTimeSpectrum(move(result), data.getSize(), data.getRejected());
+}
 
-	#ifdef ZEROSUP
-	unique_ptr<vector<uint32_t>> result;
-	for (size_t i = 0; i < data.getSize(); ++i)
+/**
+ * Calculates a drift time spectrum with subBins bins per FADC bin from the drift times of the events, e.g. for sub-bin
+ * timing (see AnalysisConfig::getTiming()). Events are rejected and binned as in the drift time histogram of the
+ * DataSet, with subBins = 1 and threshold timing the result is the same.
+ *
+ * @brief Calculate a finer binned drift time spectrum
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data DataSet containing the events
+ * @param subBins Number of spectrum bins per FADC bin, at least 1
+ *
+ * @return DriftTimeSpectrum object containing the spectrum, bin i starts at i * binsToTime / subBins
+ */
+const DriftTimeSpectrum DataProcessor::calculateDriftTimeSpectrum(const DataSet& data, const unsigned int subBins)
+{
+	const AnalysisConfig& config = AnalysisConfig::current();
+	const double binWidth = config.getBinsToTime() / (double)(subBins > 0 ? subBins : 1);
+	const long triggerOffset = (long)config.getTriggerBin() * (subBins > 0 ? subBins : 1);
+	unique_ptr<vector<uint32_t>> result(new vector<uint32_t>(data.getDriftTimeHistogram().size() * subBins,0));
+	for(const unique_ptr<Event>& event : data.getData())
 	{
-		try
-		{
-			result = make_unique<vector<uint32_t>>(data[i].getSize(),0);
-			break;
-		}
-		catch(const DataPresenceException& e)
+		if(!event)
 		{
 			continue;
 		}
-	}
-//	#pragma omp parallel for schedule(static) reduction(+:rejected)
-	for(size_t i = 0; i < data.getSize(); ++i)
-	{
-		try
-		{
-			short driftTimeBin = (short)(data[i].getDriftTime() / ADC_BINS_TO_TIME) - ADC_TRIGGERPOS_BIN;
-			//TODO THIS IS BAD!!!! Maybe it should be rejected, maybe not - more thinking needed
-			driftTimeBin = driftTimeBin < 0 ? 0 : driftTimeBin;
-			++(*result)[driftTimeBin];
-		}
-		catch(const Exception& e)
+		if(!config.isZeroSuppressed() && (short)(event->getDriftTime() / config.getBinsToTime()) == -42)
 		{
-//			#pragma omp critical
-//			{
-				++rejected;
-//			}
-		}
-	}
-	#else
-	unique_ptr<vector<uint32_t>> result = make_unique<vector<uint32_t>>(data[0].getSize(),0);
-
-//	#pragma omp parallel for schedule(static) shared(rejected)
-	for(size_t i = 0; i < data.getSize(); ++i)
-	{
-		short driftTimeBin = (short) (data[i].getDriftTime() / ADC_BINS_TO_TIME);
-		if(driftTimeBin != -42)
-		{
-			driftTimeBin = (data[i].getDriftTime() / ADC_BINS_TO_TIME) - ADC_TRIGGERPOS_BIN;
-			//TODO THIS IS BAD!!!! Maybe it should be rejected, maybe not - more thinking needed
-			driftTimeBin = driftTimeBin < 0 ? 0 : driftTimeBin;
-			(*result)[driftTimeBin]++;
+			continue;
 		}
-		else
+		long bin = (long)floor(event->getDriftTime() / binWidth) - triggerOffset;
+		bin = bin < 0 ? 0 : bin;
+		if((size_t)bin >= result->size())
 		{
-			rejected++;
+			result->resize(bin + 1,0);
 		}
+		++(*result)[bin];
 	}
-	#endif
-
-	return DriftTimeSpectrum(move(result), data.getSize(), rejected);
+	return DriftTimeSpectrum(move(result), data.getSize(), data.getRejected());
 }
 
 /**
@@ -272,9 +258,27 @@ const DriftTimeSpectrum DataProcessor::calculateDriftTimeSpectrum(const DataSet&
  *
  * @return RtRelation object containing the rt-relation
  *
- * @warning Needs drift tube data in globals.h to be set
+ * @warning Uses the tube radius of the current AnalysisConfig
  */
 const RtRelation DataProcessor::calculateRtRelation(const DriftTimeSpectrum& dtSpect)
+{
+	return calculateRtRelation(dtSpect,AnalysisConfig::current().getTubeRadius());
+}
+
+/**
+ * Calculates the relation between drift time and drift radius for a tube with the given radius, see
+ * calculateRtRelation(const DriftTimeSpectrum& dtSpect).
+ *
+ * @author Stefan Bieschke
+ * @version 1.0
+ * @date Oct. 18, 2026
+ *
+ * @param dtSpect DriftTimeSpectrum object reference containing the drift time spectrum
+ * @param radius Radius of the tube in mm
+ *
+ * @return RtRelation object containing the rt-relation
+ */
+const RtRelation DataProcessor::calculateRtRelation(const DriftTimeSpectrum& dtSpect, const double radius)
 {
 	if(dtSpect.getSize() == 0)
 	{
@@ -284,7 +288,7 @@ const RtRelation DataProcessor::calculateRtRelation(const DriftTimeSpectrum& dtS
 	unique_ptr<vector<double>> result(new vector<double>(nBins,0.0));
 
 	double integral = 0.0;
-	double scalingFactor = DRIFT_TUBE_RADIUS / (dtSpect.getEntries() - dtSpect.getRejected());
+	double scalingFactor = radius / (dtSpect.getEntries() - dtSpect.getRejected());
 
 	for(size_t i = 0; i < nBins; ++i)
 	{
@@ -336,14 +340,60 @@ const vector<array<uint16_t,2>*> DataProcessor::pulses_over_threshold(const Even
  */
 const vector<array<uint16_t, 2>*> DataProcessor::pulses_over_threshold(
 		const Event& data, unsigned short threshold, size_t from, size_t to)
+{
+	return pulses_over_threshold_impl(data,threshold,from,to,nullptr);
+}
+
+//TODO test
+/**
+ * Counts the number of pulses undershooting a given threshold voltage. Returns a list of two element arrays. These contain
+ * the times of the falling and the rising edge of the pulse. Here, only pulses between the bins from and to are counted.
+ * The arrays are placed in the passed MemoryArena, so that no heap allocation is needed per pulse.
+ *
+ * @author Stefan Bieschke
+ * @version 1.0
+ * @date Oct. 18, 2026
+ *
+ * @param data Event for that the pulses over threshold are to be analyzed
+ * @param threshold threshold that must be undershot in order to identify a "pulse"
+ * @param from first bin that is analyzed
+ * @param to bin after the last bin that is analyzed
+ * @param arena MemoryArena in which the arrays are allocated
+ * @return A vector containing a list of pulses, each with time of falling and rising edge in ns
+ *
+ * @warning The arrays live in the arena and must NOT be deleted by the caller, they are invalid once the arena is reset.
+ */
+const vector<array<uint16_t, 2>*> DataProcessor::pulses_over_threshold(
+		const Event& data, unsigned short threshold, size_t from, size_t to, MemoryArena& arena)
+{
+	return pulses_over_threshold_impl(data,threshold,from,to,&arena);
+}
+
+/**
+ * Implementation of the pulse finding for pulses_over_threshold(...). The arrays are allocated in the passed arena or with new.
+ *
+ * @author Stefan Bieschke
+ * @version 1.0
+ * @date Oct. 18, 2026
+ *
+ * @param data Event for that the pulses over threshold are to be analyzed
+ * @param threshold threshold that must be undershot in order to identify a "pulse"
+ * @param from first bin that is analyzed
+ * @param to bin after the last bin that is analyzed
+ * @param arena MemoryArena for the arrays, nullptr to allocate them with new
+ * @return A vector containing a list of pulses, each with time of falling and rising edge in ns
+ */
+const vector<array<uint16_t, 2>*> DataProcessor::pulses_over_threshold_impl(
+		const Event& data, unsigned short threshold, size_t from, size_t to, MemoryArena* arena)
 {
 	vector<array<uint16_t,2>*> result(0);
+	const short binsToTime = AnalysisConfig::current().getBinsToTime();
 	bool first_is_rising = data[from] <= threshold ? true : false;
 	bool pulse_ended = !first_is_rising;
 	//comment this if block when we don't want to count cases where the first edge is rising
 	if(first_is_rising)
 	{
-		result.push_back(new array<uint16_t,2>());
+		result.push_back(newPulse(arena));
 		(*result.back())[0] = 0xFFFF; //error for first is rising - results in negative time over threshold
 	}
 
@@ -353,8 +403,8 @@ const vector<array<uint16_t, 2>*> DataProcessor::pulses_over_threshold(
 		//if-else switches a variable in order not to count a single pulse bin per bin
 		if (data[i] <= threshold && pulse_ended)
 		{
-			result.push_back(new array<uint16_t,2>());
-			(*result.back())[0] = ADC_BINS_TO_TIME * i; //ns
+			result.push_back(newPulse(arena));
+			(*result.back())[0] = binsToTime * i; //ns
 			pulse_ended = false;
 		}
 		//in case we don't want to count cases where the first edge is rising
@@ -364,7 +414,7 @@ const vector<array<uint16_t, 2>*> DataProcessor::pulses_over_threshold(
 //		}
 		else if (data[i] > threshold && !pulse_ended)
 		{
-			(*result.back())[1] = ADC_BINS_TO_TIME * i; //ns
+			(*result.back())[1] = binsToTime * i; //ns
 			pulse_ended = true;
 		}
 	}
@@ -376,6 +426,25 @@ const vector<array<uint16_t, 2>*> DataProcessor::pulses_over_threshold(
 	return result;
 }
 
+/**
+ * Allocates a zero initialized array for the edges of one pulse in the passed MemoryArena or with new.
+ *
+ * @author Stefan Bieschke
+ * @version 1.0
+ * @date Oct. 18, 2026
+ *
+ * @param arena MemoryArena for the array, nullptr to allocate it with new
+ * @return Pointer to the array
+ */
+array<uint16_t,2>* DataProcessor::newPulse(MemoryArena* arena)
+{
+	if(arena)
+	{
+		return new (arena->allocate(sizeof(array<uint16_t,2>),alignof(array<uint16_t,2>))) array<uint16_t,2>();
+	}
+	return new array<uint16_t,2>();
+}
+
 /**
  * Counts the time over threshold for a set of pulse edge times that is passed to this method as parameter.
  *
@@ -424,25 +493,21 @@ const vector<uint16_t> DataProcessor::time_over_threshold(const vector<array<uin
  */
 const unsigned int DataProcessor::countAfterpulses(const Drifttube& tube)
 {
-	unsigned short maxDriftTimeBin = tube.getMaxDrifttime() / ADC_BINS_TO_TIME;
+	unsigned short maxDriftTimeBin = tube.getMaxDrifttime() / AnalysisConfig::current().getBinsToTime();
 	unsigned int nAfterPulses = 0;
+	//pulse arrays of one event are only needed for counting, reuse the same memory for every event
+	MemoryArena pulseArena(1 << 12);
 
 	//counting loop
 	for (unsigned int i = 0; i < tube.getDataSet().getSize(); ++i)
 	{
 		try
 		{
-			//assume the pulse has already ended
-			bool pulseEnded = true;
-			Event voltage = tube.getDataSet().getEvent(i);
-			uint16_t threshold = ABSOLUTE_OFFSET_ZERO_VOLTAGE + ABSOLUTE_EVENT_THRESHOLD_VOLTAGE;
+			const Event& voltage = tube.getDataSet().getEvent(i);
 			vector<array<uint16_t, 2>*> pulses = pulses_over_threshold(voltage,
-					threshold, maxDriftTimeBin, voltage.getSize());
+					voltage.getThreshold(), maxDriftTimeBin, voltage.getSize(), pulseArena);
 			nAfterPulses += pulses.size();
-			for(array<uint16_t,2>* arr : pulses)
-			{
-				delete [] arr;
-			}
+			pulseArena.reset();
 		} catch (Exception& e)
 		{
 			continue;
@@ -452,6 +517,65 @@ const unsigned int DataProcessor::countAfterpulses(const Drifttube& tube)
 	return nAfterPulses;
 }
 
+/**
+ * Reconstructs one straight track for every trigger of a TriggerEventCollection. The drift times of the hit tubes are
+ * converted to drift radii with the rt-relation of the respective tube and a track is fitted tangent to the resulting
+ * drift circles. Up to TRACK_MAX_COMBINATORIAL_HITS hits, the left/right ambiguities are resolved by trying all
+ * combinations, triggers with more hits are seeded by the LegendreTrackFinder, which also rejects noise hits.
+ * The triggers are processed in parallel, each thread reuses its own finder and buffer of drift circles.
+ *
+ * @brief Reconstruct tracks of all triggers
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param hits Trigger aligned hits of all tubes
+ * @param rtRelations rt-relation for each tube, ordered like the tubes in hits
+ * @param minHits Minimum number of hit tubes for a track to be fitted
+ *
+ * @return One track per trigger, the track is invalid if the trigger has too few hits or no track was found
+ */
+const vector<Track> DataProcessor::reconstructTracks(const TriggerEventCollection& hits, const vector<const RtRelation*>& rtRelations, const unsigned int minHits)
+{
+	const long nTriggers = hits.getNumberOfTriggers();
+	const size_t nTubes = hits.getNumberOfTubes();
+	const vector<array<double,2>>& positions = hits.getTubePositions();
+	vector<Track> tracks(nTriggers);
+
+	#pragma omp parallel
+	{
+		vector<DriftCircle> circles(nTubes);
+		LegendreTrackFinder finder;
+		#pragma omp for schedule(static,1024)
+		for(long trigger = 0; trigger < nTriggers; ++trigger)
+		{
+			const Hit* triggerHits = hits.getHits(trigger);
+			size_t n = 0;
+			for(size_t tube = 0; tube < nTubes; ++tube)
+			{
+				if(TriggerEventCollection::isHit(triggerHits[tube]))
+				{
+					circles[n].x = positions[tube][0];
+					circles[n].y = positions[tube][1];
+					circles[n].radius = Track::driftRadius(*rtRelations[tube], triggerHits[tube].driftTime);
+					++n;
+				}
+			}
+			if(n >= minHits && n <= TRACK_MAX_COMBINATORIAL_HITS)
+			{
+				tracks[trigger] = Track::fit(circles.data(),n);
+			}
+			else if(n >= minHits)
+			{
+				tracks[trigger] = finder.find(circles.data(),n);
+			}
+		}
+	}
+
+	return tracks;
+}
+
 //TODO Change it to return it corrected for triggertime offset
 /**
  * Finds the bin number in a passed Event, in which a passed threshold is first surpassed.
@@ -468,14 +592,193 @@ const unsigned int DataProcessor::countAfterpulses(const Drifttube& tube)
  */
 short DataProcessor::findDriftTimeBin(const Event& data, unsigned short threshold)
 {
-	for(unsigned short i = 0; i < data.getData().size(); ++i)
+	return findDriftTimeBin(data.getData().data(),data.getSize(),threshold);
+}
+
+/**
+ * Finds the bin number in raw FADC data, in which a passed threshold is first surpassed. This works on a plain buffer, so that
+ * it can be used on data that has not (yet) been stored in an Event.
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data Pointer to the first bin of the raw data
+ * @param size Number of bins
+ * @param threshold threshold in FADC units (arbitrary). This must be UNDERSHOT if a drift time exists.
+ *
+ * @return Bin number of the first occurance of a signal larger than threshold, -42 if there is none
+ */
+short DataProcessor::findDriftTimeBin(const uint16_t* data, const size_t size, unsigned short threshold)
+{
+	return findDriftTimeBin<true>(data,size,threshold);
+}
+
+/**
+ * Finds the drift time bin in raw FADC data with threshold and polarity of a configuration. If the configuration has
+ * baseline bins, the threshold is relative to the baseline of the data. This chooses the kernel once, the loop over the
+ * samples does not depend on the configuration.
+ *
+ * @brief Find the drift time bin for a configuration
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data Pointer to the first bin of the raw data
+ * @param size Number of bins
+ * @param config Configuration with threshold and polarity
+ *
+ * @return Bin number of the first sample beyond the threshold, -42 if there is none
+ */
+short DataProcessor::findDriftTimeBin(const uint16_t* data, const size_t size, const AnalysisConfig& config)
+{
+	float baseline, noise;
+	estimateBaseline(data,size,config,baseline,noise);
+	const uint16_t threshold = config.getAbsoluteThreshold(baseline,noise);
+	if(config.isNegative())
 	{
-		if(data[i] < threshold)
+		return findDriftTimeBin<true>(data,size,threshold);
+	}
+	return findDriftTimeBin<false>(data,size,threshold);
+}
+
+/**
+ * Refines the bin of the first threshold crossing to a drift time with sub-bin resolution, as set by the timing of the
+ * configuration. The refinement only reads the samples around the crossing, which are still in the cache from the
+ * threshold search.
+ *
+ * @brief Sub-bin drift time
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data Pointer to the first bin of the raw data
+ * @param size Number of bins
+ * @param bin Bin of the first threshold crossing as found by findDriftTimeBin(...), negative if there is none
+ * @param threshold Threshold that was used to find the bin
+ * @param baseline Baseline of the data, for the constant fraction discriminator
+ * @param config Configuration with timing and polarity
+ *
+ * @return Drift time in bins, bin itself for AnalysisConfig::THRESHOLD or if there is no crossing
+ */
+float DataProcessor::refineDriftTimeBin(const uint16_t* data, const size_t size, const short bin, const uint16_t threshold, const float baseline, const AnalysisConfig& config)
+{
+	if(bin < 0)
+	{
+		return bin;
+	}
+	switch(config.getTiming())
+	{
+	case AnalysisConfig::INTERPOLATED:
+		return interpolateCrossing(data,bin,threshold);
+	case AnalysisConfig::CONSTANT_FRACTION:
+		if(config.isNegative())
 		{
-			return i;
+			return findConstantFraction<true>(data,size,bin,baseline,config.getCfdFraction(),config.getCfdWindow());
 		}
+		return findConstantFraction<false>(data,size,bin,baseline,config.getCfdFraction(),config.getCfdWindow());
+	default:
+		return bin;
+	}
+}
+
+/**
+ * Linear interpolation of the crossing of a level between the sample before a bin and the bin itself. Works for both
+ * polarities.
+ *
+ * @brief Interpolated crossing time
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data Pointer to the first bin of the raw data
+ * @param bin First bin beyond the level
+ * @param level The level in FADC units
+ *
+ * @return Time of the crossing in bins, between bin - 1 and bin, 0 for bin 0
+ */
+float DataProcessor::interpolateCrossing(const uint16_t* data, const size_t bin, const float level)
+{
+	if(bin == 0)
+	{
+		return 0;
+	}
+	const float before = data[bin - 1];
+	const float difference = before - data[bin];
+	if(difference == 0)
+	{
+		return bin;
+	}
+	float fraction = (before - level) / difference;
+	fraction = fraction < 0 ? 0 : (fraction > 1 ? 1 : fraction);
+	return bin - 1 + fraction;
+}
+
+/**
+ * Estimates the baseline and noise of an event from its first bins, which are expected to be before the trigger. The
+ * baseline is the mean, the noise the RMS around it. The sums are integer sums without branches, so that the loop is
+ * vectorised.
+ *
+ * @brief Pre-trigger baseline and noise
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data Pointer to the first bin of the raw data
+ * @param nBins Number of bins to use, at most 65536
+ * @param baseline Mean of the bins in FADC units, set by this function
+ * @param noise RMS of the bins around the mean in FADC units, set by this function
+ */
+void DataProcessor::estimateBaseline(const uint16_t* data, const size_t nBins, float& baseline, float& noise)
+{
+	if(nBins == 0)
+	{
+		baseline = noise = 0;
+		return;
+	}
+	uint32_t sum = 0;
+	uint64_t sumSquares = 0;
+	for(size_t i = 0; i < nBins; ++i)
+	{
+		sum += data[i];
+		sumSquares += (uint32_t)data[i] * data[i];
+	}
+	const double mean = sum / (double)nBins;
+	const double variance = sumSquares / (double)nBins - mean * mean;
+	baseline = mean;
+	noise = variance > 0 ? sqrt(variance) : 0;
+}
+
+/**
+ * Estimates the baseline and noise of an event as configured. With baseline bins, see estimateBaseline(...) for the
+ * first AnalysisConfig::getBaselineBins() bins, without them, the baseline is the offset and there is no noise.
+ *
+ * @brief Baseline and noise for a configuration
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data Pointer to the first bin of the raw data
+ * @param size Number of bins of the data
+ * @param config Configuration with offset and baseline bins
+ * @param baseline Baseline in FADC units, set by this function
+ * @param noise Noise RMS in FADC units, set by this function
+ */
+void DataProcessor::estimateBaseline(const uint16_t* data, const size_t size, const AnalysisConfig& config, float& baseline, float& noise)
+{
+	const size_t nBins = config.getBaselineBins() < size ? config.getBaselineBins() : size;
+	if(nBins == 0)
+	{
+		baseline = config.getOffset();
+		noise = 0;
+		return;
 	}
-	return -42;
+	estimateBaseline(data,nBins,baseline,noise);
 }
 
 /**
@@ -5,6 +5,7 @@
 class Event;
 class DataSet;
 class Drifttube;
+class TriggerEventCollection;
 
 #include <omp.h>
 #include <iostream>
@@ -18,8 +19,11 @@ class Drifttube;
 #include <array>
 #include <memory>
 #include "Event.h"
+#include "MemoryArena.h"
 #include "RtRelation.h"
 #include "DriftTimeSpectrum.h"
+#include "Track.h"
+#include "AnalysisConfig.h"
 
 //TODO Change all doc to vector and variable length (Nov. 14, 2018)
 
@@ -47,17 +51,110 @@ public:
 //	static std::unique_ptr<DataSet> integrateAll(const DataSet& data) const;
 	static unsigned short findMinimumBin(const Event& data);
 	static short findDriftTimeBin(const Event& data, unsigned short threshold);
+	static short findDriftTimeBin(const uint16_t* data, const size_t size, unsigned short threshold);
+	static short findDriftTimeBin(const uint16_t* data, const size_t size, const AnalysisConfig& config);
+	static void estimateBaseline(const uint16_t* data, const size_t nBins, float& baseline, float& noise);
+	static void estimateBaseline(const uint16_t* data, const size_t size, const AnalysisConfig& config, float& baseline, float& noise);
+	static float refineDriftTimeBin(const uint16_t* data, const size_t size, const short bin, const uint16_t threshold, const float baseline, const AnalysisConfig& config);
+	static float interpolateCrossing(const uint16_t* data, const size_t bin, const float level);
+	template<bool Negative>
+	static float findConstantFraction(const uint16_t* data, const size_t size, const size_t bin, const float baseline, const float fraction, const size_t window);
+	template<bool Negative, size_t NSamples = 0>
+	static short findDriftTimeBin(const uint16_t* data, const size_t size, const uint16_t threshold);
 	static unsigned short findLastFilledBin(const Event& data, unsigned short threshold);
 	static const DriftTimeSpectrum calculateDriftTimeSpectrum(const DataSet& data);
+	static const DriftTimeSpectrum calculateDriftTimeSpectrum(const DataSet& data, const unsigned int subBins);
 	static const RtRelation calculateRtRelation(const DriftTimeSpectrum& dtSpect);
+	static const RtRelation calculateRtRelation(const DriftTimeSpectrum& dtSpect, const double radius);
 	static const std::vector<std::array<uint16_t,2>*> pulses_over_threshold(const Event& data, unsigned short threshold);
 	static const std::vector<std::array<uint16_t,2>*> pulses_over_threshold(const Event& data, unsigned short threshold, size_t from, size_t to);
+	static const std::vector<std::array<uint16_t,2>*> pulses_over_threshold(const Event& data, unsigned short threshold, size_t from, size_t to, MemoryArena& arena);
 	static const std::vector<uint16_t> time_over_threshold(const std::vector<array<uint16_t,2>*>& pulses);
 	static const unsigned int countAfterpulses(const Drifttube& tube);
+	static const std::vector<Track> reconstructTracks(const TriggerEventCollection& hits, const std::vector<const RtRelation*>& rtRelations, const unsigned int minHits = 3);
 
 private:
+	static const std::vector<std::array<uint16_t,2>*> pulses_over_threshold_impl(const Event& data, unsigned short threshold, size_t from, size_t to, MemoryArena* arena);
+	static std::array<uint16_t,2>* newPulse(MemoryArena* arena);
+
 	DataProcessor();
 	~DataProcessor();
 };
 
+/**
+ * Kernel for the drift time bin. The polarity and, if NSamples is not 0, the number of samples are compile time
+ * constants, so that the loop has no other branch than the comparison with the threshold.
+ *
+ * @brief Find the drift time bin, specialised on polarity and event size
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @tparam Negative If true, the threshold must be undershot, else exceeded
+ * @tparam NSamples Number of samples, 0 to use size
+ * @param data Pointer to the first bin of the raw data
+ * @param size Number of bins, ignored if NSamples is not 0
+ * @param threshold Threshold in FADC units
+ *
+ * @return Bin number of the first sample beyond the threshold, -42 if there is none
+ */
+template<bool Negative, size_t NSamples>
+short DataProcessor::findDriftTimeBin(const uint16_t* data, const size_t size, const uint16_t threshold)
+{
+	const size_t n = NSamples > 0 ? NSamples : size;
+	for(size_t i = 0; i < n; ++i)
+	{
+		if(Negative ? data[i] < threshold : data[i] > threshold)
+		{
+			return i;
+		}
+	}
+	return -42;
+}
+
+/**
+ * Constant fraction discriminator. The amplitude of the pulse is the extremum within window bins from the threshold
+ * crossing on, the time is the crossing of the given fraction of that amplitude relative to the baseline, searched
+ * backwards from the extremum and interpolated linearly between two samples. Unlike the threshold crossing, this time
+ * does not depend on the amplitude of the pulse. The extremum is found by a reduction over the window, which is vectorised.
+ *
+ * @brief Constant fraction time of a pulse
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @tparam Negative If true, pulses undershoot the baseline, else exceed it
+ * @param data Pointer to the first bin of the raw data
+ * @param size Number of bins
+ * @param bin Bin of the threshold crossing
+ * @param baseline Baseline in FADC units
+ * @param fraction Fraction of the amplitude between 0 and 1
+ * @param window Number of bins, in which the extremum is searched
+ *
+ * @return Time of the constant fraction crossing in bins
+ */
+template<bool Negative>
+float DataProcessor::findConstantFraction(const uint16_t* data, const size_t size, const size_t bin, const float baseline, const float fraction, const size_t window)
+{
+	const size_t end = bin + window < size ? bin + window : size;
+	uint16_t peak = data[bin];
+	for(size_t i = bin; i < end; ++i)
+	{
+		peak = Negative ? (data[i] < peak ? data[i] : peak) : (data[i] > peak ? data[i] : peak);
+	}
+	size_t crossing = bin;
+	while(data[crossing] != peak)
+	{
+		++crossing;
+	}
+	const float level = baseline + fraction * (peak - baseline);
+	while(crossing > 0 && (Negative ? data[crossing - 1] < level : data[crossing - 1] > level))
+	{
+		--crossing;
+	}
+	return interpolateCrossing(data,crossing,level);
+}
+
 #endif //DATAPROCESSOR_H_
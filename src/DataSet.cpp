@@ -19,6 +19,11 @@ DataSet::DataSet()
 	m_data.resize(0);
 	m_mean_offset_zero_voltage = 0;
 	m_mean_noise_amplitude = 0;
+	m_rejected = 0;
+	m_n_offset_samples = 0;
+	m_offset_mean = 0;
+	m_offset_m2 = 0;
+	m_noise_squares = 0;
 }
 
 
@@ -53,20 +58,46 @@ DataSet::DataSet(vector<unique_ptr<Event>>& data)
 	}
 	data.clear();
 	data.resize(0);
-	try
-	{
-		m_mean_offset_zero_voltage = calc_mean_offset();
-		m_mean_noise_amplitude = calc_mean_noise_amplitude(m_mean_offset_zero_voltage);
-	}
-	catch(const DataPresenceException& e)
+
+	//invalid until at least one present event was accumulated
+	m_mean_offset_zero_voltage = -1.0;
+	m_mean_noise_amplitude = -1.0;
+	m_rejected = 0;
+	m_n_offset_samples = 0;
+	m_offset_mean = 0;
+	m_offset_m2 = 0;
+	m_noise_squares = 0;
+	for(size_t i = 0; i < size; ++i)
 	{
-		m_mean_offset_zero_voltage = -1.0;
-		m_mean_noise_amplitude = -1.0;
+		accumulate(m_data[i].get());
 	}
 }
 
 /**
- * First implementation of a copy constructor for DataSets in order to enable DataSet operators to work
+ * Constructor that takes a vector containing Events that were placed in a MemoryArena (see MemoryArena::Scope). The DataSet
+ * keeps the arena alive as long as it holds the Events, destroying the DataSet gives back the memory of all Events and
+ * their samples at once.
+ * Apart from that, this behaves exactly like DataSet(vector<unique_ptr<Event>>& data).
+ *
+ * @brief constructor with a data-vector and the arena holding the data as arguments
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data Reference to a vector containing unique pointers to Events. Those will be transferred to the DataSet member.
+ * @param arena The arena in which the Events were allocated
+ *
+ * @warning After finishing of this method, the passed vector will be empty and size 0.
+ */
+DataSet::DataSet(vector<unique_ptr<Event>>& data, shared_ptr<MemoryArena> arena) : DataSet(data)
+{
+	m_arena = move(arena);
+}
+
+/**
+ * First implementation of a copy constructor for DataSets in order to enable DataSet operators to work. The copied Events are
+ * placed on the heap (or the current arena of the calling thread), not in the arena of the original.
  *
  * @author Stefan
  * @date March 31, 2017
@@ -79,6 +110,8 @@ DataSet::DataSet(const DataSet& original)
 	//copy size of original DataSet
 	//create new vector containing the raw data and go into deep copy of its content
 	m_data = std::vector<unique_ptr<Event>>(original.getSize());
+	//the copy does not own any arena, so its Events must live on the heap
+	MemoryArena::Scope heap(nullptr);
 
 	//deep copy
 	//note: range based for (aka for each) does not work, since that would be a copy of the unique pointer
@@ -91,6 +124,12 @@ DataSet::DataSet(const DataSet& original)
 	}
 	m_mean_offset_zero_voltage = original.m_mean_offset_zero_voltage;
 	m_mean_noise_amplitude = original.m_mean_noise_amplitude;
+	m_dt_histogram = original.m_dt_histogram;
+	m_rejected = original.m_rejected;
+	m_n_offset_samples = original.m_n_offset_samples;
+	m_offset_mean = original.m_offset_mean;
+	m_offset_m2 = original.m_offset_m2;
+	m_noise_squares = original.m_noise_squares;
 }
 
 /**
@@ -112,7 +151,8 @@ DataSet::~DataSet()
 
 
 /**
- * Adds an Event to the DataSet. Does increment the size of the DataSet as well.
+ * Adds an Event to the DataSet. Does increment the size of the DataSet as well. The running statistics of the DataSet are
+ * updated in constant time. A nullptr is stored as a rejected (zero suppressed) event.
  *
  * @brief Add Event to the DataSet
  *
@@ -120,15 +160,15 @@ DataSet::~DataSet()
  * @date April 18, 2017
  * @version Alpha 2.0
  *
- * @param data the Event to add to the DataSet
+ * @param data the Event to add to the DataSet, nullptr for a rejected event
  *
- * @require data != nullptr
  * @ensure new size = old size + 1
  */
 void DataSet::addData(unique_ptr<Event> data)
 {
 	//move the ownership of the data array to the vector m_data, that should finally store it
 	m_data.push_back(move(data));
+	accumulate(m_data.back().get());
 }
 
 /**
@@ -193,19 +233,17 @@ const Event& DataSet::getEvent(const unsigned int event) const
 	{
 		throw EventSizeException(event);
 	}
-	#ifdef ZEROSUP
 	if(!m_data[event])
 	{
 		throw DataPresenceException();
 	}
-	#endif
 	return *(m_data[event]);
 }
 
 /**
  * Getter for the mean offset zero voltage. This returns a const reference to the mean
  * offset of the zero voltage for all the events in this DataSet. For calculation details
- * see the documentation of the function @c calc_mean_offset_voltage().
+ * see the documentation of the function @c accumulate(const Event* event).
  *
  * @brief Getter for mean noise amplitude
  *
@@ -223,7 +261,7 @@ const double& DataSet::get_mean_offset_voltage() const
 /**
  * Getter for the mean noise amplitude. This returns a const reference to the mean
  * amplitude of the voltage for all the events in this DataSet. For calculation details
- * see the documentation of the function @c calc_mean_noise_amplitude(const double& mean_offset).
+ * see the documentation of the function @c accumulate(const Event* event).
  *
  * @brief Getter for mean noise amplitude
  *
@@ -270,92 +308,92 @@ const Event& DataSet::operator[](const unsigned int event) const
 }
 
 /**
- * Calculate the mean value of the offset zero voltage. This needs the trigger position
- * of the FADC to be set to a positive time bin > 0. This calculates the mean of the voltages
- * in FADC units for the bin number zero in all events stored in this DataSet object.
- * This value can later be subtracted from all entries when storing the events in a form
- * containing voltages in Volts.
+ * Getter for the histogram of drift time bins of all events in this DataSet. The histogram is filled whenever an Event is
+ * added, its size is the number of bins of the first present Event. Bin numbers are corrected for the trigger position.
  *
- * @brief Compute mean offset zero voltage
+ * @brief Getter for the drift time histogram
  *
  * @author Stefan Bieschke
- * @date Oct. 17, 2019
+ * @date Oct. 18, 2026
  * @version 1.0
  *
- * @return Mean value of offset zero voltage
+ * @return Const reference to the histogram, empty if no Event is present
  */
-double DataSet::calc_mean_offset() const
+const vector<uint32_t>& DataSet::getDriftTimeHistogram() const
 {
-	double mean = 0;
-
-	size_t n_events = m_data.size();
-	unsigned int zerosupressed_events = 0;
-
-	//TODO parallel computation
-	for(size_t i = 0; i < n_events; ++i)
-	{
-		try
-		{
-			Event e = getEvent(i);
-			uint16_t voltage_zero = e[0];
-			mean += voltage_zero;
-		}
-		catch(const Exception& e)
-		{
-			++zerosupressed_events;
-			continue;
-		}
-	}
-
-	if(n_events - zerosupressed_events == 0)
-	{
-		//TODO use c++ standard exceptions and a more fitting exception type
-		throw DataPresenceException();
-	}
-	mean /= (n_events - zerosupressed_events);
-
-	return mean;
+	return m_dt_histogram;
 }
 
 /**
- * Calculate the mean noise amplitude. This mean amplitude, considering a Gaussian distribution
- * of noise amplitudes, can be interpreted as the standard deviation of the very first
- * entries in all events stored in this DataSet. Therefore, the mean value of these values
- * is passed to this method as parameter.
+ * Getter for the number of rejected events in this DataSet. An Event is rejected, if it is not present (zero suppression)
+ * or if no drift time was found for it.
  *
- * @brief Calculate the mean noise amplitude
+ * @brief Getter for the number of rejected events
  *
  * @author Stefan Bieschke
- * @date Oct. 17, 2019
+ * @date Oct. 18, 2026
  * @version 1.0
  *
- * @param mean_offset The mean value of the offset zero voltages
- * @return Mean amplitude of noise in FADC units
+ * @return Number of rejected events
  */
-double DataSet::calc_mean_noise_amplitude(const double& mean_offset) const
+unsigned int DataSet::getRejected() const
 {
-	double std = 0; //standard deviation from mean
+	return m_rejected;
+}
 
-	size_t n_events = m_data.size();
-	unsigned int zerosupressed_events = 0;
+/**
+ * Updates the running statistics with one Event. This fills the drift time histogram or counts the Event as rejected and
+ * updates mean offset zero voltage and mean noise amplitude with the voltage in bin zero using Welford's algorithm. The mean
+ * noise amplitude is the standard deviation of those voltages. If the AnalysisConfig has baseline bins, the baselines of
+ * the Events are used instead of bin zero and the noise amplitude also contains the noise within the Events, so it is the
+ * RMS of all baseline samples around the mean offset. Constant time per Event.
+ *
+ * @brief Accumulate statistics for one Event
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param event Pointer to the added Event, nullptr for a rejected Event
+ */
+void DataSet::accumulate(const Event* event)
+{
+	if(!event)
+	{
+		++m_rejected;
+		return;
+	}
+	if(m_dt_histogram.size() == 0)
+	{
+		m_dt_histogram.resize(event->getSize(),0);
+	}
 
-	//TODO parallel computation
-	for (size_t i = 0; i < n_events; ++i)
+	const AnalysisConfig& config = AnalysisConfig::current();
+	short driftTimeBin = (short)(event->getDriftTime() / config.getBinsToTime());
+	if(!config.isZeroSuppressed() && driftTimeBin == -42)
 	{
-		try
-		{
-			Event e = getEvent(i);
-			uint16_t voltage_zero = e[0];
-			std += pow((double)voltage_zero - mean_offset,2);
-		} catch (const Exception& e)
+		++m_rejected;
+	}
+	else
+	{
+		driftTimeBin -= config.getTriggerBin();
+		//TODO THIS IS BAD!!!! Maybe it should be rejected, maybe not - more thinking needed
+		driftTimeBin = driftTimeBin < 0 ? 0 : driftTimeBin;
+		if((size_t)driftTimeBin >= m_dt_histogram.size())
 		{
-			++zerosupressed_events;
-			continue;
+			m_dt_histogram.resize(driftTimeBin + 1,0);
 		}
+		++m_dt_histogram[driftTimeBin];
 	}
 
-	std /= (n_events - zerosupressed_events);
-	std = sqrt(std);
+	const bool estimated = config.getBaselineBins() > 0;
+	double voltage_zero = estimated ? event->getBaseline() : (*event)[0];
+	++m_n_offset_samples;
+	double delta = voltage_zero - m_offset_mean;
+	m_offset_mean += delta / m_n_offset_samples;
+	m_offset_m2 += delta * (voltage_zero - m_offset_mean);
+	m_noise_squares += estimated ? event->getNoise() * event->getNoise() : 0;
 
-	return std;
+	m_mean_offset_zero_voltage = m_offset_mean;
+	m_mean_noise_amplitude = sqrt((m_offset_m2 + m_noise_squares) / m_n_offset_samples);
 }
@@ -13,6 +13,7 @@
 #include <vector>
 #include <memory>
 #include "Event.h"
+#include "MemoryArena.h"
 #include <cmath>
 
 /**
@@ -24,6 +25,8 @@
  * Unique smart pointers can only exist once. If you want to transfer ownership (e.g pass them around or or store them somewhere) you need to
  * use the move semantics. More on that can be read at http://eli.thegreenplace.net/2011/12/15/understanding-lvalues-and-rvalues-in-c-and-c .
  * For its usage see the methods addData(...) in file DataSet.cpp for example.
+ * Every added Event updates running statistics (drift time histogram, number of rejected events, mean offset and noise)
+ * in constant time, so that nothing needs to be recomputed from the full set when data is appended.
  *
  * @brief Collection of data
  *
@@ -36,6 +39,7 @@ class DataSet
 public:
 	DataSet();
 	DataSet(std::vector<std::unique_ptr<Event>>& data);
+	DataSet(std::vector<std::unique_ptr<Event>>& data, std::shared_ptr<MemoryArena> arena);
 	DataSet(const DataSet& original);
 	virtual ~DataSet();
 
@@ -45,17 +49,27 @@ public:
 	const std::vector<std::unique_ptr<Event>>& getData() const;
 	const double& get_mean_offset_voltage() const;
 	const double& get_mean_noise_amplitude() const;
+	const std::vector<uint32_t>& getDriftTimeHistogram() const;
+	unsigned int getRejected() const;
 
 	const Event& operator[](const unsigned int event) const;
 
 private:
 	//private helper methods
-	double calc_mean_offset() const;
-	double calc_mean_noise_amplitude(const double& mean_offset) const;
+	void accumulate(const Event* event);
+	//arena holding the Events, declared before m_data so that it outlives them
+	std::shared_ptr<MemoryArena> m_arena;
 	//standard library vector, that stores unique pointers to the raw data arrays
 	std::vector<std::unique_ptr<Event>> m_data;
 	double m_mean_offset_zero_voltage;
 	double m_mean_noise_amplitude;
+	//running statistics, updated in O(1) for every added event
+	std::vector<uint32_t> m_dt_histogram;
+	unsigned int m_rejected;
+	size_t m_n_offset_samples;
+	double m_offset_mean;
+	double m_offset_m2; //sum of squared deviations from the running mean (Welford)
+	double m_noise_squares; //sum of the squared noise of the events, if their baselines are estimated
 };
 
 #endif /* DATASET_H_ */
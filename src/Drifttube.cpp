@@ -10,9 +10,9 @@
 using namespace std;
 
 /**
- * Constructor of the drift tube. Initializes the Drifttube object. During the process of initialization, the drift time spectrum and
- * rt relation are calculated and stored in the Drifttube as well. The calculation is performed and results are provided by the static
- * class DataProcessor. The efficiency is ready calculated after initialization as well.
+ * Constructor of the drift tube. Initializes the Drifttube object. No analysis is performed during construction, the drift time
+ * spectrum, rt relation, efficiency and maximum drift time are calculated by the static class DataProcessor when they are
+ * requested for the first time and cached afterwards.
  *
  * @brief ctor
  *
@@ -23,33 +23,21 @@ using namespace std;
  * @param posX x-coordinate [mm] of the tube
  * @param posY y-coordinate [mm] of the tube
  * @param data unique_ptr to the DataSet of Events in this Drifttube
+ * @param radius Radius [mm] of the tube, usually taken from the ChamberGeometry
  */
-Drifttube::Drifttube(int posX, int posY, unique_ptr<DataSet> data)
-: m_dtSpect(DataProcessor::calculateDriftTimeSpectrum(*data)), m_rtRel(DataProcessor::calculateRtRelation(m_dtSpect))
+Drifttube::Drifttube(const double posX, const double posY, unique_ptr<DataSet> data, const double radius)
 {
+	m_radius = (unsigned int)round(radius * 1000);
 	m_position[0] = posX;
 	m_position[1] = posY;
 	m_data = move(data);
-
-	unsigned int numberOfRealEvents = m_dtSpect.getEntries() - m_dtSpect.getRejected();
-	m_efficiency = numberOfRealEvents/(double)m_dtSpect.getEntries();
-//	cout << "efficiency = " << m_efficiency << " +- " << sqrt(m_efficiency*(1-m_efficiency)/(double)m_dtSpect.getEntries()) << endl;
-
-	//TODO check, if this is faster than putting m_rtRel.getData().size() in the for loop conditional
-	size_t arraySize = m_rtRel.getData().size();
-	for(size_t i = 0; i < arraySize; ++i)
-	{
-		if(m_rtRel[i] >= DRIFT_TUBE_RADIUS - DRIFT_TUBE_RADIUS * 0.0005)
-		{
-			m_max_drifttime = i * ADC_BINS_TO_TIME;
-			break;
-		}
-	}
+	invalidate();
 }
 
 
 /**
- * Copy constructor. Initializes a copy of a passed Drifttube object including copies of the DataSet for that Drifttube.
+ * Copy constructor. Initializes a copy of a passed Drifttube object. The copy shares the DataSet with the original, no Event is
+ * copied. Results that have already been computed for the original are copied as well.
  *
  * @author Stefan Bieschke
  * @version Alpha 2.0
@@ -58,12 +46,29 @@ Drifttube::Drifttube(int posX, int posY, unique_ptr<DataSet> data)
  * @param original Reference to the original Drifttube object of that a copy should be created
  */
 Drifttube::Drifttube(const Drifttube& original)
-: m_dtSpect(original.m_dtSpect), m_rtRel(original.m_rtRel)
 {
-	m_data = unique_ptr<DataSet>(new DataSet(*original.m_data));
-	m_efficiency = original.m_efficiency;
+	m_data = original.m_data;
+	m_radius = original.m_radius;
 	m_position = original.m_position;
-	m_max_drifttime = original.m_max_drifttime;
+	copyCache(original);
+}
+
+/**
+ * Move constructor. Takes over the DataSet and all cached results of the original. The original must not be used afterwards,
+ * except for assigning a new value to it or destroying it.
+ *
+ * @author Stefan Bieschke
+ * @version 1.0
+ * @date Oct. 18, 2026
+ *
+ * @param original rvalue reference to the Drifttube that is moved
+ */
+Drifttube::Drifttube(Drifttube&& original)
+{
+	m_data = move(original.m_data);
+	m_radius = original.m_radius;
+	m_position = original.m_position;
+	moveCache(original);
 }
 
 Drifttube::~Drifttube()
@@ -72,7 +77,7 @@ Drifttube::~Drifttube()
 }
 
 /**
- * Getter method for the radius of the drift tube in millimeters.
+ * Getter method for the radius of the drift tube in micrometers.
  *
  * @brief Radius getter
  *
@@ -81,7 +86,7 @@ Drifttube::~Drifttube()
  * @version Alpha 2.0
  *
  *
- * @return Radius of the drift tube in millimeters
+ * @return Radius of the drift tube in micrometers
  */
 const unsigned int Drifttube::getRadius() const
 {
@@ -100,7 +105,7 @@ const unsigned int Drifttube::getRadius() const
  *
  * @return x coordinate in millimeters
  */
-const int Drifttube::getPositionX() const
+const double Drifttube::getPositionX() const
 {
 	return m_position[0];
 }
@@ -117,7 +122,7 @@ const int Drifttube::getPositionX() const
  *
  * @return y coordinate in millimeters
  */
-const int Drifttube::getPositionY() const
+const double Drifttube::getPositionY() const
 {
 	return m_position[1];
 }
@@ -134,13 +139,13 @@ const int Drifttube::getPositionY() const
  *
  * @return const reference to the position array. Values in mm.
  */
-const array<int,2>& Drifttube::getPosition() const
+const array<double,2>& Drifttube::getPosition() const
 {
 	return m_position;
 }
 
 /**
- * Getter method for the drift time spectrum.
+ * Getter method for the drift time spectrum. The spectrum is calculated on the first call and cached.
  *
  * @brief drift time spectrum getter
  *
@@ -152,11 +157,18 @@ const array<int,2>& Drifttube::getPosition() const
  */
 const DriftTimeSpectrum& Drifttube::getDriftTimeSpectrum() const
 {
-	return m_dtSpect;
+	if(!m_dtSpect)
+	{
+		const unsigned short subBins = AnalysisConfig::current().getSubBins();
+		m_dtSpect.reset(new DriftTimeSpectrum(subBins > 1 ? DataProcessor::calculateDriftTimeSpectrum(*m_data,subBins)
+				: DataProcessor::calculateDriftTimeSpectrum(*m_data)));
+	}
+	return *m_dtSpect;
 }
 
 /**
- * Getter method for the rt-relation. This maps the drift radius (mm) to the drift time (ns).
+ * Getter method for the rt-relation. This maps the drift radius (mm) to the drift time (ns). The rt-relation is calculated
+ * on the first call and cached.
  *
  * @brief rt-relation getter
  *
@@ -168,13 +180,18 @@ const DriftTimeSpectrum& Drifttube::getDriftTimeSpectrum() const
  */
 const RtRelation& Drifttube::getRtRelation() const
 {
-	return m_rtRel;
+	if(!m_rtRel)
+	{
+		m_rtRel.reset(new RtRelation(DataProcessor::calculateRtRelation(getDriftTimeSpectrum(),m_radius / 1000.0)));
+	}
+	return *m_rtRel;
 }
 
 /**
  * Getter method for the triggering efficiency of the tube. This value describes the rate of events with a voltage undershooting a given threshold
  * (voltages are negative) over the number of totally triggered events. Ensured to be between zero and one IF (and only if) the DataSet stored in this
- * Drifttube object contains any valid Events.
+ * Drifttube object contains any valid Events. Computed from the event counts of the DataSet, neither the drift time spectrum
+ * nor the rt-relation are needed.
  *
  * @brief triggering efficiency getter
  *
@@ -186,6 +203,12 @@ const RtRelation& Drifttube::getRtRelation() const
  */
 const double Drifttube::getEfficiency() const
 {
+	if(!m_efficiency_valid)
+	{
+		unsigned int numberOfRealEvents = m_data->getSize() - m_data->getRejected();
+		m_efficiency = numberOfRealEvents/(double)m_data->getSize();
+		m_efficiency_valid = true;
+	}
 	return m_efficiency;
 }
 
@@ -201,13 +224,44 @@ const double Drifttube::getEfficiency() const
  * @version Alpha 2.0
  *
  *
- * @return Maximum drift time (ns)
+ * @return Maximum drift time (ns), 0 if the radius is never reached
  */
 const double Drifttube::getMaxDrifttime() const
 {
+	if(!m_max_drifttime_valid)
+	{
+		const RtRelation& rtRel = getRtRelation();
+		const double radius = m_radius / 1000.0;
+		const size_t bin = rtRel.findBin(radius - radius * 0.0005);
+		m_max_drifttime = bin < rtRel.getSize() ? bin * AnalysisConfig::current().getSpectrumBinWidth() : 0;
+		m_max_drifttime_valid = true;
+	}
 	return m_max_drifttime;
 }
 
+/**
+ * Returns the leading (t0) and trailing (tmax) edge of the drift time spectrum, fitted with the model set by the key
+ * edgefit of the current AnalysisConfig, see EdgeFitter. Unlike getMaxDrifttime(), the times come with errors.
+ *
+ * @brief Getter for the fitted t0 and tmax
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @return Fitted edges in ns, not valid if the fit failed
+ */
+const DriftTimeEdges& Drifttube::getDriftTimeEdges() const
+{
+	if(!m_edges_valid)
+	{
+		const AnalysisConfig& config = AnalysisConfig::current();
+		m_edges = EdgeFitter(config.getEdgeModel()).fit(getDriftTimeSpectrum(),config.getSpectrumBinWidth());
+		m_edges_valid = true;
+	}
+	return m_edges;
+}
+
 
 /**
  * Getter method for the stored DataSet. The DataSet contains all the triggered Events that themselves contain every stored waveform.
@@ -225,11 +279,103 @@ const DataSet& Drifttube::getDataSet() const
 	return *m_data;
 }
 
+/**
+ * Adds an Event to the DataSet of this Drifttube. The DataSet updates its statistics in constant time, the cached results of
+ * this Drifttube are dropped and rebuilt from those statistics in O(bins) on the next request. If the DataSet is shared with
+ * copies of this Drifttube, it is copied before the Event is added.
+ *
+ * @brief Add an Event
+ *
+ * @author Stefan Bieschke
+ * @version 1.0
+ * @date Oct. 18, 2026
+ *
+ * @param event Event to add, nullptr for a rejected (zero suppressed) Event
+ */
+void Drifttube::addEvent(unique_ptr<Event> event)
+{
+	//copy on write - other Drifttubes still see the unchanged DataSet
+	if(m_data.use_count() > 1)
+	{
+		m_data = make_shared<DataSet>(*m_data);
+	}
+	m_data->addData(move(event));
+	invalidate();
+}
 
-//TODO test
 /**
- * Assignment operator allowing to write Drifttube a = Drifttube(...); In this case, the DataSet from the rhs is MOVED to the lhs without copying.
- * Thus, after this operation, rhs is empty. Good for temporary rvalues.
+ * Drops all cached results of this Drifttube. They are recomputed from the DataSet the next time they are requested.
+ *
+ * @brief Invalidate cached results
+ *
+ * @author Stefan Bieschke
+ * @version 1.0
+ * @date Oct. 18, 2026
+ */
+void Drifttube::invalidate()
+{
+	m_dtSpect.reset();
+	m_rtRel.reset();
+	m_efficiency = 0;
+	m_efficiency_valid = false;
+	m_max_drifttime = 0;
+	m_max_drifttime_valid = false;
+	m_edges = {{0,0,0,0,0},{0,0,0,0,0}};
+	m_edges_valid = false;
+}
+
+/**
+ * Copies the cached results of another Drifttube into this one. Results, that were not yet computed for the original,
+ * are not computed for this Drifttube either.
+ *
+ * @brief Copy cached results
+ *
+ * @author Stefan Bieschke
+ * @version 1.0
+ * @date Oct. 18, 2026
+ *
+ * @param original Drifttube whose cached results are copied
+ */
+void Drifttube::copyCache(const Drifttube& original)
+{
+	m_dtSpect.reset(original.m_dtSpect ? new DriftTimeSpectrum(*original.m_dtSpect) : nullptr);
+	m_rtRel.reset(original.m_rtRel ? new RtRelation(*original.m_rtRel) : nullptr);
+	m_efficiency = original.m_efficiency;
+	m_efficiency_valid = original.m_efficiency_valid;
+	m_max_drifttime = original.m_max_drifttime;
+	m_max_drifttime_valid = original.m_max_drifttime_valid;
+	m_edges = original.m_edges;
+	m_edges_valid = original.m_edges_valid;
+}
+
+/**
+ * Takes over the cached results of another Drifttube without copying them. The cache of the original is empty afterwards.
+ *
+ * @brief Move cached results
+ *
+ * @author Stefan Bieschke
+ * @version 1.0
+ * @date Oct. 18, 2026
+ *
+ * @param original Drifttube whose cached results are moved
+ */
+void Drifttube::moveCache(Drifttube& original)
+{
+	m_dtSpect = move(original.m_dtSpect);
+	m_rtRel = move(original.m_rtRel);
+	m_efficiency = original.m_efficiency;
+	m_efficiency_valid = original.m_efficiency_valid;
+	m_max_drifttime = original.m_max_drifttime;
+	m_max_drifttime_valid = original.m_max_drifttime_valid;
+	m_edges = original.m_edges;
+	m_edges_valid = original.m_edges_valid;
+	original.invalidate();
+}
+
+
+/**
+ * Assignment operator. After this operation, lhs shares the DataSet of rhs, no Event is copied. Results that have already been
+ * computed for rhs are copied as well.
  *
  * @author Stefan Bieschke
  * @version Alpha 2.0
@@ -241,20 +387,20 @@ const DataSet& Drifttube::getDataSet() const
  */
 Drifttube& Drifttube::operator=(const Drifttube& rhs)
 {
-	m_dtSpect = rhs.m_dtSpect;
-	m_rtRel = rhs.m_rtRel;
-	//TODO check below
-	//move dataset: Update - cannot work with const param... d'oh
-//	m_data.reset(rhs.m_data.get());
-	m_data = unique_ptr<DataSet>(new DataSet(*rhs.m_data));
-	m_efficiency = rhs.m_efficiency;
-	m_position = rhs.m_position;
+	if(this != &rhs)
+	{
+		m_data = rhs.m_data;
+		m_radius = rhs.m_radius;
+		m_position = rhs.m_position;
+		copyCache(rhs);
+	}
 
 	return *this;
 }
 
 /**
- * Assignment operator with non-constant rvalue. This operator needs a non-temporary rvalue. After completion, lvalue holds a copy of rvalue.
+ * Assignment operator with non-constant rvalue. This operator needs a non-temporary rvalue. After completion, lvalue shares the
+ * DataSet of rvalue and holds copies of its cached results.
  *
  * @brief Assignment operator
  *
@@ -267,12 +413,31 @@ Drifttube& Drifttube::operator=(const Drifttube& rhs)
  */
 Drifttube& Drifttube::operator=(Drifttube& rhs)
 {
-	m_dtSpect = rhs.m_dtSpect;
-	m_rtRel = rhs.m_rtRel;
-	//copy dataset
-	m_data = unique_ptr<DataSet>(new DataSet(*rhs.m_data));
-	m_efficiency = rhs.m_efficiency;
-	m_position = rhs.m_position;
+	return operator=(const_cast<const Drifttube&>(rhs));
+}
+
+/**
+ * Move assignment operator allowing to write Drifttube a = Drifttube(...); The DataSet and the cached results of rhs are moved to
+ * lhs without copying. Thus, after this operation, rhs is empty. Good for temporary rvalues.
+ *
+ * @brief Move assignment operator
+ *
+ * @author Stefan Bieschke
+ * @version 1.0
+ * @date Oct. 18, 2026
+ *
+ * @param rhs rvalue reference to the right hand side value
+ * @return Reference to the bound object
+ */
+Drifttube& Drifttube::operator=(Drifttube&& rhs)
+{
+	if(this != &rhs)
+	{
+		m_data = move(rhs.m_data);
+		m_radius = rhs.m_radius;
+		m_position = rhs.m_position;
+		moveCache(rhs);
+	}
 
 	return *this;
 }
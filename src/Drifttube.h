@@ -14,6 +14,9 @@
 #include "DataProcessor.h"
 #include "DriftTimeSpectrum.h"
 #include "RtRelation.h"
+#include "EdgeFitter.h"
+#include "globals.h"
+#include "AnalysisConfig.h"
 
 #include <iostream>
 
@@ -21,6 +24,11 @@
 /**
  * Basic implementation of a drifttube. This contains the coordinates of the drift tube as well as
  * a DataSet object containing its raw data.
+ * Derived results (drift time spectrum, rt-relation, efficiency, maximum drift time and the fitted edges of the drift time spectrum) are computed on first
+ * access and cached afterwards. Use invalidate() to drop the cached results.
+ * The DataSet is reference counted and never changed while it is shared, so copies of a Drifttube share their DataSet
+ * and copying a Drifttube does not copy any Event. Adding an Event to a Drifttube that shares its DataSet copies the
+ * DataSet first (copy on write).
  *
  * @brief Representation of a tube detector.
  *
@@ -31,33 +39,47 @@
 class Drifttube
 {
 public:
-	Drifttube(const int posX, const int posY, unique_ptr<DataSet> data);
+	Drifttube(const double posX, const double posY, unique_ptr<DataSet> data, const double radius = AnalysisConfig::current().getTubeRadius());
 	Drifttube(const Drifttube& original);
+	Drifttube(Drifttube&& original);
 	~Drifttube();
 
 	const unsigned int getRadius() const;
-	const int getPositionX() const;
-	const int getPositionY() const;
-	const std::array<int,2>& getPosition() const;
+	const double getPositionX() const;
+	const double getPositionY() const;
+	const std::array<double,2>& getPosition() const;
 
 	const DriftTimeSpectrum& getDriftTimeSpectrum() const;
 	const RtRelation& getRtRelation() const;
 	const double getEfficiency() const;
 	const double getMaxDrifttime() const;
+	const DriftTimeEdges& getDriftTimeEdges() const;
 
 	const DataSet& getDataSet() const;
 
+	void addEvent(std::unique_ptr<Event> event);
+	void invalidate();
+
 	Drifttube& operator=(const Drifttube& rhs);
 	Drifttube& operator=(Drifttube& rhs);
+	Drifttube& operator=(Drifttube&& rhs);
 
 private:
-	const unsigned int m_radius = 18150; //micron
-	std::array<int,2> m_position;
-	std::unique_ptr<DataSet> m_data;
-	DriftTimeSpectrum m_dtSpect;
-	RtRelation m_rtRel;
-	double m_efficiency;
-	double m_max_drifttime; //ns - defined as the drift time where 99.95% of the tube's radius is reached in rtRelation
+	void copyCache(const Drifttube& original);
+	void moveCache(Drifttube& original);
+
+	unsigned int m_radius; //micron
+	std::array<double,2> m_position; //mm
+	std::shared_ptr<DataSet> m_data; //shared between copies, must not be changed while m_data.use_count() > 1
+	//lazily computed results, nullptr or flag false as long as not computed
+	mutable std::unique_ptr<DriftTimeSpectrum> m_dtSpect;
+	mutable std::unique_ptr<RtRelation> m_rtRel;
+	mutable double m_efficiency;
+	mutable bool m_efficiency_valid;
+	mutable double m_max_drifttime; //ns - defined as the drift time where 99.95% of the tube's radius is reached in rtRelation
+	mutable bool m_max_drifttime_valid;
+	mutable DriftTimeEdges m_edges; //fitted t0 and tmax
+	mutable bool m_edges_valid;
 };
 
 #endif /* DRIFTTUBE_H_ */
@@ -0,0 +1,478 @@
+/*
+ * EdgeFitter.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "EdgeFitter.h"
+#include "DriftTimeSpectrum.h"
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Inverts a small symmetric matrix in place by Gauss-Jordan elimination with partial pivoting.
+ *
+ * @param matrix n x n matrix in row major order, replaced by its inverse
+ * @param n Dimension, at most 4
+ * @return False if the matrix is singular
+ */
+static bool invert(double* matrix, const size_t n)
+{
+	double augmented[4][8];
+	for(size_t i = 0; i < n; ++i)
+	{
+		for(size_t j = 0; j < n; ++j)
+		{
+			augmented[i][j] = matrix[i * n + j];
+			augmented[i][n + j] = i == j ? 1 : 0;
+		}
+	}
+	for(size_t column = 0; column < n; ++column)
+	{
+		size_t pivot = column;
+		for(size_t row = column + 1; row < n; ++row)
+		{
+			pivot = fabs(augmented[row][column]) > fabs(augmented[pivot][column]) ? row : pivot;
+		}
+		if(!(fabs(augmented[pivot][column]) > 1e-300))
+		{
+			return false;
+		}
+		for(size_t j = 0; j < 2 * n; ++j)
+		{
+			swap(augmented[column][j],augmented[pivot][j]);
+		}
+		const double norm = 1 / augmented[column][column];
+		for(size_t j = 0; j < 2 * n; ++j)
+		{
+			augmented[column][j] *= norm;
+		}
+		for(size_t row = 0; row < n; ++row)
+		{
+			if(row == column)
+			{
+				continue;
+			}
+			const double factor = augmented[row][column];
+			for(size_t j = 0; j < 2 * n; ++j)
+			{
+				augmented[row][j] -= factor * augmented[column][j];
+			}
+		}
+	}
+	for(size_t i = 0; i < n; ++i)
+	{
+		for(size_t j = 0; j < n; ++j)
+		{
+			matrix[i * n + j] = augmented[i][n + j];
+		}
+	}
+	return true;
+}
+
+/**
+ * Fermi function of an edge and its gradient with respect to the parameters.
+ *
+ * @param p Parameters: level beside the edge, height, time and width
+ * @param t Time
+ * @param sign 1 for a leading, -1 for a trailing edge
+ * @param gradient Set to the derivatives with respect to p, if not nullptr
+ * @return Value of the function
+ */
+static double fermi(const double* p, const double t, const double sign, double* gradient)
+{
+	double argument = -sign * (t - p[2]) / p[3];
+	argument = argument > 50 ? 50 : (argument < -50 ? -50 : argument);
+	const double e = exp(argument);
+	const double g = 1 / (1 + e);
+	if(gradient)
+	{
+		const double dt = -p[1] * g * g * e * sign / p[3];
+		gradient[0] = 1;
+		gradient[1] = g;
+		gradient[2] = dt;
+		gradient[3] = dt * (t - p[2]) / p[3];
+	}
+	return p[0] + p[1] * g;
+}
+
+/**
+ * Constructor.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param model One of Model
+ *
+ * @throw invalid_argument for an unknown model
+ */
+EdgeFitter::EdgeFitter(const uint8_t model)
+{
+	if(model > LINEAR)
+	{
+		throw invalid_argument("EdgeFitter: unknown model");
+	}
+	m_model = model;
+}
+
+EdgeFitter::~EdgeFitter()
+{
+}
+
+/**
+ * Fits the edges of a drift time spectrum, see fit(const vector<double>&, const double).
+ *
+ * @brief Fit t0 and tmax
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param spectrum The drift time spectrum
+ * @param binWidth Width of a bin of the spectrum in ns
+ * @return Leading and trailing edge
+ */
+DriftTimeEdges EdgeFitter::fit(const DriftTimeSpectrum& spectrum, const double binWidth) const
+{
+	vector<double> contents(spectrum.getSize());
+	for(size_t i = 0; i < contents.size(); ++i)
+	{
+		contents[i] = spectrum[i];
+	}
+	return fit(contents,binWidth);
+}
+
+/**
+ * Fits the edges of a spectrum, see the class description. Bin i is at the time i * binWidth.
+ *
+ * @brief Fit t0 and tmax
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param spectrum Contents of the bins
+ * @param binWidth Width of a bin in ns
+ * @return Leading and trailing edge, not valid if the spectrum is empty or a fit did not converge
+ */
+DriftTimeEdges EdgeFitter::fit(const vector<double>& spectrum, const double binWidth) const
+{
+	DriftTimeEdges edges = {{0,0,0,0,0},{0,0,0,0,0}};
+	const size_t n = spectrum.size();
+	if(n < 8)
+	{
+		return edges;
+	}
+	vector<double> smoothed(n);
+	double maximum = 0;
+	for(size_t i = 0; i < n; ++i)
+	{
+		const double left = spectrum[i > 0 ? i - 1 : i];
+		const double right = spectrum[i + 1 < n ? i + 1 : i];
+		smoothed[i] = (left + spectrum[i] + right) / 3;
+		maximum = smoothed[i] > maximum ? smoothed[i] : maximum;
+	}
+	if(maximum <= 0)
+	{
+		return edges;
+	}
+	size_t leading = 0;
+	while(smoothed[leading] < maximum / 2)
+	{
+		++leading;
+	}
+	size_t trailing = n - 1;
+	while(smoothed[trailing] < maximum / 2)
+	{
+		--trailing;
+	}
+	const size_t half = (trailing - leading) / 8 > 3 ? (trailing - leading) / 8 : 3;
+	const size_t first[2] = {leading > 2 * half ? leading - 2 * half : 0, trailing > 2 * half ? trailing - 2 * half : 0};
+	const size_t last[2] = {leading + 2 * half < n ? leading + 2 * half : n - 1, trailing + 2 * half < n ? trailing + 2 * half : n - 1};
+	if(m_model == FERMI)
+	{
+		edges.leading = fitFermi(spectrum,binWidth,first[0],last[0],true);
+		edges.trailing = fitFermi(spectrum,binWidth,first[1],last[1],false);
+	}
+	else
+	{
+		edges.leading = fitLinear(spectrum,binWidth,first[0],last[0],true);
+		edges.trailing = fitLinear(spectrum,binWidth,first[1],last[1],false);
+	}
+	return edges;
+}
+
+/**
+ * Getter for the model.
+ *
+ * @brief Getter for the model
+ *
+ * @return One of Model
+ */
+uint8_t EdgeFitter::getModel() const
+{
+	return m_model;
+}
+
+/**
+ * Fits a Fermi function to one edge with Levenberg-Marquardt. The level beside the edge and the height are started at
+ * the mean of the two outermost bins of the window on either side, the time at the half height crossing. The width is
+ * kept above a quarter bin. Edges that are sharper than that do not determine the time within a bin, their error is
+ * the resolution of the binning, binWidth / sqrt(12).
+ *
+ * @param spectrum Contents of the bins
+ * @param binWidth Width of a bin in ns
+ * @param first First bin of the window
+ * @param last Last bin of the window
+ * @param leading True for the leading, false for the trailing edge
+ * @return The fit
+ */
+EdgeFit EdgeFitter::fitFermi(const vector<double>& spectrum, const double binWidth, const size_t first, const size_t last, const bool leading) const
+{
+	EdgeFit result = {0,0,0,0,0};
+	const size_t n = last - first + 1;
+	if(n < 6)
+	{
+		return result;
+	}
+	const double sign = leading ? 1 : -1;
+	double p[4];
+	findLevels(spectrum,first,last,leading,p[0],p[1]);
+	p[2] = findCrossing(spectrum,first,last,leading,p[0] + 0.5 * p[1]) * binWidth;
+	p[3] = binWidth;
+	const double minimumWidth = 0.25 * binWidth;
+
+	auto chiSquare = [&](const double* q)
+	{
+		double sum = 0;
+		for(size_t i = first; i <= last; ++i)
+		{
+			const double residual = spectrum[i] - fermi(q,i * binWidth,sign,nullptr);
+			sum += residual * residual / (spectrum[i] > 1 ? spectrum[i] : 1);
+		}
+		return sum;
+	};
+	double normal[16];
+	double gradient[4];
+	auto buildNormal = [&](double* rhs)
+	{
+		double derivatives[4];
+		for(size_t j = 0; j < 16; ++j)
+		{
+			normal[j] = 0;
+		}
+		for(size_t j = 0; j < 4; ++j)
+		{
+			rhs[j] = 0;
+		}
+		for(size_t i = first; i <= last; ++i)
+		{
+			const double weight = 1 / (spectrum[i] > 1 ? spectrum[i] : 1);
+			const double residual = spectrum[i] - fermi(p,i * binWidth,sign,derivatives);
+			for(size_t j = 0; j < 4; ++j)
+			{
+				rhs[j] += weight * derivatives[j] * residual;
+				for(size_t k = 0; k < 4; ++k)
+				{
+					normal[j * 4 + k] += weight * derivatives[j] * derivatives[k];
+				}
+			}
+		}
+	};
+
+	double chi2 = chiSquare(p);
+	double lambda = 1e-3;
+	bool converged = false;
+	for(int iteration = 0; iteration < 200 && !converged; ++iteration)
+	{
+		buildNormal(gradient);
+		bool improved = false;
+		while(!improved && lambda < 1e10)
+		{
+			double damped[16];
+			for(size_t j = 0; j < 16; ++j)
+			{
+				damped[j] = normal[j];
+			}
+			for(size_t j = 0; j < 4; ++j)
+			{
+				damped[j * 5] *= 1 + lambda;
+			}
+			if(!invert(damped,4))
+			{
+				return result;
+			}
+			double q[4];
+			for(size_t j = 0; j < 4; ++j)
+			{
+				q[j] = p[j];
+				for(size_t k = 0; k < 4; ++k)
+				{
+					q[j] += damped[j * 4 + k] * gradient[k];
+				}
+			}
+			q[3] = q[3] > minimumWidth ? q[3] : minimumWidth;
+			const double newChi2 = chiSquare(q);
+			if(newChi2 <= chi2)
+			{
+				converged = chi2 - newChi2 <= 1e-6 * chi2 + 1e-12;
+				for(size_t j = 0; j < 4; ++j)
+				{
+					p[j] = q[j];
+				}
+				chi2 = newChi2;
+				lambda /= 10;
+				improved = true;
+			}
+			else
+			{
+				lambda *= 10;
+			}
+		}
+		converged |= !improved;
+	}
+	const bool sharp = p[3] <= minimumWidth * (1 + 1e-6);
+	buildNormal(gradient);
+	if(!converged || (!sharp && (!invert(normal,4) || !(normal[10] >= 0))))
+	{
+		return result;
+	}
+	result.time = p[2];
+	result.error = sharp ? binWidth / sqrt(12) : sqrt(normal[10]);
+	result.width = p[3];
+	result.chi2 = chi2 / (n - 4);
+	result.valid = p[1] > 0 && p[2] >= first * binWidth && p[2] <= last * binWidth;
+	return result;
+}
+
+/**
+ * Fits a straight line to the contiguous bins of one edge between 20% and 80% of its height around the half height
+ * crossing, with the levels as for the Fermi fit. Sharper edges are fitted with the three bins around the crossing.
+ *
+ * @param spectrum Contents of the bins
+ * @param binWidth Width of a bin in ns
+ * @param first First bin of the window
+ * @param last Last bin of the window
+ * @param leading True for the leading, false for the trailing edge
+ * @return The fit
+ */
+EdgeFit EdgeFitter::fitLinear(const vector<double>& spectrum, const double binWidth, const size_t first, const size_t last, const bool leading) const
+{
+	EdgeFit result = {0,0,0,0,0};
+	double background, height;
+	findLevels(spectrum,first,last,leading,background,height);
+	if(!(height > 0))
+	{
+		return result;
+	}
+	//contiguous bins between 20% and 80% around the half height crossing
+	const double low = background + 0.2 * height;
+	const double high = background + 0.8 * height;
+	const size_t crossing = findCrossing(spectrum,first,last,leading,background + 0.5 * height);
+	size_t begin = crossing;
+	size_t end = crossing;
+	while(begin > first && spectrum[begin - 1] >= low && spectrum[begin - 1] <= high)
+	{
+		--begin;
+	}
+	while(end < last && spectrum[end + 1] >= low && spectrum[end + 1] <= high)
+	{
+		++end;
+	}
+	if(end - begin < 2)
+	{
+		begin = crossing > first ? crossing - 1 : first;
+		end = crossing < last ? crossing + 1 : last;
+	}
+	const size_t n = end - begin + 1;
+	double s = 0, st = 0, stt = 0, sy = 0, sty = 0;
+	for(size_t i = begin; i <= end; ++i)
+	{
+		const double weight = 1 / (spectrum[i] > 1 ? spectrum[i] : 1);
+		const double t = i * binWidth;
+		s += weight;
+		st += weight * t;
+		stt += weight * t * t;
+		sy += weight * spectrum[i];
+		sty += weight * t * spectrum[i];
+	}
+	const double det = s * stt - st * st;
+	if(n < 3 || !(det > 0))
+	{
+		return result;
+	}
+	const double slope = (s * sty - st * sy) / det;
+	const double intercept = (stt * sy - st * sty) / det;
+	if(leading ? !(slope > 0) : !(slope < 0))
+	{
+		return result;
+	}
+	double chi2 = 0;
+	for(size_t i = begin; i <= end; ++i)
+	{
+		const double residual = spectrum[i] - intercept - slope * i * binWidth;
+		chi2 += residual * residual / (spectrum[i] > 1 ? spectrum[i] : 1);
+	}
+	//t = (background - intercept) / slope with the covariance of intercept and slope
+	const double time = (background - intercept) / slope;
+	const double variance = (stt - 2 * time * st + time * time * s) / det;
+	result.time = time;
+	result.error = sqrt(variance / (slope * slope));
+	result.width = height / fabs(slope);
+	result.chi2 = chi2 / (n - 2);
+	result.valid = 1;
+	return result;
+}
+
+/**
+ * Levels on both sides of an edge, the means of the two outermost bins of the window.
+ *
+ * @param spectrum Contents of the bins
+ * @param first First bin of the window
+ * @param last Last bin of the window
+ * @param leading True for the leading, false for the trailing edge
+ * @param background Level beside the edge
+ * @param height Height of the edge above the background
+ */
+void EdgeFitter::findLevels(const vector<double>& spectrum, const size_t first, const size_t last, const bool leading, double& background, double& height)
+{
+	const double low = 0.5 * (spectrum[first] + spectrum[first + 1]);
+	const double high = 0.5 * (spectrum[last] + spectrum[last - 1]);
+	background = leading ? low : high;
+	height = (leading ? high : low) - background;
+}
+
+/**
+ * First bin from the side of the background, whose content reaches a level.
+ *
+ * @param spectrum Contents of the bins
+ * @param first First bin of the window
+ * @param last Last bin of the window
+ * @param leading True for the leading, false for the trailing edge
+ * @param level The level
+ * @return The bin, the last bin of the window on the plateau side if the level is never reached
+ */
+size_t EdgeFitter::findCrossing(const vector<double>& spectrum, const size_t first, const size_t last, const bool leading, const double level)
+{
+	if(leading)
+	{
+		size_t bin = first;
+		while(bin < last && spectrum[bin] < level)
+		{
+			++bin;
+		}
+		return bin;
+	}
+	size_t bin = last;
+	while(bin > first && spectrum[bin] < level)
+	{
+		--bin;
+	}
+	return bin;
+}
@@ -0,0 +1,90 @@
+/*
+ * EdgeFitter.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef EDGEFITTER_H_
+#define EDGEFITTER_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class DriftTimeSpectrum;
+
+/**
+ * Fit of one edge of a drift time spectrum.
+ *
+ * @brief Edge of a spectrum
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	double time; //ns
+	double error; //ns
+	double width; //ns
+	double chi2; //per degree of freedom
+	uint8_t valid; //1 if the fit converged, else 0
+} EdgeFit;
+
+/**
+ * Leading and trailing edge of a drift time spectrum.
+ *
+ * @brief Edges of a spectrum
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	EdgeFit leading; //t0
+	EdgeFit trailing; //tmax
+} DriftTimeEdges;
+
+/**
+ * Fits the leading edge (t0) and the trailing edge (tmax) of a drift time spectrum. The edges are found where the smoothed
+ * spectrum crosses half of its maximum. Each edge is fitted in a window around that crossing, whose size scales with the
+ * distance of the edges. Bins are weighted with their Poisson errors.
+ * - FERMI: b + A / (1 + exp(-(t - t0) / w)) for the leading and b + A / (1 + exp((t - tmax) / w)) for the trailing edge,
+ *   fitted with Levenberg-Marquardt. The time is the half height of the edge, the width is w.
+ * - LINEAR: a straight line through the bins between 20% and 80% of the edge height, like rootscripts/fitDtEnd.cpp. The
+ *   time is where the line reaches the level b beside the edge, the width is the time the line needs for the full height.
+ * The errors of the times are taken from the covariance of the fit. For edges sharper than a bin, the Fermi fit gives the
+ * resolution of the binning instead.
+ *
+ * @brief Fit of t0 and tmax
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+class EdgeFitter
+{
+public:
+	EdgeFitter(const uint8_t model = FERMI);
+	~EdgeFitter();
+
+	DriftTimeEdges fit(const DriftTimeSpectrum& spectrum, const double binWidth) const;
+	DriftTimeEdges fit(const std::vector<double>& spectrum, const double binWidth) const;
+
+	uint8_t getModel() const;
+
+	enum Model : uint8_t {FERMI, LINEAR};
+
+private:
+	EdgeFit fitFermi(const std::vector<double>& spectrum, const double binWidth, const size_t first, const size_t last, const bool leading) const;
+	EdgeFit fitLinear(const std::vector<double>& spectrum, const double binWidth, const size_t first, const size_t last, const bool leading) const;
+
+	static size_t findCrossing(const std::vector<double>& spectrum, const size_t first, const size_t last, const bool leading, const double level);
+	static void findLevels(const std::vector<double>& spectrum, const size_t first, const size_t last, const bool leading, double& background, double& height);
+
+	uint8_t m_model; //one of Model
+};
+
+#endif /* EDGEFITTER_H_ */
@@ -11,6 +11,17 @@ using namespace std;
 
 //TODO Change all doc to vector and variable length (Nov. 14, 2018)
 
+/**
+ * Allocator for the samples of a new Event. The samples go to the current MemoryArena of the thread, which is the arena
+ * the Event itself is placed in by operator new, or to the heap if there is none.
+ *
+ * @return Allocator for the samples
+ */
+static inline ArenaAllocator<uint16_t> currentAllocator()
+{
+	return ArenaAllocator<uint16_t>(MemoryArena::current());
+}
+
 /**
  * Constructor
  *
@@ -23,11 +34,88 @@ using namespace std;
  * @param eventNumber number of the event
  * @param data Data that should be stored
  */
-Event::Event(unsigned int eventNumber, unique_ptr<vector<uint16_t>> data) : Data(move(data))
+Event::Event(unsigned int eventNumber, unique_ptr<vector<uint16_t>> data) : Data(data->data(),data->data() + data->size(),currentAllocator())
 {
 	m_event_number = eventNumber;
 	//TODO rework where and when to calculate this
-	m_drift_time = ADC_BINS_TO_TIME * DataProcessor::findDriftTimeBin(*this,ABSOLUTE_OFFSET_ZERO_VOLTAGE+ABSOLUTE_EVENT_THRESHOLD_VOLTAGE);
+	const AnalysisConfig& config = AnalysisConfig::current();
+	DataProcessor::estimateBaseline(getData().data(),getSize(),config,m_baseline,m_noise);
+	const uint16_t threshold = config.getAbsoluteThreshold(m_baseline,m_noise);
+	short driftTimeBin = config.isNegative() ? DataProcessor::findDriftTimeBin<true>(getData().data(),getSize(),threshold)
+			: DataProcessor::findDriftTimeBin<false>(getData().data(),getSize(),threshold);
+	m_drift_time = config.getBinsToTime() * DataProcessor::refineDriftTimeBin(getData().data(),getSize(),driftTimeBin,threshold,m_baseline,config);
+}
+
+/**
+ * Constructor for an Event whose drift time bin has already been found, e.g. while reading the raw data. This does not
+ * search the data again.
+ *
+ * @brief ctor with known drift time bin
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param eventNumber number of the event
+ * @param data Data that should be stored
+ * @param driftTimeBin bin of the drift time as found by DataProcessor::findDriftTimeBin(...)
+ */
+Event::Event(unsigned int eventNumber, unique_ptr<vector<uint16_t>> data, const short driftTimeBin) : Data(data->data(),data->data() + data->size(),currentAllocator())
+{
+	m_event_number = eventNumber;
+	m_drift_time = AnalysisConfig::current().getBinsToTime() * driftTimeBin;
+	m_baseline = AnalysisConfig::current().getOffset();
+	m_noise = 0;
+}
+
+/**
+ * Constructor for an Event whose drift time bin, baseline and noise have already been found while reading the raw data.
+ *
+ * @brief ctor with known drift time bin and baseline
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param eventNumber number of the event
+ * @param data Data that should be stored
+ * @param driftTimeBin bin of the drift time as found by DataProcessor::findDriftTimeBin(...), with sub-bin resolution
+ * if refined by DataProcessor::refineDriftTimeBin(...)
+ * @param baseline baseline in FADC units, see DataProcessor::estimateBaseline(...)
+ * @param noise noise RMS in FADC units
+ */
+Event::Event(unsigned int eventNumber, unique_ptr<vector<uint16_t>> data, const float driftTimeBin, const float baseline, const float noise) : Data(data->data(),data->data() + data->size(),currentAllocator())
+{
+	m_event_number = eventNumber;
+	m_drift_time = AnalysisConfig::current().getBinsToTime() * driftTimeBin;
+	m_baseline = baseline;
+	m_noise = noise;
+}
+
+/**
+ * Constructor for an Event that copies its samples from a buffer of raw data, e.g. a chunk read by the Archive. Drift time
+ * bin, baseline and noise have already been found while reading.
+ *
+ * @brief ctor from a buffer with known drift time bin and baseline
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param eventNumber number of the event
+ * @param samples Pointer to the first sample of the event
+ * @param size Number of samples
+ * @param driftTimeBin bin of the drift time, with sub-bin resolution if refined by DataProcessor::refineDriftTimeBin(...)
+ * @param baseline baseline in FADC units, see DataProcessor::estimateBaseline(...)
+ * @param noise noise RMS in FADC units
+ */
+Event::Event(unsigned int eventNumber, const uint16_t* samples, const size_t size, const float driftTimeBin, const float baseline,
+		const float noise) : Data(samples,samples + size,currentAllocator())
+{
+	m_event_number = eventNumber;
+	m_drift_time = AnalysisConfig::current().getBinsToTime() * driftTimeBin;
+	m_baseline = baseline;
+	m_noise = noise;
 }
 
 Event::~Event()
@@ -37,7 +125,7 @@ Event::~Event()
 
 
 /**
- * Copy constructor
+ * Copy constructor. The samples of the copy are placed like the copy itself, in the current MemoryArena or on the heap.
  *
  * @author Stefan Bieschke
  * @date May 16, 2017
@@ -45,10 +133,12 @@ Event::~Event()
  *
  * @param original Event that shall be copied
  */
-Event::Event(const Event& original) : Data(original)
+Event::Event(const Event& original) : Data(original,currentAllocator())
 {
 	m_event_number = original.m_event_number;
 	m_drift_time = original.m_drift_time;
+	m_baseline = original.m_baseline;
+	m_noise = original.m_noise;
 }
 
 /**
@@ -79,6 +169,53 @@ const double Event::getDriftTime() const
 	return m_drift_time;
 }
 
+/**
+ * Getter method for the baseline of the event, the mean of its pre-trigger samples or the offset.
+ *
+ * @brief Getter for the baseline
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @return Baseline in FADC units
+ */
+float Event::getBaseline() const
+{
+	return m_baseline;
+}
+
+/**
+ * Getter method for the noise of the event, the RMS of its pre-trigger samples around the baseline.
+ *
+ * @brief Getter for the noise
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @return Noise RMS in FADC units, 0 if no baseline was estimated
+ */
+float Event::getNoise() const
+{
+	return m_noise;
+}
+
+/**
+ * Getter method for the threshold of the event with the current AnalysisConfig, relative to the baseline of the event.
+ *
+ * @brief Getter for the threshold
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @return Threshold in FADC units, see AnalysisConfig::getAbsoluteThreshold(...)
+ */
+uint16_t Event::getThreshold() const
+{
+	return AnalysisConfig::current().getAbsoluteThreshold(m_baseline,m_noise);
+}
 
 /**
  * Assignment operator. The Event object on the right hand side (rhs) gets assigned to the left hand side (lhs) Event object. Due to the
@@ -98,6 +235,43 @@ Event& Event::operator=(const Event& rhs)
 	Data::operator=(rhs);
 	m_event_number = rhs.m_event_number;
 	m_drift_time = rhs.m_drift_time;
+	m_baseline = rhs.m_baseline;
+	m_noise = rhs.m_noise;
 
 	return *this;
 }
+
+/**
+ * Allocation function for Events. If the allocating thread has a current MemoryArena (see MemoryArena::Scope), the Event is
+ * placed in that arena, otherwise on the heap.
+ *
+ * @brief operator new
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param size Size of the Event object in bytes
+ * @return Pointer to memory for the Event
+ */
+void* Event::operator new(size_t size)
+{
+	return MemoryArena::allocateTagged(size);
+}
+
+/**
+ * Deallocation function for Events. Heap memory is freed, memory of Events in a MemoryArena is given back together with
+ * the whole arena.
+ *
+ * @brief operator delete
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param ptr Pointer to the Event
+ */
+void Event::operator delete(void* ptr)
+{
+	MemoryArena::deallocateTagged(ptr);
+}
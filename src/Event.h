@@ -16,14 +16,23 @@ class DataProcessor;
 #include <cstdlib>
 #include "Data.h"
 #include "DataProcessor.h"
+#include "MemoryArena.h"
 #include "globals.h"
+#include "AnalysisConfig.h"
 
 //TODO Change all doc to vector and variable length (Nov. 14, 2018)
 
+//samples of an Event, placed in the MemoryArena of the Event if it has one
+typedef std::vector<uint16_t,ArenaAllocator<uint16_t>> EventSamples;
+
 /**
  * Class that represents the data for one event.
  * This is basically a wrapper class for a @c std::array. It contains an @c array and an  @c int which holds the number of the event. So for the third
  * triggered event of the detector, the event number will be 2, as counting starts at zero
+ * Events created while a MemoryArena::Scope is active are placed in that arena, together with their samples. Destroying
+ * them frees nothing, the memory is given back at once with the arena. Such Events must not outlive the arena.
+ * Every Event has a baseline and a noise RMS, estimated from its first samples if the AnalysisConfig has baseline bins,
+ * otherwise the offset and 0. Thresholds of the Event are relative to its baseline.
  *
  * @brief Event class
  *
@@ -31,21 +40,32 @@ class DataProcessor;
  * @version 0.1
  * @date May 15, 2017
  */
-class Event : public Data<>
+class Event : public Data<uint16_t,ArenaAllocator<uint16_t>>
 {
 public:
 	Event(const unsigned int eventNumber, std::unique_ptr<std::vector<uint16_t>> data);
+	Event(const unsigned int eventNumber, std::unique_ptr<std::vector<uint16_t>> data, const short driftTimeBin);
+	Event(const unsigned int eventNumber, std::unique_ptr<std::vector<uint16_t>> data, const float driftTimeBin, const float baseline, const float noise);
+	Event(const unsigned int eventNumber, const uint16_t* samples, const size_t size, const float driftTimeBin, const float baseline, const float noise);
 	virtual ~Event();
 	Event(const Event& original);
 
 	const unsigned int getEventNumber() const;
 	const double getDriftTime() const;
+	float getBaseline() const;
+	float getNoise() const;
+	uint16_t getThreshold() const;
 
 	Event& operator=(const Event& rhs);
 
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr);
+
 private:
 	unsigned int m_event_number;
 	double m_drift_time;
+	float m_baseline;
+	float m_noise;
 };
 
 #endif /* EVENT_H_ */
@@ -6,13 +6,908 @@
  */
 
 #include "EventFinder.h"
+#include "EventIndex.h"
+#include "DataPresenceException.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <sstream>
 
-EventFinder::EventFinder()
+using namespace std;
+
+//names of the feature columns, in the order of m_features
+static const char* FEATURE_NAMES[] = {"drifttime", "amplitude", "npulses", "tot", "signalend", "minimumpos", "integralmin",
+		"integralminpos", "saturated"};
+static const size_t N_FEATURES = 9;
+
+/**
+ * Splits an expression into numbers, names, operators and parentheses.
+ *
+ * @param expression The expression
+ * @return The tokens
+ *
+ * @throw invalid_argument if the expression contains an unknown character
+ */
+static vector<string> tokenize(const string& expression)
 {
+	vector<string> tokens;
+	size_t i = 0;
+	while(i < expression.size())
+	{
+		const char c = expression[i];
+		//the character classification is undefined for negative char values
+		const unsigned char u = c;
+		if(isspace(u))
+		{
+			++i;
+		}
+		else if(isalpha(u) || c == '_')
+		{
+			size_t start = i;
+			while(i < expression.size() && (isalnum((unsigned char)expression[i]) || expression[i] == '_'))
+			{
+				++i;
+			}
+			tokens.push_back(expression.substr(start,i - start));
+		}
+		else if(isdigit(u) || c == '.' || c == '-')
+		{
+			const char* start = expression.c_str() + i;
+			char* end;
+			strtod(start,&end);
+			if(end == start)
+			{
+				throw invalid_argument("EventFinder: unexpected '" + string(1,c) + "'");
+			}
+			tokens.push_back(string(start,(const char*)end));
+			i += end - start;
+		}
+		else if(expression.compare(i,2,"&&") == 0 || expression.compare(i,2,"||") == 0 || expression.compare(i,2,"<=") == 0
+				|| expression.compare(i,2,">=") == 0 || expression.compare(i,2,"==") == 0 || expression.compare(i,2,"!=") == 0)
+		{
+			tokens.push_back(expression.substr(i,2));
+			i += 2;
+		}
+		else if(c == '<' || c == '>' || c == '!' || c == '(' || c == ')')
+		{
+			tokens.push_back(string(1,c));
+			++i;
+		}
+		else
+		{
+			throw invalid_argument("EventFinder: unexpected '" + string(1,c) + "'");
+		}
+	}
+	return tokens;
+}
+
+/**
+ * Recursive descent parser, that emits the instructions in postfix order. The grammar is
+ * @code
+ * or         := and ("||" and)*
+ * and        := unary ("&&" unary)*
+ * unary      := "!" unary | "(" or ")" | comparison
+ * comparison := feature ("<" | "<=" | ">" | ">=" | "==" | "!=") number
+ * @endcode
+ */
+class SelectionParser
+{
+public:
+	SelectionParser(const vector<string>& tokens, vector<SelectionInstruction>& plan) : m_tokens(tokens), m_plan(plan), m_position(0)
+	{
+	}
+
+	void parse()
+	{
+		parseOr();
+		if(m_position != m_tokens.size())
+		{
+			throw invalid_argument("EventFinder: unexpected '" + m_tokens[m_position] + "'");
+		}
+	}
+
+private:
+	const string& peek() const
+	{
+		static const string end;
+		return m_position < m_tokens.size() ? m_tokens[m_position] : end;
+	}
+
+	const string& next()
+	{
+		if(m_position >= m_tokens.size())
+		{
+			throw invalid_argument("EventFinder: unexpected end of expression");
+		}
+		return m_tokens[m_position++];
+	}
+
+	void emit(const uint8_t opcode, const uint8_t feature = 0, const float value = 0)
+	{
+		SelectionInstruction instruction = {opcode, feature, value};
+		m_plan.push_back(instruction);
+	}
+
+	void parseOr()
+	{
+		parseAnd();
+		while(peek() == "||")
+		{
+			next();
+			parseAnd();
+			emit(EventFinder::OR);
+		}
+	}
+
+	void parseAnd()
+	{
+		parseUnary();
+		while(peek() == "&&")
+		{
+			next();
+			parseUnary();
+			emit(EventFinder::AND);
+		}
+	}
+
+	void parseUnary()
+	{
+		if(peek() == "!")
+		{
+			next();
+			parseUnary();
+			emit(EventFinder::NOT);
+		}
+		else if(peek() == "(")
+		{
+			next();
+			parseOr();
+			if(next() != ")")
+			{
+				throw invalid_argument("EventFinder: missing ')'");
+			}
+		}
+		else
+		{
+			parseComparison();
+		}
+	}
+
+	void parseComparison()
+	{
+		const string& name = next();
+		size_t feature = 0;
+		while(feature < N_FEATURES && name != FEATURE_NAMES[feature])
+		{
+			++feature;
+		}
+		if(feature == N_FEATURES)
+		{
+			throw invalid_argument("EventFinder: unknown feature '" + name + "'");
+		}
+
+		const string& comparison = next();
+		uint8_t opcode;
+		if(comparison == "<") opcode = EventFinder::LESS;
+		else if(comparison == "<=") opcode = EventFinder::LESS_EQUAL;
+		else if(comparison == ">") opcode = EventFinder::GREATER;
+		else if(comparison == ">=") opcode = EventFinder::GREATER_EQUAL;
+		else if(comparison == "==") opcode = EventFinder::EQUAL;
+		else if(comparison == "!=") opcode = EventFinder::NOT_EQUAL;
+		else throw invalid_argument("EventFinder: expected comparison instead of '" + comparison + "'");
+
+		const string& number = next();
+		char* end;
+		float value = strtof(number.c_str(),&end);
+		if(number.empty() || *end != '\0')
+		{
+			throw invalid_argument("EventFinder: expected number instead of '" + number + "'");
+		}
+		emit(opcode,feature,value);
+	}
+
+	const vector<string>& m_tokens;
+	vector<SelectionInstruction>& m_plan;
+	size_t m_position;
+};
 
+/**
+ * Constructor. Computes the feature columns of all events of the DataSet in parallel.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data DataSet to select from, must outlive the EventFinder
+ */
+EventFinder::EventFinder(const DataSet& data) : m_data(data)
+{
+	computeFeatures();
+}
+
+/**
+ * Constructor with an index file, usually EventIndex::filename(...) of the data file and the tube. If the file holds an
+ * index of the same features (see getFingerprint()), that index is used. Otherwise the index is built and written to the
+ * file, so that the next run with the same data and configuration loads it. If the file cannot be written, the index is
+ * used for this EventFinder only.
+ *
+ * @brief ctor with an index file
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data DataSet to select from, must outlive the EventFinder
+ * @param indexFilename Path to the index file
+ */
+EventFinder::EventFinder(const DataSet& data, const string& indexFilename) : m_data(data)
+{
+	computeFeatures();
+	try
+	{
+		if(setIndex(make_shared<EventIndex>(EventIndex::load(indexFilename))))
+		{
+			return;
+		}
+	}
+	catch(DataPresenceException& e)
+	{
+		//no index file yet
+	}
+	shared_ptr<EventIndex> index = make_shared<EventIndex>(*this);
+	setIndex(index);
+	try
+	{
+		index->save(indexFilename);
+	}
+	catch(DataPresenceException& e)
+	{
+		//e.g. a read only directory, the index is rebuilt next time
+	}
 }
 
 EventFinder::~EventFinder()
 {
 }
 
+/**
+ * Compiles an expression into a selection plan, that can be passed to select(...) any number of times.
+ *
+ * @brief Compile an expression
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param expression Selection expression, see the class documentation
+ * @return Instructions in postfix order
+ *
+ * @throw invalid_argument if the expression is malformed or uses an unknown feature
+ */
+vector<SelectionInstruction> EventFinder::compile(const string& expression) const
+{
+	vector<string> tokens = tokenize(expression);
+	vector<SelectionInstruction> plan;
+	SelectionParser(tokens,plan).parse();
+	return plan;
+}
+
+/**
+ * Selects the events matching an expression, see select(const vector<SelectionInstruction>& plan).
+ *
+ * @brief Select events
+ *
+ * @param expression Selection expression, see the class documentation
+ * @return Bitmap, bit i % 64 of word i / 64 is set if event i matches
+ *
+ * @throw invalid_argument if the expression is malformed or uses an unknown feature
+ */
+vector<uint64_t> EventFinder::select(const string& expression) const
+{
+	return select(compile(expression));
+}
+
+/**
+ * Selects the events matching a compiled plan. Each block of BLOCK_SIZE events is evaluated on a stack of byte masks,
+ * comparisons and logical operations are single vectorised loops over the block. The result of the block is packed
+ * into the bitmap, blocks cover whole words so that the threads write disjoint parts of the bitmap.
+ *
+ * @brief Select events
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param plan Plan returned by compile(...)
+ * @return Bitmap, bit i % 64 of word i / 64 is set if event i matches
+ */
+vector<uint64_t> EventFinder::select(const vector<SelectionInstruction>& plan) const
+{
+	const size_t nEvents = getSize();
+	vector<uint64_t> bitmap((nEvents + 63) / 64,0);
+	//a valid plan never pops from an empty stack and leaves exactly one result
+	int depth = 0;
+	int maxDepth = 0;
+	for(const SelectionInstruction& instruction : plan)
+	{
+		if(instruction.opcode > NOT_EQUAL && depth < (instruction.opcode == NOT ? 1 : 2))
+		{
+			return bitmap;
+		}
+		depth += instruction.opcode <= NOT_EQUAL ? 1 : (instruction.opcode == NOT ? 0 : -1);
+		maxDepth = depth > maxDepth ? depth : maxDepth;
+	}
+	if(depth != 1)
+	{
+		return bitmap;
+	}
+	if(m_index && m_index->getSize() == nEvents && m_index->getNumberOfFeatures() == m_features.size()
+			&& (selectCandidates(plan,bitmap) || selectIndexed(plan,bitmap)))
+	{
+		return bitmap;
+	}
+
+	const long nBlocks = (nEvents + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	#pragma omp parallel
+	{
+		vector<uint8_t> stack(maxDepth * BLOCK_SIZE);
+
+		#pragma omp for schedule(static)
+		for(long block = 0; block < nBlocks; ++block)
+		{
+			const size_t first = block * BLOCK_SIZE;
+			const size_t count = nEvents - first < BLOCK_SIZE ? nEvents - first : BLOCK_SIZE;
+			size_t top = 0;
+			for(const SelectionInstruction& instruction : plan)
+			{
+				uint8_t* result = stack.data() + top * BLOCK_SIZE;
+				uint8_t* lhs = result - BLOCK_SIZE;
+				uint8_t* rhs = result - BLOCK_SIZE;
+				const float* column = instruction.opcode <= NOT_EQUAL ? m_features[instruction.feature].data() + first : nullptr;
+				const float value = instruction.value;
+				switch(instruction.opcode)
+				{
+				case LESS:
+					#pragma omp simd
+					for(size_t i = 0; i < count; ++i) result[i] = column[i] < value;
+					++top;
+					break;
+				case LESS_EQUAL:
+					#pragma omp simd
+					for(size_t i = 0; i < count; ++i) result[i] = column[i] <= value;
+					++top;
+					break;
+				case GREATER:
+					#pragma omp simd
+					for(size_t i = 0; i < count; ++i) result[i] = column[i] > value;
+					++top;
+					break;
+				case GREATER_EQUAL:
+					#pragma omp simd
+					for(size_t i = 0; i < count; ++i) result[i] = column[i] >= value;
+					++top;
+					break;
+				case EQUAL:
+					#pragma omp simd
+					for(size_t i = 0; i < count; ++i) result[i] = column[i] == value;
+					++top;
+					break;
+				case NOT_EQUAL:
+					#pragma omp simd
+					for(size_t i = 0; i < count; ++i) result[i] = column[i] != value;
+					++top;
+					break;
+				case AND:
+					lhs = result - 2 * BLOCK_SIZE;
+					#pragma omp simd
+					for(size_t i = 0; i < count; ++i) lhs[i] &= rhs[i];
+					--top;
+					break;
+				case OR:
+					lhs = result - 2 * BLOCK_SIZE;
+					#pragma omp simd
+					for(size_t i = 0; i < count; ++i) lhs[i] |= rhs[i];
+					--top;
+					break;
+				case NOT:
+					#pragma omp simd
+					for(size_t i = 0; i < count; ++i) rhs[i] ^= 1;
+					break;
+				}
+			}
+
+			//pack the masks, the multiplication gathers the lowest bits of eight bytes into the top byte
+			uint8_t* result = stack.data();
+			fill(result + count,result + ((count + 63) / 64) * 64,0);
+			for(size_t word = 0; word * 64 < count; ++word)
+			{
+				uint64_t packed = 0;
+				for(size_t byte = 0; byte < 8; ++byte)
+				{
+					uint64_t bytes;
+					memcpy(&bytes,result + word * 64 + byte * 8,8);
+					packed |= ((bytes * 0x0102040810204080ULL) >> 56) << (byte * 8);
+				}
+				bitmap[first / 64 + word] = packed;
+			}
+		}
+	}
+
+	return bitmap;
+}
+
+/**
+ * Selects the events matching a conjunction of comparisons with the index. The comparisons of each feature are
+ * intersected in the sorted order of the feature, the events of the narrowest range are the candidates. Only the
+ * candidates are checked against all comparisons.
+ *
+ * @brief Select events of a conjunction with the index
+ *
+ * @param plan Valid plan returned by compile(...)
+ * @param bitmap Zeroed bitmap, that is filled with the matching events
+ * @return False without changing the bitmap, if the plan is no conjunction or the candidates are too many
+ */
+bool EventFinder::selectCandidates(const vector<SelectionInstruction>& plan, vector<uint64_t>& bitmap) const
+{
+	const size_t nEvents = getSize();
+	vector<size_t> first(m_features.size(),0);
+	vector<size_t> last(m_features.size(),nEvents);
+	for(const SelectionInstruction& instruction : plan)
+	{
+		if(instruction.opcode > AND)
+		{
+			return false;
+		}
+		if(instruction.opcode < NOT_EQUAL)
+		{
+			size_t low, high;
+			m_index->findPositions(instruction.feature,instruction.opcode,instruction.value,low,high);
+			first[instruction.feature] = low > first[instruction.feature] ? low : first[instruction.feature];
+			last[instruction.feature] = high < last[instruction.feature] ? high : last[instruction.feature];
+		}
+	}
+
+	size_t narrowest = 0;
+	for(size_t feature = 1; feature < m_features.size(); ++feature)
+	{
+		size_t size = last[feature] > first[feature] ? last[feature] - first[feature] : 0;
+		size_t narrowestSize = last[narrowest] > first[narrowest] ? last[narrowest] - first[narrowest] : 0;
+		narrowest = size < narrowestSize ? feature : narrowest;
+	}
+	if(last[narrowest] > first[narrowest] && (last[narrowest] - first[narrowest]) * INDEX_FRACTION > nEvents)
+	{
+		return false;
+	}
+
+	const vector<uint32_t>& permutation = m_index->getPermutation(narrowest);
+	for(size_t position = first[narrowest]; position < last[narrowest]; ++position)
+	{
+		const uint32_t event = permutation[position];
+		bool match = true;
+		for(const SelectionInstruction& instruction : plan)
+		{
+			if(instruction.opcode != AND && !matches(m_features[instruction.feature][event],instruction))
+			{
+				match = false;
+				break;
+			}
+		}
+		bitmap[event >> 6] |= (uint64_t)match << (event & 63);
+	}
+	return true;
+}
+
+/**
+ * Selects the events matching a valid plan with the index. Each comparison is answered by the index, the logical
+ * operations work on whole words of the bitmaps.
+ *
+ * @brief Select events with the index
+ *
+ * @param plan Valid plan returned by compile(...)
+ * @param bitmap Bitmap, that is replaced by the matching events
+ * @return False without changing the bitmap, if the comparisons touch too many events
+ */
+bool EventFinder::selectIndexed(const vector<SelectionInstruction>& plan, vector<uint64_t>& bitmap) const
+{
+	const size_t nEvents = getSize();
+	size_t touched = 0;
+	for(const SelectionInstruction& instruction : plan)
+	{
+		if(instruction.opcode <= NOT_EQUAL)
+		{
+			size_t selected = m_index->count(instruction.feature,instruction.opcode,instruction.value);
+			touched += selected < nEvents - selected ? selected : nEvents - selected;
+		}
+	}
+	if(touched * INDEX_FRACTION > nEvents)
+	{
+		return false;
+	}
+
+	vector<vector<uint64_t>> stack;
+	for(const SelectionInstruction& instruction : plan)
+	{
+		if(instruction.opcode <= NOT_EQUAL)
+		{
+			stack.push_back(m_index->select(instruction.feature,instruction.opcode,instruction.value));
+			continue;
+		}
+		vector<uint64_t>& rhs = stack.back();
+		if(instruction.opcode == NOT)
+		{
+			for(uint64_t& word : rhs)
+			{
+				word = ~word;
+			}
+			if(nEvents % 64 != 0)
+			{
+				rhs.back() &= (1ULL << (nEvents % 64)) - 1;
+			}
+			continue;
+		}
+		vector<uint64_t>& lhs = stack[stack.size() - 2];
+		for(size_t i = 0; i < lhs.size(); ++i)
+		{
+			lhs[i] = instruction.opcode == AND ? lhs[i] & rhs[i] : lhs[i] | rhs[i];
+		}
+		stack.pop_back();
+	}
+	bitmap.swap(stack.back());
+	return true;
+}
+
+/**
+ * Evaluates a single comparison.
+ *
+ * @param value Value of the feature
+ * @param instruction Comparison
+ * @return True if the comparison holds
+ */
+bool EventFinder::matches(const float value, const SelectionInstruction& instruction)
+{
+	switch(instruction.opcode)
+	{
+	case LESS: return value < instruction.value;
+	case LESS_EQUAL: return value <= instruction.value;
+	case GREATER: return value > instruction.value;
+	case GREATER_EQUAL: return value >= instruction.value;
+	case EQUAL: return value == instruction.value;
+	default: return value != instruction.value;
+	}
+}
+
+/**
+ * Lists the events matching an expression.
+ *
+ * @brief List matching events
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param expression Selection expression, see the class documentation
+ * @return Positions of the matching events in the DataSet in ascending order
+ *
+ * @throw invalid_argument if the expression is malformed or uses an unknown feature
+ */
+vector<unsigned int> EventFinder::listEventNumbers(const string& expression) const
+{
+	return toEventNumbers(select(expression));
+}
+
+/**
+ * Gets the events matching an expression. The events are not copied, the pointers are views into the DataSet.
+ * Suppressed events are skipped.
+ *
+ * @brief Get matching events
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param expression Selection expression, see the class documentation
+ * @return Pointers to the matching events, valid as long as the DataSet exists
+ *
+ * @throw invalid_argument if the expression is malformed or uses an unknown feature
+ */
+vector<const Event*> EventFinder::getEvents(const string& expression) const
+{
+	vector<const Event*> events;
+	for(unsigned int event : listEventNumbers(expression))
+	{
+		if(m_data.getData()[event])
+		{
+			events.push_back(m_data.getData()[event].get());
+		}
+	}
+	return events;
+}
+
+/**
+ * Getter for the number of events.
+ *
+ * @brief Getter for the number of events
+ *
+ * @return Number of events in the DataSet
+ */
+size_t EventFinder::getSize() const
+{
+	return m_data.getSize();
+}
+
+/**
+ * Getter for a feature column.
+ *
+ * @brief Getter for a feature
+ *
+ * @param name Name of the feature, see the class documentation
+ * @return Values of the feature for all events
+ *
+ * @throw invalid_argument if there is no feature with that name
+ */
+const vector<float>& EventFinder::getFeature(const string& name) const
+{
+	int feature = findFeature(name);
+	if(feature < 0)
+	{
+		throw invalid_argument("EventFinder: unknown feature '" + name + "'");
+	}
+	return m_features[feature];
+}
+
+/**
+ * Getter for all feature columns, in the order drifttime, amplitude, npulses, tot, signalend, minimumpos, integralmin,
+ * integralminpos, saturated.
+ *
+ * @brief Getter for the features
+ *
+ * @return Feature columns
+ */
+const vector<vector<float>>& EventFinder::getFeatures() const
+{
+	return m_features;
+}
+
+/**
+ * Fingerprint of the features, that identifies the EventIndex built from them. It holds the number of events, the
+ * settings of the AnalysisConfig that change the features (threshold, polarity, offset, baseline estimation, filter
+ * chain, timing, bin width and zero suppression) and a checksum over all feature columns.
+ *
+ * @brief Fingerprint of the features
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @return Fingerprint as text
+ */
+string EventFinder::getFingerprint() const
+{
+	//FNV-1a over the bytes of the columns
+	uint64_t checksum = 14695981039346656037ULL;
+	for(const vector<float>& column : m_features)
+	{
+		const unsigned char* bytes = (const unsigned char*)column.data();
+		for(size_t i = 0; i < column.size() * sizeof(float); ++i)
+		{
+			checksum = (checksum ^ bytes[i]) * 1099511628211ULL;
+		}
+	}
+	const AnalysisConfig& config = AnalysisConfig::current();
+	stringstream fingerprint;
+	fingerprint << "events=" << getSize() << " features=" << m_features.size() << " offset=" << config.getOffset()
+			<< " threshold=" << config.getThreshold() << " negative=" << config.isNegative() << " baselinebins="
+			<< config.getBaselineBins() << " relativethreshold=" << config.getRelativeThreshold() << " filter="
+			<< config.getFilter() << " timing=" << (int)config.getTiming() << " cfdfraction=" << config.getCfdFraction()
+			<< " cfdwindow=" << config.getCfdWindow() << " binstotime=" << config.getBinsToTime() << " zerosuppression="
+			<< config.isZeroSuppressed() << " saturation=" << config.getSaturationLevel() << " checksum=" << hex << checksum;
+	return fingerprint.str();
+}
+
+/**
+ * Sets the index used by select(...). The index must be built from the same features, e.g. loaded with
+ * EventIndex::load(EventIndex::filename(...)). An index with another fingerprint (see getFingerprint()) is rejected and
+ * the columns are scanned instead.
+ *
+ * @brief Set the index
+ *
+ * @param index The index or nullptr to scan the columns again
+ * @return false if the index was rejected
+ */
+bool EventFinder::setIndex(shared_ptr<const EventIndex> index)
+{
+	if(index && index->getFingerprint() != getFingerprint())
+	{
+		m_index = nullptr;
+		return false;
+	}
+	m_index = index;
+	return true;
+}
+
+/**
+ * Getter for the index.
+ *
+ * @brief Getter for the index
+ *
+ * @return Pointer to the index or nullptr if no index is set
+ */
+const EventIndex* EventFinder::getIndex() const
+{
+	return m_index.get();
+}
+
+/**
+ * Converts a bitmap into the list of set bits.
+ *
+ * @brief Bitmap to event numbers
+ *
+ * @param bitmap Bitmap as returned by select(...)
+ * @return Numbers of the set bits in ascending order
+ */
+vector<unsigned int> EventFinder::toEventNumbers(const vector<uint64_t>& bitmap)
+{
+	vector<unsigned int> events;
+	for(size_t word = 0; word < bitmap.size(); ++word)
+	{
+		uint64_t bits = bitmap[word];
+		while(bits)
+		{
+			events.push_back(word * 64 + __builtin_ctzll(bits));
+			bits &= bits - 1;
+		}
+	}
+	return events;
+}
+
+/**
+ * Computes the feature columns. Every event is scanned once for its minimum and its position, the number of pulses,
+ * the length of the first pulse, the end of the last pulse and the extremum of the running integral and its position.
+ * Extrema are taken in the direction of the polarity of the AnalysisConfig.
+ *
+ * @brief Compute the features
+ */
+void EventFinder::computeFeatures()
+{
+	const vector<unique_ptr<Event>>& events = m_data.getData();
+	const long nEvents = events.size();
+	const AnalysisConfig& config = AnalysisConfig::current();
+	const short binsToTime = config.getBinsToTime();
+	const bool negative = config.isNegative();
+	//the running integral is accumulated in the direction of the signals, so that its minimum is the extremum
+	const float direction = negative ? 1 : -1;
+	const uint16_t saturationLevel = config.getSaturationLevel();
+	m_features.assign(N_FEATURES,vector<float>(nEvents));
+	float* driftTime = m_features[0].data();
+	float* amplitude = m_features[1].data();
+	float* nPulses = m_features[2].data();
+	float* tot = m_features[3].data();
+	float* signalEnd = m_features[4].data();
+	float* minimumPos = m_features[5].data();
+	float* integralMin = m_features[6].data();
+	float* integralMinPos = m_features[7].data();
+	float* saturated = m_features[8].data();
+
+	#pragma omp parallel for schedule(static,1024)
+	for(long i = 0; i < nEvents; ++i)
+	{
+		driftTime[i] = signalEnd[i] = -1;
+		amplitude[i] = nPulses[i] = tot[i] = minimumPos[i] = integralMin[i] = integralMinPos[i] = saturated[i] = 0;
+		if(!events[i] || events[i]->getData().empty())
+		{
+			continue;
+		}
+		const EventSamples& samples = events[i]->getData();
+		const float baseline = events[i]->getBaseline();
+		const uint16_t threshold = config.getAbsoluteThreshold(baseline,events[i]->getNoise());
+		uint16_t minimum = 0xFFFF;
+		uint16_t maximum = 0;
+		size_t minimumBin = 0;
+		size_t maximumBin = 0;
+		unsigned int pulses = 0;
+		unsigned int firstLength = 0;
+		long lastBelow = -1;
+		float integral = 0;
+		float minimumIntegral = 0;
+		size_t minimumIntegralBin = 0;
+		bool below = false;
+		for(size_t j = 0; j < samples.size(); ++j)
+		{
+			const uint16_t sample = samples[j];
+			minimumBin = sample < minimum ? j : minimumBin;
+			minimum = sample < minimum ? sample : minimum;
+			maximumBin = sample > maximum ? j : maximumBin;
+			maximum = sample > maximum ? sample : maximum;
+			bool isBelow = negative ? sample < threshold : sample > threshold;
+			pulses += isBelow && !below;
+			firstLength += isBelow && pulses == 1;
+			lastBelow = !isBelow && below ? (long)j - 1 : lastBelow;
+			below = isBelow;
+			integral += direction * (sample - baseline);
+			minimumIntegralBin = integral < minimumIntegral ? j : minimumIntegralBin;
+			minimumIntegral = integral < minimumIntegral ? integral : minimumIntegral;
+		}
+		//the last pulse is still open at the end of the event
+		lastBelow = below ? (long)samples.size() - 1 : lastBelow;
+		driftTime[i] = events[i]->getDriftTime() < 0 ? -1 : events[i]->getDriftTime();
+		amplitude[i] = (negative ? minimum : maximum) - baseline;
+		nPulses[i] = pulses;
+		tot[i] = firstLength * binsToTime;
+		signalEnd[i] = lastBelow < 0 ? -1 : lastBelow * binsToTime;
+		minimumPos[i] = (negative ? minimumBin : maximumBin) * binsToTime;
+		integralMin[i] = direction * minimumIntegral;
+		integralMinPos[i] = minimumIntegralBin * binsToTime;
+		saturated[i] = negative ? minimum <= saturationLevel : maximum >= saturationLevel;
+	}
+}
+
+/**
+ * Finds the column of a feature.
+ *
+ * @param name Name of the feature
+ * @return Index of the column or -1 if there is no feature with that name
+ */
+int EventFinder::findFeature(const string& name) const
+{
+	for(size_t feature = 0; feature < N_FEATURES; ++feature)
+	{
+		if(name == FEATURE_NAMES[feature])
+		{
+			return feature;
+		}
+	}
+	return -1;
+}
+
+/**
+ * Summarises a feature over all events or the events matching a selection, e.g. the mean signal end of a tube or, with
+ * the feature saturated, the fraction of saturated events.
+ *
+ * @brief Summary of a feature
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param name Name of the feature, see the class documentation
+ * @param selection Selection expression, all events if empty
+ * @return Number of events, mean, RMS, minimum and maximum of the feature, all 0 without events
+ *
+ * @throw invalid_argument if the feature is unknown or the selection is malformed
+ */
+FeatureSummary EventFinder::summarize(const string& name, const string& selection) const
+{
+	const vector<float>& values = getFeature(name);
+	vector<uint64_t> bitmap;
+	if(!selection.empty())
+	{
+		bitmap = select(selection);
+	}
+	FeatureSummary summary = {0,0,0,0,0};
+	double sum = 0, squares = 0;
+	for(size_t i = 0; i < values.size(); ++i)
+	{
+		if(!bitmap.empty() && !((bitmap[i / 64] >> (i % 64)) & 1))
+		{
+			continue;
+		}
+		const float value = values[i];
+		summary.minimum = summary.entries == 0 || value < summary.minimum ? value : summary.minimum;
+		summary.maximum = summary.entries == 0 || value > summary.maximum ? value : summary.maximum;
+		sum += value;
+		squares += (double)value * value;
+		++summary.entries;
+	}
+	if(summary.entries > 0)
+	{
+		summary.mean = sum / summary.entries;
+		const double variance = squares / summary.entries - (double)summary.mean * summary.mean;
+		summary.rms = variance > 0 ? sqrt(variance) : 0;
+	}
+	return summary;
+}
@@ -10,21 +10,121 @@
 
 //C++ libs
 #include <vector>
+#include <string>
+#include <cstdint>
+#include <memory>
 
 //own headers
 #include "DataSet.h"
 
+class EventIndex;
+
+/**
+ * One instruction of a compiled selection. Comparisons push the result of comparing a feature column to a value, the
+ * logical operations combine the topmost results.
+ *
+ * @brief Instruction of a selection plan
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	uint8_t opcode; //one of EventFinder::Opcode
+	uint8_t feature; //column for comparisons
+	float value; //right hand side for comparisons
+} SelectionInstruction;
+
+/**
+ * Summary of one feature over a set of events, see EventFinder::summarize(...).
+ *
+ * @brief Summary of a feature
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	size_t entries;
+	float mean;
+	float rms;
+	float minimum;
+	float maximum;
+} FeatureSummary;
+
+/**
+ * Selects events of a DataSet by an expression over features of the events, e.g.
+ * @code
+ * drifttime > 200 && amplitude < -500 && npulses >= 2
+ * @endcode
+ * The features are computed once in the constructor and stored column wise:
+ * - drifttime: drift time in ns, -1 for events without signal
+ * - amplitude: extremum of the event in the direction of the polarity relative to its baseline in FADC channels, signed
+ *   like the threshold
+ * - npulses: number of pulses beyond the threshold of the event
+ * - tot: time over threshold of the first pulse in ns
+ * - signalend: last bin beyond the threshold of the last pulse in ns, the last bin of the event if that pulse is still
+ *   open at its end, -1 without pulse
+ * - minimumpos: position of the extremum in ns
+ * - integralmin: extremum of the running integral of the event relative to its baseline in channels * bins, signed like
+ *   the threshold
+ * - integralminpos: position of the extremum of the running integral in ns
+ * - saturated: 1 if the event reaches the saturation level (see AnalysisConfig::getSaturationLevel()), else 0
+ * All features follow the polarity of the AnalysisConfig, the names refer to negative signals.
+ * Comparisons (<, <=, >, >=, ==, !=) of a feature with a number are combined with &&, || and !, parentheses group.
+ * An expression is compiled once into a postfix plan, which is evaluated in blocks of BLOCK_SIZE events with vectorised
+ * loops over the columns and packed into a bitmap with one bit per event. The blocks are processed in parallel.
+ * Suppressed events (see AnalysisConfig::isZeroSuppressed()) have the features of an event without signal.
+ * If an EventIndex is set, selections are answered by the index instead of a scan, if the index touches only a small
+ * part of the events. Given an index file, the EventFinder loads the index from it or builds and saves it there.
+ * Conjunctions are reduced to the events of the narrowest range of sorted values, which are then checked against the
+ * columns. Other selections combine the bitmaps of the index for each comparison.
+ *
+ * @brief Expression based event selection
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
 class EventFinder
 {
 public:
-	EventFinder();
+	EventFinder(const DataSet& data);
+	EventFinder(const DataSet& data, const std::string& indexFilename);
 	virtual ~EventFinder();
 
-	vector<unsigned int> listEventNumbers(string expression) const;
-	DataSet* getEvents(string expression);
+	std::vector<SelectionInstruction> compile(const std::string& expression) const;
+	std::vector<uint64_t> select(const std::string& expression) const;
+	std::vector<uint64_t> select(const std::vector<SelectionInstruction>& plan) const;
+	std::vector<unsigned int> listEventNumbers(const std::string& expression) const;
+	std::vector<const Event*> getEvents(const std::string& expression) const;
+
+	size_t getSize() const;
+	const std::vector<float>& getFeature(const std::string& name) const;
+	const std::vector<std::vector<float>>& getFeatures() const;
+	FeatureSummary summarize(const std::string& name, const std::string& selection = "") const;
+	std::string getFingerprint() const;
+	bool setIndex(std::shared_ptr<const EventIndex> index);
+	const EventIndex* getIndex() const;
+
+	static std::vector<unsigned int> toEventNumbers(const std::vector<uint64_t>& bitmap);
+
+	enum Opcode : uint8_t {LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, EQUAL, NOT_EQUAL, AND, OR, NOT};
+	static const size_t BLOCK_SIZE = 4096;
+	static const size_t INDEX_FRACTION = 8; //the index is used, if it touches less than 1/INDEX_FRACTION of the events
 
 private:
-	bool parseExpression(string expression, const Event& data) const;
+	void computeFeatures();
+	int findFeature(const std::string& name) const;
+	bool selectIndexed(const std::vector<SelectionInstruction>& plan, std::vector<uint64_t>& bitmap) const;
+	bool selectCandidates(const std::vector<SelectionInstruction>& plan, std::vector<uint64_t>& bitmap) const;
+	static bool matches(const float value, const SelectionInstruction& instruction);
+
+	const DataSet& m_data;
+	std::vector<std::vector<float>> m_features; //m_features[feature][event]
+	std::shared_ptr<const EventIndex> m_index; //optional
 };
 
 #endif /* EVENTFINDER_H_ */
@@ -0,0 +1,497 @@
+/*
+ * EventIndex.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "EventIndex.h"
+#include "EventFinder.h"
+#include "DataPresenceException.h"
+#include <algorithm>
+#include <fstream>
+
+using namespace std;
+
+//identifies index files and their layout version
+static const char INDEX_MAGIC[8] = {'D', 'T', 'I', 'N', 'D', 'E', 'X', '2'};
+//containers with more events are stored as bitmap, as in roaring bitmaps
+static const size_t MAX_SPARSE_CONTAINER = 4096;
+
+template<typename T> static void writeVector(ofstream& file, const vector<T>& data)
+{
+	uint64_t size = data.size();
+	file.write((const char*)&size,sizeof(size));
+	file.write((const char*)data.data(),size * sizeof(T));
+}
+
+template<typename T> static void readVector(ifstream& file, vector<T>& data)
+{
+	uint64_t size = 0;
+	file.read((char*)&size,sizeof(size));
+	if(!file)
+	{
+		throw DataPresenceException();
+	}
+	data.resize(size);
+	file.read((char*)data.data(),size * sizeof(T));
+}
+
+/**
+ * Private constructor for load(...).
+ */
+EventIndex::EventIndex()
+{
+	m_n_events = 0;
+	m_n_bins = 1;
+}
+
+/**
+ * Constructor. Builds the index of all features of an EventFinder. The values of each feature are sorted, ties keep the
+ * order of the event numbers, and the bitmaps of the bins are built in parallel.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param finder EventFinder, whose features are indexed
+ * @param nBins Number of bins of equal population per feature
+ */
+EventIndex::EventIndex(const EventFinder& finder, const unsigned int nBins)
+{
+	const vector<vector<float>>& features = finder.getFeatures();
+	m_n_events = finder.getSize();
+	m_fingerprint = finder.getFingerprint();
+	m_n_bins = nBins > 0 ? nBins : 1;
+	m_sorted.resize(features.size());
+	m_permutation.resize(features.size());
+	m_bins.resize(features.size());
+
+	for(size_t feature = 0; feature < features.size(); ++feature)
+	{
+		const vector<float>& column = features[feature];
+		vector<uint32_t>& permutation = m_permutation[feature];
+		permutation.resize(m_n_events);
+		for(size_t i = 0; i < m_n_events; ++i)
+		{
+			permutation[i] = i;
+		}
+		stable_sort(permutation.begin(),permutation.end(),[&column](const uint32_t a, const uint32_t b){return column[a] < column[b];});
+		m_sorted[feature].resize(m_n_events);
+		for(size_t i = 0; i < m_n_events; ++i)
+		{
+			m_sorted[feature][i] = column[permutation[i]];
+		}
+
+		vector<vector<BitmapContainer>>& bins = m_bins[feature];
+		bins.resize(m_n_bins);
+		#pragma omp parallel for schedule(dynamic)
+		for(unsigned int bin = 0; bin < m_n_bins; ++bin)
+		{
+			vector<uint32_t> events(permutation.begin() + (uint64_t)bin * m_n_events / m_n_bins,
+					permutation.begin() + (uint64_t)(bin + 1) * m_n_events / m_n_bins);
+			sort(events.begin(),events.end());
+			size_t begin = 0;
+			while(begin < events.size())
+			{
+				uint16_t key = events[begin] >> 16;
+				size_t end = begin;
+				while(end < events.size() && (events[end] >> 16) == key)
+				{
+					++end;
+				}
+				BitmapContainer container;
+				container.key = key;
+				if(end - begin > MAX_SPARSE_CONTAINER)
+				{
+					container.bits.assign(1024,0);
+					for(size_t i = begin; i < end; ++i)
+					{
+						container.bits[(events[i] & 0xFFFF) >> 6] |= 1ULL << (events[i] & 63);
+					}
+				}
+				else
+				{
+					for(size_t i = begin; i < end; ++i)
+					{
+						container.values.push_back(events[i] & 0xFFFF);
+					}
+				}
+				bins[bin].push_back(container);
+				begin = end;
+			}
+		}
+	}
+}
+
+EventIndex::~EventIndex()
+{
+}
+
+/**
+ * Reads an index written by save(...).
+ *
+ * @brief Load an index
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param filename Path to the index file
+ * @return The index
+ *
+ * @throw DataPresenceException if the file cannot be read or is no index file
+ */
+EventIndex EventIndex::load(const string& filename)
+{
+	ifstream file(filename,ios::binary);
+	char magic[sizeof(INDEX_MAGIC)];
+	if(!file.is_open() || !file.read(magic,sizeof(magic)) || !equal(magic,magic + sizeof(magic),INDEX_MAGIC))
+	{
+		throw DataPresenceException();
+	}
+
+	EventIndex index;
+	uint64_t nEvents = 0;
+	uint32_t nFeatures = 0;
+	uint32_t nBins = 0;
+	file.read((char*)&nEvents,sizeof(nEvents));
+	file.read((char*)&nFeatures,sizeof(nFeatures));
+	file.read((char*)&nBins,sizeof(nBins));
+	if(!file || nBins == 0)
+	{
+		throw DataPresenceException();
+	}
+	vector<char> fingerprint;
+	readVector(file,fingerprint);
+	index.m_n_events = nEvents;
+	index.m_fingerprint.assign(fingerprint.begin(),fingerprint.end());
+	index.m_n_bins = nBins;
+	index.m_sorted.resize(nFeatures);
+	index.m_permutation.resize(nFeatures);
+	index.m_bins.assign(nFeatures,vector<vector<BitmapContainer>>(nBins));
+	for(uint32_t feature = 0; feature < nFeatures; ++feature)
+	{
+		readVector(file,index.m_sorted[feature]);
+		readVector(file,index.m_permutation[feature]);
+		for(uint32_t bin = 0; bin < nBins; ++bin)
+		{
+			uint32_t nContainers = 0;
+			file.read((char*)&nContainers,sizeof(nContainers));
+			index.m_bins[feature][bin].resize(nContainers);
+			for(BitmapContainer& container : index.m_bins[feature][bin])
+			{
+				file.read((char*)&container.key,sizeof(container.key));
+				readVector(file,container.values);
+				readVector(file,container.bits);
+			}
+		}
+		if(!file || index.m_sorted[feature].size() != nEvents || index.m_permutation[feature].size() != nEvents)
+		{
+			throw DataPresenceException();
+		}
+	}
+
+	return index;
+}
+
+/**
+ * Writes the index to a binary file.
+ *
+ * @brief Save the index
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param filename Path to the index file, see filename(...)
+ *
+ * @throw DataPresenceException if the file cannot be written
+ */
+void EventIndex::save(const string& filename) const
+{
+	ofstream file(filename,ios::binary);
+	if(!file.is_open())
+	{
+		throw DataPresenceException();
+	}
+	uint64_t nEvents = m_n_events;
+	uint32_t nFeatures = m_sorted.size();
+	uint32_t nBins = m_n_bins;
+	file.write(INDEX_MAGIC,sizeof(INDEX_MAGIC));
+	file.write((const char*)&nEvents,sizeof(nEvents));
+	file.write((const char*)&nFeatures,sizeof(nFeatures));
+	file.write((const char*)&nBins,sizeof(nBins));
+	writeVector(file,vector<char>(m_fingerprint.begin(),m_fingerprint.end()));
+	for(uint32_t feature = 0; feature < nFeatures; ++feature)
+	{
+		writeVector(file,m_sorted[feature]);
+		writeVector(file,m_permutation[feature]);
+		for(const vector<BitmapContainer>& bin : m_bins[feature])
+		{
+			uint32_t nContainers = bin.size();
+			file.write((const char*)&nContainers,sizeof(nContainers));
+			for(const BitmapContainer& container : bin)
+			{
+				file.write((const char*)&container.key,sizeof(container.key));
+				writeVector(file,container.values);
+				writeVector(file,container.bits);
+			}
+		}
+	}
+	if(!file)
+	{
+		throw DataPresenceException();
+	}
+}
+
+/**
+ * Name of the index file of one tube, stored next to the data file.
+ *
+ * @brief Index file name
+ *
+ * @param dataFilename Path to the .drift file
+ * @param tube Index of the tube
+ * @return Path to the index file
+ */
+string EventIndex::filename(const string& dataFilename, const unsigned int tube)
+{
+	return dataFilename + ".tube" + to_string(tube) + ".index";
+}
+
+/**
+ * Getter for the number of indexed events.
+ *
+ * @brief Getter for the number of events
+ *
+ * @return Number of events
+ */
+size_t EventIndex::getSize() const
+{
+	return m_n_events;
+}
+
+/**
+ * Getter for the fingerprint of the EventFinder the index was built from.
+ *
+ * @brief Getter for the fingerprint
+ *
+ * @return Fingerprint, see EventFinder::getFingerprint()
+ */
+const string& EventIndex::getFingerprint() const
+{
+	return m_fingerprint;
+}
+
+/**
+ * Getter for the number of indexed features.
+ *
+ * @brief Getter for the number of features
+ *
+ * @return Number of features
+ */
+size_t EventIndex::getNumberOfFeatures() const
+{
+	return m_sorted.size();
+}
+
+/**
+ * Getter for the number of bins per feature.
+ *
+ * @brief Getter for the number of bins
+ *
+ * @return Number of bins
+ */
+unsigned int EventIndex::getNumberOfBins() const
+{
+	return m_n_bins;
+}
+
+/**
+ * Counts the events matching a comparison by binary search.
+ *
+ * @brief Count matching events
+ *
+ * @param feature Column of the feature, see EventFinder
+ * @param opcode Comparison, one of EventFinder::LESS to EventFinder::NOT_EQUAL
+ * @param value Right hand side of the comparison
+ * @return Number of matching events
+ */
+size_t EventIndex::count(const unsigned int feature, const uint8_t opcode, const float value) const
+{
+	size_t first, last;
+	findPositions(feature,opcode,value,first,last);
+	return opcode == EventFinder::NOT_EQUAL ? m_n_events - (last - first) : last - first;
+}
+
+/**
+ * Selects the events matching a comparison. The result is the same as a scan of the feature column.
+ *
+ * @brief Select matching events
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param feature Column of the feature, see EventFinder
+ * @param opcode Comparison, one of EventFinder::LESS to EventFinder::NOT_EQUAL
+ * @param value Right hand side of the comparison
+ * @return Bitmap, bit i % 64 of word i / 64 is set if event i matches
+ */
+vector<uint64_t> EventIndex::select(const unsigned int feature, const uint8_t opcode, const float value) const
+{
+	size_t first, last;
+	findPositions(feature,opcode,value,first,last);
+	//for NOT_EQUAL the events outside of the range are selected
+	const bool inside = opcode != EventFinder::NOT_EQUAL;
+	const bool fewInside = 2 * (last - first) <= m_n_events;
+
+	vector<uint64_t> bitmap((m_n_events + 63) / 64,0);
+	if(inside == fewInside)
+	{
+		if(inside)
+		{
+			applyRange(feature,first,last,bitmap,true);
+		}
+		else
+		{
+			applyRange(feature,0,first,bitmap,true);
+			applyRange(feature,last,m_n_events,bitmap,true);
+		}
+		return bitmap;
+	}
+
+	fill(bitmap.begin(),bitmap.end(),~0ULL);
+	if(m_n_events % 64 != 0)
+	{
+		bitmap.back() = (1ULL << (m_n_events % 64)) - 1;
+	}
+	if(inside)
+	{
+		applyRange(feature,0,first,bitmap,false);
+		applyRange(feature,last,m_n_events,bitmap,false);
+	}
+	else
+	{
+		applyRange(feature,first,last,bitmap,false);
+	}
+	return bitmap;
+}
+
+/**
+ * Finds the sorted positions of the events matching a comparison by binary search. For NOT_EQUAL the positions of the
+ * equal values are returned.
+ *
+ * @brief Sorted positions of a comparison
+ *
+ * @param feature Column of the feature, see EventFinder
+ * @param opcode Comparison, one of EventFinder::LESS to EventFinder::NOT_EQUAL
+ * @param value Right hand side of the comparison
+ * @param first Set to the first matching position
+ * @param last Set to the position after the last matching position
+ */
+void EventIndex::findPositions(const unsigned int feature, const uint8_t opcode, const float value, size_t& first, size_t& last) const
+{
+	const vector<float>& sorted = m_sorted[feature];
+	const size_t lower = lower_bound(sorted.begin(),sorted.end(),value) - sorted.begin();
+	const size_t upper = upper_bound(sorted.begin(),sorted.end(),value) - sorted.begin();
+	switch(opcode)
+	{
+	case EventFinder::LESS:
+		first = 0;
+		last = lower;
+		break;
+	case EventFinder::LESS_EQUAL:
+		first = 0;
+		last = upper;
+		break;
+	case EventFinder::GREATER:
+		first = upper;
+		last = sorted.size();
+		break;
+	case EventFinder::GREATER_EQUAL:
+		first = lower;
+		last = sorted.size();
+		break;
+	default:
+		first = lower;
+		last = upper;
+		break;
+	}
+}
+
+/**
+ * Getter for the event numbers of a feature in the order of ascending values.
+ *
+ * @brief Getter for the sorted permutation
+ *
+ * @param feature Column of the feature, see EventFinder
+ * @return Event number of each sorted position
+ */
+const vector<uint32_t>& EventIndex::getPermutation(const unsigned int feature) const
+{
+	return m_permutation[feature];
+}
+
+/**
+ * Sets or clears the bits of the events at the sorted positions [first,last). Bins within the range are applied from
+ * their compressed bitmaps, the partially covered bins at the ends from the permutation.
+ *
+ * @param feature Column of the feature
+ * @param first First sorted position
+ * @param last Position after the last sorted position
+ * @param bitmap Bitmap to modify
+ * @param set True to set the bits, false to clear them
+ */
+void EventIndex::applyRange(const unsigned int feature, const size_t first, const size_t last, vector<uint64_t>& bitmap, const bool set) const
+{
+	if(first >= last)
+	{
+		return;
+	}
+	const vector<uint32_t>& permutation = m_permutation[feature];
+	unsigned int bin = (uint64_t)first * m_n_bins / m_n_events;
+	while(bin + 1 < m_n_bins && (uint64_t)(bin + 1) * m_n_events / m_n_bins <= first)
+	{
+		++bin;
+	}
+	for(; bin < m_n_bins; ++bin)
+	{
+		const size_t binStart = (uint64_t)bin * m_n_events / m_n_bins;
+		const size_t binEnd = (uint64_t)(bin + 1) * m_n_events / m_n_bins;
+		if(binStart >= last)
+		{
+			break;
+		}
+		if(binStart >= first && binEnd <= last)
+		{
+			for(const BitmapContainer& container : m_bins[feature][bin])
+			{
+				uint64_t* words = bitmap.data() + container.key * 1024;
+				const size_t nWords = bitmap.size() - container.key * 1024 < 1024 ? bitmap.size() - container.key * 1024 : 1024;
+				for(uint16_t value : container.values)
+				{
+					uint64_t bit = 1ULL << (value & 63);
+					words[value >> 6] = set ? words[value >> 6] | bit : words[value >> 6] & ~bit;
+				}
+				if(!container.bits.empty())
+				{
+					for(size_t word = 0; word < nWords; ++word)
+					{
+						words[word] = set ? words[word] | container.bits[word] : words[word] & ~container.bits[word];
+					}
+				}
+			}
+			continue;
+		}
+		const size_t end = binEnd < last ? binEnd : last;
+		for(size_t position = binStart > first ? binStart : first; position < end; ++position)
+		{
+			uint32_t event = permutation[position];
+			uint64_t bit = 1ULL << (event & 63);
+			bitmap[event >> 6] = set ? bitmap[event >> 6] | bit : bitmap[event >> 6] & ~bit;
+		}
+	}
+}
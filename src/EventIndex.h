@@ -0,0 +1,83 @@
+/*
+ * EventIndex.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef EVENTINDEX_H_
+#define EVENTINDEX_H_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+class EventFinder;
+
+/**
+ * Compressed set of the event numbers with the same upper 16 bits. Sparse containers store the sorted lower 16 bits,
+ * dense containers a bitmap of 1024 words, as in roaring bitmaps.
+ *
+ * @brief Container of a compressed bitmap
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	uint16_t key; //upper 16 bits of the event numbers
+	std::vector<uint16_t> values; //sorted lower 16 bits, empty for dense containers
+	std::vector<uint64_t> bits; //1024 words, empty for sparse containers
+} BitmapContainer;
+
+/**
+ * Secondary index over the feature columns of an EventFinder, that answers comparisons of a feature with a value
+ * without scanning all events. For every feature the index stores the values in ascending order together with the
+ * permutation to the event numbers, so that the events of any value range are found by binary search. The sorted
+ * events are split into bins of equal population, the events of each bin are stored as a compressed bitmap. A range
+ * is assembled from the bitmaps of the bins it covers completely and the permutation entries of the two bins at its
+ * ends. Ranges covering more than half of the events are built as the complement of the rest, so that the cost of a
+ * query grows with the smaller of the number of selected and not selected events.
+ * The index can be saved next to the data file, see filename(...), and is used by EventFinder::select(...) once it is
+ * passed to EventFinder::setIndex(...). It carries the fingerprint of the EventFinder it was built from (see
+ * EventFinder::getFingerprint()), so that an index of other data or of another configuration is rejected.
+ *
+ * @brief Sorted and binned bitmap index of event features
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+class EventIndex
+{
+public:
+	EventIndex(const EventFinder& finder, const unsigned int nBins = 64);
+	~EventIndex();
+
+	static EventIndex load(const std::string& filename);
+	void save(const std::string& filename) const;
+	static std::string filename(const std::string& dataFilename, const unsigned int tube);
+
+	size_t getSize() const;
+	const std::string& getFingerprint() const;
+	size_t getNumberOfFeatures() const;
+	unsigned int getNumberOfBins() const;
+	size_t count(const unsigned int feature, const uint8_t opcode, const float value) const;
+	std::vector<uint64_t> select(const unsigned int feature, const uint8_t opcode, const float value) const;
+	void findPositions(const unsigned int feature, const uint8_t opcode, const float value, size_t& first, size_t& last) const;
+	const std::vector<uint32_t>& getPermutation(const unsigned int feature) const;
+
+private:
+	EventIndex();
+	void applyRange(const unsigned int feature, const size_t first, const size_t last, std::vector<uint64_t>& bitmap, const bool set) const;
+
+	size_t m_n_events;
+	std::string m_fingerprint; //of the EventFinder the index was built from
+	unsigned int m_n_bins;
+	std::vector<std::vector<float>> m_sorted; //m_sorted[feature][position], ascending
+	std::vector<std::vector<uint32_t>> m_permutation; //event number of each sorted position
+	std::vector<std::vector<std::vector<BitmapContainer>>> m_bins; //m_bins[feature][bin], events of positions [bin * n / m_n_bins, (bin + 1) * n / m_n_bins)
+};
+
+#endif /* EVENTINDEX_H_ */
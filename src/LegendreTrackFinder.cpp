@@ -0,0 +1,197 @@
+/*
+ * LegendreTrackFinder.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "LegendreTrackFinder.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Constructor. Allocates the accumulator, that is reused for every search.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param nTheta Number of bins in theta
+ * @param nDistance Number of bins in distance
+ * @param refinements Number of times the accumulator is filled again with finer bins around the peak
+ */
+LegendreTrackFinder::LegendreTrackFinder(const unsigned int nTheta, const unsigned int nDistance, const unsigned int refinements)
+{
+	m_n_theta = nTheta;
+	m_n_distance = nDistance;
+	m_refinements = refinements;
+	m_accumulator.resize(nTheta * nDistance);
+	m_cos.resize(nTheta);
+	m_sin.resize(nTheta);
+	m_upper_bins.resize(nTheta);
+	m_lower_bins.resize(nTheta);
+}
+
+LegendreTrackFinder::~LegendreTrackFinder()
+{
+}
+
+/**
+ * Searches the track candidate with the most tangent drift circles. The coarse search covers theta in [0,pi) and all
+ * distances, that lines touching the circles can have. Each refinement zooms into the two bins around the peak in
+ * both directions, until the distance bins reach TRACK_RADIUS_RESOLUTION.
+ *
+ * @brief Find a track candidate
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param circles Pointer to the first drift circle
+ * @param n Number of drift circles
+ * @return Track candidate at the peak of the accumulator, invalid if less than 3 circles voted for the coarse peak
+ */
+Track LegendreTrackFinder::findCandidate(const DriftCircle* circles, const size_t n)
+{
+	if(n == 0)
+	{
+		return Track();
+	}
+
+	double maxDistance = 0;
+	for(size_t i = 0; i < n; ++i)
+	{
+		double distance = sqrt(circles[i].x * circles[i].x + circles[i].y * circles[i].y) + circles[i].radius;
+		maxDistance = distance > maxDistance ? distance : maxDistance;
+	}
+	double thetaMin = 0;
+	double thetaStep = M_PI / m_n_theta;
+	double distanceMin = -maxDistance;
+	double distanceStep = 2 * maxDistance / m_n_distance;
+
+	unsigned int peak = fill(circles,n,thetaMin,thetaStep,distanceMin,distanceStep);
+	if(m_accumulator[peak] < 3)
+	{
+		return Track();
+	}
+	double theta = thetaMin + (peak / m_n_distance + 0.5) * thetaStep;
+	double distance = distanceMin + (peak % m_n_distance + 0.5) * distanceStep;
+	//refine as long as the bins stay wider than the resolution of the drift radii, finer bins only spread the votes
+	for(unsigned int level = 0; level < m_refinements && distanceStep * 4.0 / m_n_distance >= TRACK_RADIUS_RESOLUTION; ++level)
+	{
+		thetaStep *= 4.0 / m_n_theta;
+		distanceStep *= 4.0 / m_n_distance;
+		thetaMin = theta - 0.5 * m_n_theta * thetaStep;
+		distanceMin = distance - 0.5 * m_n_distance * distanceStep;
+		peak = fill(circles,n,thetaMin,thetaStep,distanceMin,distanceStep);
+		theta = thetaMin + (peak / m_n_distance + 0.5) * thetaStep;
+		distance = distanceMin + (peak % m_n_distance + 0.5) * distanceStep;
+	}
+
+	return Track(theta,distance);
+}
+
+/**
+ * Finds a track and fits it. The drift circles within the window around the candidate of findCandidate(...) are
+ * fitted, starting from the candidate.
+ *
+ * @brief Find and fit a track
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param circles Pointer to the first drift circle
+ * @param n Number of drift circles
+ * @param window Maximum residual in mm of a drift circle to the candidate, to be used in the fit
+ * @return Fitted track, invalid if there is no candidate or less than 3 circles in the window
+ */
+Track LegendreTrackFinder::find(const DriftCircle* circles, const size_t n, const double window)
+{
+	Track candidate = findCandidate(circles,n);
+	if(!candidate.isValid())
+	{
+		return candidate;
+	}
+
+	m_selected.clear();
+	for(size_t i = 0; i < n; ++i)
+	{
+		if(fabs(candidate.residual(circles[i])) < window)
+		{
+			m_selected.push_back(circles[i]);
+		}
+	}
+
+	return Track::fit(m_selected.data(),m_selected.size(),candidate);
+}
+
+/**
+ * Fills the accumulator for the given binning. The distances of both sinusoids of a circle are computed for all theta
+ * bins in a vectorised loop, the increments follow in a second loop. A circle that falls into the same bin with both
+ * sinusoids votes only once.
+ *
+ * @brief Fill the accumulator
+ *
+ * @param circles Pointer to the first drift circle
+ * @param n Number of drift circles
+ * @param thetaMin Lower edge of the first theta bin
+ * @param thetaStep Width of the theta bins
+ * @param distanceMin Lower edge of the first distance bin
+ * @param distanceStep Width of the distance bins
+ * @return Index of the bin with most votes
+ */
+unsigned int LegendreTrackFinder::fill(const DriftCircle* circles, const size_t n, const double thetaMin, const double thetaStep, const double distanceMin, const double distanceStep)
+{
+	fill_n(m_accumulator.begin(),m_accumulator.size(),0);
+	for(unsigned int bin = 0; bin < m_n_theta; ++bin)
+	{
+		double theta = thetaMin + (bin + 0.5) * thetaStep;
+		m_cos[bin] = cos(theta);
+		m_sin[bin] = sin(theta);
+	}
+
+	const double inverseStep = 1 / distanceStep;
+	const int nDistance = m_n_distance;
+	const double* cosTheta = m_cos.data();
+	const double* sinTheta = m_sin.data();
+	int* upper = m_upper_bins.data();
+	int* lower = m_lower_bins.data();
+	uint16_t* accumulator = m_accumulator.data();
+	for(size_t i = 0; i < n; ++i)
+	{
+		const double x = circles[i].x;
+		const double y = circles[i].y;
+		const double radius = circles[i].radius;
+		#pragma omp simd
+		for(unsigned int bin = 0; bin < m_n_theta; ++bin)
+		{
+			double center = (x * cosTheta[bin] + y * sinTheta[bin] - distanceMin) * inverseStep;
+			upper[bin] = (int)floor(center + radius * inverseStep);
+			lower[bin] = (int)floor(center - radius * inverseStep);
+		}
+		for(unsigned int bin = 0; bin < m_n_theta; ++bin)
+		{
+			uint16_t* row = accumulator + bin * nDistance;
+			if(upper[bin] >= 0 && upper[bin] < nDistance)
+			{
+				++row[upper[bin]];
+			}
+			if(lower[bin] != upper[bin] && lower[bin] >= 0 && lower[bin] < nDistance)
+			{
+				++row[lower[bin]];
+			}
+		}
+	}
+
+	unsigned int peak = 0;
+	for(unsigned int bin = 1; bin < m_accumulator.size(); ++bin)
+	{
+		peak = accumulator[bin] > accumulator[peak] ? bin : peak;
+	}
+	return peak;
+}
@@ -0,0 +1,55 @@
+/*
+ * LegendreTrackFinder.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef LEGENDRETRACKFINDER_H_
+#define LEGENDRETRACKFINDER_H_
+
+#include <vector>
+#include <cstdint>
+#include "Track.h"
+#include "globals.h"
+
+/**
+ * Finds straight tracks in triggers with many hit tubes. In the Legendre space of line parameters (theta, distance) a
+ * drift circle around (x,y) with radius R is the pair of sinusoids distance = x * cos(theta) + y * sin(theta) +- R,
+ * which contains all lines tangent to the circle. Every circle votes along both sinusoids in a discretised accumulator,
+ * the track is the bin with most votes. The accumulator is filled again around the peak with finer bins for a number of
+ * refinements. The cost grows linearly with the number of hits, in contrast to the left/right combinatorics.
+ * The found candidate seeds the Track fit to the hits compatible with it.
+ *
+ * A finder reuses its accumulator, use one finder per thread.
+ *
+ * @brief Legendre transform track finder
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+class LegendreTrackFinder
+{
+public:
+	LegendreTrackFinder(const unsigned int nTheta = 64, const unsigned int nDistance = 64, const unsigned int refinements = 2);
+	~LegendreTrackFinder();
+
+	Track findCandidate(const DriftCircle* circles, const size_t n);
+	Track find(const DriftCircle* circles, const size_t n, const double window = TRACK_HIT_WINDOW);
+
+private:
+	unsigned int fill(const DriftCircle* circles, const size_t n, const double thetaMin, const double thetaStep, const double distanceMin, const double distanceStep);
+
+	unsigned int m_n_theta;
+	unsigned int m_n_distance;
+	unsigned int m_refinements;
+	std::vector<uint16_t> m_accumulator; //m_accumulator[thetaBin * m_n_distance + distanceBin]
+	std::vector<double> m_cos;
+	std::vector<double> m_sin;
+	std::vector<int> m_upper_bins;
+	std::vector<int> m_lower_bins;
+	std::vector<DriftCircle> m_selected;
+};
+
+#endif /* LEGENDRETRACKFINDER_H_ */
@@ -0,0 +1,321 @@
+/*
+ * MemoryArena.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "MemoryArena.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+//size of the header in front of every allocation made by allocateTagged(...), keeps the object aligned
+static const size_t TAG_SIZE = alignof(max_align_t);
+static const uint64_t TAG_HEAP = 0x48454150;
+static const uint64_t TAG_ARENA = 0x4152454E;
+static const size_t HUGE_PAGE_SIZE = 2 << 20;
+
+//arena that is currently used by the calling thread, set by MemoryArena::Scope
+static thread_local MemoryArena* currentArena = nullptr;
+
+/**
+ * Constructor. Initializes an empty arena, the first block is allocated with the first allocation.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param blockSize Size of the blocks in bytes, that are requested from the operating system
+ * @param hugePages If true, blocks are rounded up to 2 MiB and advised to be backed by transparent huge pages
+ */
+MemoryArena::MemoryArena(const size_t blockSize, const bool hugePages)
+{
+	m_huge_pages = hugePages;
+	m_block_size = hugePages ? (blockSize + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE : blockSize;
+	m_current_block = 0;
+	m_position = nullptr;
+	m_end = nullptr;
+	m_bytes_allocated = 0;
+}
+
+/**
+ * Destructor. Gives back all blocks at once. Destructors of objects placed in the arena are NOT called.
+ *
+ * @brief dtor
+ */
+MemoryArena::~MemoryArena()
+{
+	release();
+}
+
+/**
+ * Allocates memory from the arena. This is a pointer increment unless the current block is exhausted, in which case
+ * the next block is used or a new one is requested.
+ *
+ * @brief Allocate memory
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param bytes Number of bytes to allocate
+ * @param alignment Alignment of the returned memory, must be a power of two
+ * @return Pointer to the allocated memory, valid until the arena is reset, released or destroyed
+ */
+void* MemoryArena::allocate(const size_t bytes, const size_t alignment)
+{
+	uintptr_t aligned = ((uintptr_t)m_position + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	while(!m_position || aligned + bytes > (uintptr_t)m_end)
+	{
+		if(m_position && m_current_block + 1 < m_blocks.size() && m_blocks[m_current_block + 1].size >= bytes + alignment)
+		{
+			++m_current_block;
+		}
+		else
+		{
+			addBlock(bytes + alignment);
+			m_current_block = m_blocks.size() - 1;
+		}
+		m_position = m_blocks[m_current_block].begin;
+		m_end = m_position + m_blocks[m_current_block].size;
+		aligned = ((uintptr_t)m_position + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	}
+	m_position = (char*)(aligned + bytes);
+	m_bytes_allocated += bytes;
+
+	return (void*)aligned;
+}
+
+/**
+ * Marks all memory of the arena as free without giving the blocks back, so that they are reused by the following allocations.
+ *
+ * @brief Reuse the arena
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @warning All pointers to memory from this arena become invalid.
+ */
+void MemoryArena::reset()
+{
+	m_current_block = 0;
+	m_position = m_blocks.size() > 0 ? m_blocks[0].begin : nullptr;
+	m_end = m_blocks.size() > 0 ? m_blocks[0].begin + m_blocks[0].size : nullptr;
+	m_bytes_allocated = 0;
+}
+
+/**
+ * Gives all blocks back to the operating system.
+ *
+ * @brief Release all memory
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @warning All pointers to memory from this arena become invalid.
+ */
+void MemoryArena::release()
+{
+	for(const Block& block : m_blocks)
+	{
+		freeBlock(block);
+	}
+	m_blocks.clear();
+	reset();
+}
+
+/**
+ * Getter for the number of bytes handed out since construction or the last reset.
+ *
+ * @brief Getter for allocated bytes
+ *
+ * @return Allocated bytes, not including alignment padding
+ */
+size_t MemoryArena::getBytesAllocated() const
+{
+	return m_bytes_allocated;
+}
+
+/**
+ * Getter for the number of bytes reserved in blocks.
+ *
+ * @brief Getter for reserved bytes
+ *
+ * @return Total size of all blocks in bytes
+ */
+size_t MemoryArena::getBytesReserved() const
+{
+	size_t reserved = 0;
+	for(const Block& block : m_blocks)
+	{
+		reserved += block.size;
+	}
+	return reserved;
+}
+
+/**
+ * Returns, if this arena was asked to use transparent huge pages.
+ *
+ * @brief Getter for huge page usage
+ *
+ * @return true if huge pages were requested
+ */
+bool MemoryArena::usesHugePages() const
+{
+	return m_huge_pages;
+}
+
+/**
+ * Returns the current arena of the calling thread as set by a MemoryArena::Scope.
+ *
+ * @brief Getter for the current arena
+ *
+ * @return Pointer to the current arena or nullptr, if there is none
+ */
+MemoryArena* MemoryArena::current()
+{
+	return currentArena;
+}
+
+/**
+ * Allocates memory for an object in the current arena of the calling thread or on the heap if there is no current arena.
+ * A small header is put in front of the object, that allows deallocateTagged(...) to tell both cases apart. Classes
+ * implement their operator new and operator delete with this pair of methods in order to be placed in arenas.
+ *
+ * @brief Allocate from the current arena or the heap
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param bytes Size of the object
+ * @return Pointer to memory for the object
+ */
+void* MemoryArena::allocateTagged(const size_t bytes)
+{
+	char* base;
+	uint64_t tag;
+	if(currentArena)
+	{
+		base = (char*)currentArena->allocate(bytes + TAG_SIZE, TAG_SIZE);
+		tag = TAG_ARENA;
+	}
+	else
+	{
+		base = (char*)::operator new(bytes + TAG_SIZE);
+		tag = TAG_HEAP;
+	}
+	*(uint64_t*)base = tag;
+	return base + TAG_SIZE;
+}
+
+/**
+ * Frees memory allocated with allocateTagged(...). Heap memory is deleted, arena memory is left to its arena.
+ *
+ * @brief Free memory from allocateTagged
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param ptr Pointer returned by allocateTagged(...), may be nullptr
+ */
+void MemoryArena::deallocateTagged(void* ptr)
+{
+	if(!ptr)
+	{
+		return;
+	}
+	char* base = (char*)ptr - TAG_SIZE;
+	if(*(uint64_t*)base == TAG_HEAP)
+	{
+		::operator delete(base);
+	}
+}
+
+/**
+ * Requests a new block of at least the given size.
+ *
+ * @brief Add a block
+ *
+ * @param minimumSize Minimum size of the block in bytes
+ */
+void MemoryArena::addBlock(const size_t minimumSize)
+{
+	Block block;
+	block.size = minimumSize > m_block_size ? minimumSize : m_block_size;
+	block.mapped = false;
+	block.begin = nullptr;
+#ifdef __linux__
+	if(m_huge_pages)
+	{
+		block.size = (block.size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+		void* mem = mmap(nullptr, block.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(mem != MAP_FAILED)
+		{
+			madvise(mem, block.size, MADV_HUGEPAGE);
+			block.begin = (char*)mem;
+			block.mapped = true;
+		}
+	}
+#endif
+	if(!block.begin)
+	{
+		block.begin = (char*)malloc(block.size);
+		if(!block.begin)
+		{
+			throw bad_alloc();
+		}
+	}
+	m_blocks.push_back(block);
+}
+
+/**
+ * Gives a block back to the operating system.
+ *
+ * @brief Free a block
+ *
+ * @param block The block to free
+ */
+void MemoryArena::freeBlock(const Block& block)
+{
+#ifdef __linux__
+	if(block.mapped)
+	{
+		munmap(block.begin, block.size);
+		return;
+	}
+#endif
+	free(block.begin);
+}
+
+/**
+ * Makes the passed arena the current arena of the calling thread.
+ *
+ * @brief ctor
+ *
+ * @param arena The arena to use, nullptr for the heap
+ */
+MemoryArena::Scope::Scope(MemoryArena* arena)
+{
+	m_previous = currentArena;
+	currentArena = arena;
+}
+
+/**
+ * Restores the previously current arena of the calling thread.
+ *
+ * @brief dtor
+ */
+MemoryArena::Scope::~Scope()
+{
+	currentArena = m_previous;
+}
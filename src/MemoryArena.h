@@ -0,0 +1,149 @@
+/*
+ * MemoryArena.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef MEMORYARENA_H_
+#define MEMORYARENA_H_
+
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+/**
+ * A monotonic memory arena (bump allocator). Memory is handed out from large blocks by moving a pointer forward, single
+ * allocations are never freed. All memory is given back at once when the arena is reset, released or destroyed. This is meant
+ * for objects that live exactly as long as one run or one chunk of a run, e.g. the Events of one DataSet, so that their
+ * teardown is a single release instead of one free per object.
+ * Optionally, the blocks are backed by transparent huge pages (Linux only, silently ignored elsewhere).
+ *
+ * An arena can be made the current arena of a thread with a MemoryArena::Scope. Classes that implement their operator new
+ * with allocateTagged(...) (see Event) are placed in the current arena of the allocating thread, or on the heap if there is none.
+ *
+ * @brief Bump allocator for per-run objects
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @warning Not thread safe. Use one arena per thread.
+ */
+class MemoryArena
+{
+public:
+	MemoryArena(const size_t blockSize = 1 << 20, const bool hugePages = false);
+	~MemoryArena();
+	MemoryArena(const MemoryArena& original) = delete;
+	MemoryArena& operator=(const MemoryArena& rhs) = delete;
+
+	void* allocate(const size_t bytes, const size_t alignment = alignof(std::max_align_t));
+	void reset();
+	void release();
+
+	size_t getBytesAllocated() const;
+	size_t getBytesReserved() const;
+	bool usesHugePages() const;
+
+	static MemoryArena* current();
+	static void* allocateTagged(const size_t bytes);
+	static void deallocateTagged(void* ptr);
+
+	/**
+	 * RAII helper that makes an arena the current arena of the calling thread for its lifetime. The previously current arena
+	 * is restored on destruction, so scopes can be nested. A scope with nullptr makes the thread allocate from the heap.
+	 *
+	 * @brief Sets the current arena of a thread
+	 */
+	class Scope
+	{
+	public:
+		Scope(MemoryArena* arena);
+		~Scope();
+	private:
+		MemoryArena* m_previous;
+	};
+
+private:
+	typedef struct
+	{
+		char* begin;
+		size_t size;
+		bool mapped;
+	} Block;
+
+	void addBlock(const size_t minimumSize);
+	void freeBlock(const Block& block);
+
+	std::vector<Block> m_blocks;
+	size_t m_block_size;
+	bool m_huge_pages;
+	size_t m_current_block;
+	char* m_position;
+	char* m_end;
+	size_t m_bytes_allocated;
+};
+
+/**
+ * Allocator for standard library containers that takes its memory from a MemoryArena. Deallocation is a no-op, memory is
+ * given back when the arena is reset or destroyed. A default constructed ArenaAllocator uses the global heap.
+ *
+ * @brief STL allocator using a MemoryArena
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+template<typename T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type;
+
+	ArenaAllocator() : m_arena(nullptr) {}
+	ArenaAllocator(MemoryArena* arena) : m_arena(arena) {}
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.getArena()) {}
+
+	T* allocate(const size_t n)
+	{
+		if(m_arena)
+		{
+			return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+		}
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T* ptr, const size_t)
+	{
+		if(!m_arena)
+		{
+			::operator delete(ptr);
+		}
+	}
+
+	MemoryArena* getArena() const
+	{
+		return m_arena;
+	}
+
+private:
+	MemoryArena* m_arena;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+	return lhs.getArena() == rhs.getArena();
+}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+	return !(lhs == rhs);
+}
+
+#endif /* MEMORYARENA_H_ */
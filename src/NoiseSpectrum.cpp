@@ -0,0 +1,294 @@
+/*
+ * NoiseSpectrum.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "NoiseSpectrum.h"
+#include "AnalysisConfig.h"
+#include <omp.h>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Constructor for an empty spectrum.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param segmentLength Number of samples per segment, a power of 2. The frequency resolution is 1 / (segmentLength * binsToTime)
+ * @param guard Number of bins before the threshold crossing, that are not used as noise
+ *
+ * @throw invalid_argument if the segment length is not a power of 2
+ */
+NoiseSpectrum::NoiseSpectrum(const size_t segmentLength, const size_t guard)
+{
+	if(segmentLength < 4 || (segmentLength & (segmentLength - 1)) != 0)
+	{
+		throw invalid_argument("NoiseSpectrum: segment length must be a power of 2 and at least 4");
+	}
+	m_segment_length = segmentLength;
+	m_guard = guard;
+	m_window.resize(segmentLength);
+	m_window_norm = 0;
+	for(size_t i = 0; i < segmentLength; ++i)
+	{
+		m_window[i] = 0.5 * (1 - cos(2 * M_PI * i / segmentLength));
+		m_window_norm += m_window[i] * m_window[i];
+	}
+	m_sum.resize(segmentLength / 2 + 1,0);
+	m_segments = 0;
+}
+
+NoiseSpectrum::~NoiseSpectrum()
+{
+}
+
+/**
+ * Adds the signal-free samples of all events of a DataSet, see the class description. The events are processed in
+ * parallel.
+ *
+ * @brief Add the noise of a DataSet
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data DataSet of the tube
+ */
+void NoiseSpectrum::accumulate(const DataSet& data)
+{
+	const vector<unique_ptr<Event>>& events = data.getData();
+	const long nEvents = events.size();
+	const short binsToTime = AnalysisConfig::current().getBinsToTime();
+	#pragma omp parallel
+	{
+		RealFFT fft(m_segment_length);
+		vector<float> segments;
+		vector<float> spectrum(m_sum.size());
+		vector<double> sum(m_sum.size(),0);
+		size_t nSegments = 0;
+		#pragma omp for schedule(static,1024)
+		for(long i = 0; i < nEvents; ++i)
+		{
+			if(!events[i])
+			{
+				continue;
+			}
+			const Event& event = *events[i];
+			size_t size = event.getSize();
+			if(event.getDriftTime() >= 0)
+			{
+				const size_t crossing = event.getDriftTime() / binsToTime;
+				size = crossing > m_guard ? crossing - m_guard : 0;
+			}
+			nSegments += addSegments(event.getData().data(),size,fft,segments,spectrum,sum);
+		}
+		#pragma omp critical
+		{
+			for(size_t k = 0; k < m_sum.size(); ++k)
+			{
+				m_sum[k] += sum[k];
+			}
+			m_segments += nSegments;
+		}
+	}
+}
+
+/**
+ * Adds a range of signal-free samples, e.g. a pre-trigger window.
+ *
+ * @brief Add noise samples
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data Raw FADC samples without signal
+ * @param size Number of samples
+ */
+void NoiseSpectrum::accumulate(const uint16_t* data, const size_t size)
+{
+	RealFFT fft(m_segment_length);
+	vector<float> segments;
+	vector<float> spectrum(m_sum.size());
+	m_segments += addSegments(data,size,fft,segments,spectrum,m_sum);
+}
+
+/**
+ * Finds lines in the spectrum, e.g. from pickup: local maxima that exceed the median power by a factor.
+ *
+ * @brief Find pickup lines
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param factor Minimum ratio of the power of a line to the median power
+ *
+ * @return Frequency bins of the lines, see getFrequency(...)
+ */
+const vector<size_t> NoiseSpectrum::findLines(const double factor) const
+{
+	vector<size_t> lines;
+	const size_t nBins = m_sum.size();
+	if(m_segments == 0)
+	{
+		return lines;
+	}
+	vector<double> sorted(m_sum.begin() + 1,m_sum.end());
+	nth_element(sorted.begin(),sorted.begin() + sorted.size() / 2,sorted.end());
+	const double level = factor * sorted[sorted.size() / 2];
+	for(size_t k = 1; k < nBins; ++k)
+	{
+		const bool maximum = m_sum[k] >= m_sum[k - 1] && (k + 1 == nBins || m_sum[k] > m_sum[k + 1]);
+		if(maximum && m_sum[k] > level)
+		{
+			lines.push_back(k);
+		}
+	}
+	return lines;
+}
+
+/**
+ * Getter for the segment length.
+ *
+ * @brief Getter for the segment length
+ *
+ * @return Number of samples per segment
+ */
+size_t NoiseSpectrum::getSegmentLength() const
+{
+	return m_segment_length;
+}
+
+/**
+ * Getter for the number of frequency bins, from 0 to the Nyquist frequency.
+ *
+ * @brief Getter for the number of bins
+ *
+ * @return segmentLength / 2 + 1
+ */
+size_t NoiseSpectrum::getSize() const
+{
+	return m_sum.size();
+}
+
+/**
+ * Getter for the number of averaged segments.
+ *
+ * @brief Getter for the number of segments
+ *
+ * @return Number of segments
+ */
+size_t NoiseSpectrum::getSegments() const
+{
+	return m_segments;
+}
+
+/**
+ * Frequency of a bin in MHz, calculated with the binsToTime of the current AnalysisConfig.
+ *
+ * @brief Frequency of a bin
+ *
+ * @param bin The bin
+ * @return Frequency in MHz
+ */
+double NoiseSpectrum::getFrequency(const size_t bin) const
+{
+	return 1000.0 * bin / (m_segment_length * AnalysisConfig::current().getBinsToTime());
+}
+
+/**
+ * Average power of a frequency bin. Bins between 0 and the Nyquist frequency contain the power of the negative
+ * frequencies, too, so that the powers add up to the variance.
+ *
+ * @brief Power of a bin
+ *
+ * @param bin The bin
+ * @return Power in channels^2, 0 without segments
+ */
+double NoiseSpectrum::getPower(const size_t bin) const
+{
+	if(m_segments == 0)
+	{
+		return 0;
+	}
+	const double twoSided = (bin == 0 || bin == m_sum.size() - 1) ? 1 : 2;
+	return twoSided * m_sum[bin] / (m_segments * m_segment_length * m_window_norm);
+}
+
+/**
+ * Variance of the noise, the sum of the power of all bins.
+ *
+ * @brief Variance of the noise
+ *
+ * @return Variance in channels^2
+ */
+double NoiseSpectrum::getVariance() const
+{
+	double variance = 0;
+	for(size_t k = 0; k < m_sum.size(); ++k)
+	{
+		variance += getPower(k);
+	}
+	return variance;
+}
+
+/**
+ * Cuts samples into half overlapping segments, removes their means, applies the window and adds their power spectra,
+ * transformed in one batch.
+ *
+ * @param data Raw samples
+ * @param size Number of samples
+ * @param fft FFT of the thread
+ * @param segments Scratch buffer for the windowed segments
+ * @param spectrum Scratch buffer for the power spectrum of the batch
+ * @param sum Sum of the power spectra, the spectra of the segments are added
+ *
+ * @return Number of segments
+ */
+size_t NoiseSpectrum::addSegments(const uint16_t* data, const size_t size, RealFFT& fft, vector<float>& segments,
+		vector<float>& spectrum, vector<double>& sum) const
+{
+	const size_t length = m_segment_length;
+	const size_t step = length / 2;
+	if(size < length)
+	{
+		return 0;
+	}
+	const size_t nSegments = (size - length) / step + 1;
+	if(segments.size() < nSegments * length)
+	{
+		segments.resize(nSegments * length);
+	}
+	for(size_t s = 0; s < nSegments; ++s)
+	{
+		const uint16_t* samples = data + s * step;
+		float* segment = segments.data() + s * length;
+		uint32_t total = 0;
+		for(size_t i = 0; i < length; ++i)
+		{
+			total += samples[i];
+		}
+		const float mean = (float)total / length;
+		for(size_t i = 0; i < length; ++i)
+		{
+			segment[i] = (samples[i] - mean) * m_window[i];
+		}
+	}
+	fill(spectrum.begin(),spectrum.end(),0);
+	fft.addPower(segments.data(),nSegments,length,spectrum.data());
+	for(size_t k = 0; k < spectrum.size(); ++k)
+	{
+		sum[k] += spectrum[k];
+	}
+	return nSegments;
+}
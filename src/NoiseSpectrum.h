@@ -0,0 +1,62 @@
+/*
+ * NoiseSpectrum.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef NOISESPECTRUM_H_
+#define NOISESPECTRUM_H_
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "DataSet.h"
+#include "Event.h"
+#include "RealFFT.h"
+
+/**
+ * Average power spectrum of the noise of one tube, to find the frequencies of pickup when a channel gets noisy.
+ * The noise is taken from signal-free samples: whole events without drift time and, for events with a drift time, the
+ * samples before the threshold crossing minus a guard of some bins. These are cut into segments of a power of 2 length
+ * with half overlap. Each segment has its mean removed, is multiplied with a Hann window and transformed with a RealFFT.
+ * The power spectra of all segments are averaged (Welch's method) and normalised, so that the sum over all bins is the
+ * variance of the noise in channels^2.
+ * The events are processed in parallel, each thread accumulates its own spectrum, the spectra are added at the end.
+ * With zero suppression, events without drift time are not stored, then only the samples before the signals are used.
+ *
+ * @brief Noise power spectrum of a tube
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+class NoiseSpectrum
+{
+public:
+	NoiseSpectrum(const size_t segmentLength = 128, const size_t guard = 8);
+	~NoiseSpectrum();
+
+	void accumulate(const DataSet& data);
+	void accumulate(const uint16_t* data, const size_t size);
+	const std::vector<size_t> findLines(const double factor = 10) const;
+
+	size_t getSegmentLength() const;
+	size_t getSize() const;
+	size_t getSegments() const;
+	double getFrequency(const size_t bin) const;
+	double getPower(const size_t bin) const;
+	double getVariance() const;
+
+private:
+	size_t addSegments(const uint16_t* data, const size_t size, RealFFT& fft, std::vector<float>& segments, std::vector<float>& spectrum, std::vector<double>& sum) const;
+
+	size_t m_segment_length;
+	size_t m_guard; //bins before the threshold crossing that are not used
+	std::vector<float> m_window; //Hann window
+	double m_window_norm; //sum of the squared window
+	std::vector<double> m_sum; //sum of the power spectra of all segments
+	size_t m_segments;
+};
+
+#endif /* NOISESPECTRUM_H_ */
@@ -0,0 +1,247 @@
+/*
+ * PeakFinder.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "PeakFinder.h"
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Constructor.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param negative If true, pulses undershoot the baseline, else exceed it
+ * @param release Release level as fraction of the threshold relative to the baseline, between 0 and 1
+ * @param prominence Channels the signal has to return from an extremum to separate two peaks of a pulse
+ *
+ * @throw invalid_argument if release is not between 0 and 1
+ */
+PeakFinder::PeakFinder(const bool negative, const float release, const uint16_t prominence)
+{
+	if(!(release >= 0 && release <= 1))
+	{
+		throw invalid_argument("PeakFinder: release level must be between 0 and 1");
+	}
+	m_negative = negative;
+	m_release = release;
+	m_prominence = prominence;
+}
+
+PeakFinder::~PeakFinder()
+{
+}
+
+/**
+ * Finds all peaks of the data, see the class description. The peaks are written to the passed vector, which is cleared
+ * first, so that its memory is reused from event to event.
+ *
+ * @brief Find all peaks
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data Pointer to the first bin of the raw data
+ * @param size Number of bins
+ * @param baseline Baseline in FADC units
+ * @param threshold Absolute threshold in FADC units, that starts a pulse
+ * @param peaks Found peaks in the order of their bins
+ *
+ * @return Number of peaks
+ */
+size_t PeakFinder::find(const uint16_t* data, const size_t size, const float baseline, const uint16_t threshold, vector<Peak>& peaks)
+{
+	peaks.clear();
+	if(m_signal.size() < size)
+	{
+		m_signal.resize(size);
+	}
+	int32_t* signal = m_signal.data();
+	const int32_t base = lround(baseline);
+	const int32_t sign = m_negative ? -1 : 1;
+	int32_t maximum = 0;
+	for(size_t i = 0; i < size; ++i)
+	{
+		signal[i] = sign * ((int32_t)data[i] - base);
+		maximum = signal[i] > maximum ? signal[i] : maximum;
+	}
+	const int32_t trigger = sign * ((int32_t)threshold - base);
+	if(trigger <= 0 || maximum < trigger)
+	{
+		return 0;
+	}
+	const int32_t release = lround(m_release * trigger);
+	const int32_t prominence = m_prominence;
+
+	bool inPulse = false;
+	bool falling = false;
+	size_t pulseFirstPeak = 0;
+	size_t start = 0;
+	size_t peakBin = 0;
+	int32_t peakAmplitude = 0;
+	size_t valleyBin = 0;
+	int32_t valley = 0;
+	for(size_t i = 0; i < size; ++i)
+	{
+		const int32_t value = signal[i];
+		if(!inPulse)
+		{
+			if(value >= trigger)
+			{
+				inPulse = true;
+				falling = false;
+				pulseFirstPeak = peaks.size();
+				start = i;
+				peakBin = i;
+				peakAmplitude = value;
+			}
+			continue;
+		}
+		if(value < release)
+		{
+			closePeak(peaks,start,i,peakBin,peakAmplitude);
+			markPileUp(peaks,pulseFirstPeak);
+			inPulse = false;
+		}
+		else if(!falling)
+		{
+			if(value > peakAmplitude)
+			{
+				peakAmplitude = value;
+				peakBin = i;
+			}
+			else if(peakAmplitude - value >= prominence)
+			{
+				falling = true;
+				valley = value;
+				valleyBin = i;
+			}
+		}
+		else
+		{
+			if(value < valley)
+			{
+				valley = value;
+				valleyBin = i;
+			}
+			else if(value - valley >= prominence)
+			{
+				//the derivative changed its sign in the valley: next peak of the same pulse
+				closePeak(peaks,start,valleyBin,peakBin,peakAmplitude);
+				falling = false;
+				start = valleyBin;
+				peakBin = i;
+				peakAmplitude = value;
+			}
+		}
+	}
+	if(inPulse)
+	{
+		closePeak(peaks,start,size,peakBin,peakAmplitude);
+		markPileUp(peaks,pulseFirstPeak);
+	}
+	return peaks.size();
+}
+
+/**
+ * Finds all peaks of an event relative to its baseline with its threshold (see Event::getBaseline() and
+ * Event::getThreshold()).
+ *
+ * @brief Find all peaks of an event
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param event The event
+ * @param peaks Found peaks in the order of their bins
+ *
+ * @return Number of peaks
+ */
+size_t PeakFinder::find(const Event& event, vector<Peak>& peaks)
+{
+	return find(event.getData().data(),event.getSize(),event.getBaseline(),event.getThreshold(),peaks);
+}
+
+/**
+ * Getter for the polarity.
+ *
+ * @brief Getter for the polarity
+ *
+ * @return True if pulses undershoot the baseline
+ */
+bool PeakFinder::isNegative() const
+{
+	return m_negative;
+}
+
+/**
+ * Getter for the release level as fraction of the threshold.
+ *
+ * @brief Getter for the release level
+ *
+ * @return The release level
+ */
+float PeakFinder::getRelease() const
+{
+	return m_release;
+}
+
+/**
+ * Getter for the prominence, that separates two peaks of a pulse.
+ *
+ * @brief Getter for the prominence
+ *
+ * @return The prominence in channels
+ */
+uint16_t PeakFinder::getProminence() const
+{
+	return m_prominence;
+}
+
+/**
+ * Appends a peak to the list.
+ *
+ * @param peaks The list of peaks
+ * @param start First bin of the peak
+ * @param end Bin after the peak
+ * @param bin Bin of the extremum
+ * @param amplitude Amplitude relative to the baseline
+ */
+void PeakFinder::closePeak(vector<Peak>& peaks, const size_t start, const size_t end, const size_t bin, const int32_t amplitude)
+{
+	Peak peak;
+	peak.bin = bin;
+	peak.amplitude = amplitude > UINT16_MAX ? UINT16_MAX : amplitude;
+	peak.width = end - start;
+	peak.piledUp = 0;
+	peaks.push_back(peak);
+}
+
+/**
+ * Marks the peaks of a pulse as piled up, if there is more than one.
+ *
+ * @param peaks The list of peaks
+ * @param first Index of the first peak of the pulse
+ */
+void PeakFinder::markPileUp(vector<Peak>& peaks, const size_t first)
+{
+	if(peaks.size() - first < 2)
+	{
+		return;
+	}
+	for(size_t i = first; i < peaks.size(); ++i)
+	{
+		peaks[i].piledUp = 1;
+	}
+}
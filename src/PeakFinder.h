@@ -0,0 +1,77 @@
+/*
+ * PeakFinder.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef PEAKFINDER_H_
+#define PEAKFINDER_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Event.h"
+#include "AnalysisConfig.h"
+
+/**
+ * One peak found by a PeakFinder.
+ *
+ * @brief Peak of an event
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	uint16_t bin; //bin of the extremum
+	uint16_t amplitude; //channels beyond the baseline
+	uint16_t width; //bins from the start to the end of the peak
+	uint16_t piledUp; //1 if the peak shares its pulse with other peaks, else 0
+} Peak;
+
+/**
+ * Finds all peaks of an event, e.g. for cluster counting and tagging of pile-up. The finder is a hysteresis
+ * discriminator: a pulse starts where the signal crosses the threshold and ends where it falls back within the release
+ * level, a fraction of the threshold relative to the baseline. Within a pulse, a peak ends and the next one starts at a
+ * local extremum of the signal (a zero crossing of its derivative), if the signal returns by at least the prominence
+ * from it. Thus noise on a pulse does not split it, while clusters arriving one after another are counted separately.
+ * Each peak has the bin and amplitude of its extremum and its width. The width ends at the release crossing or at the
+ * valley to the next peak. Peaks sharing one pulse are marked as piled up.
+ * The signal relative to the baseline and its maximum are computed in one vectorised pass over the event. Events that do
+ * not cross the threshold end there, so most events at full rate only cost this pass. The state machine only runs over
+ * events with pulses. The scratch buffer is reused for all events.
+ *
+ * @brief Multi-peak finder with hysteresis
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @warning A finder is not thread safe, use one finder per thread.
+ */
+class PeakFinder
+{
+public:
+	PeakFinder(const bool negative = AnalysisConfig::current().isNegative(), const float release = 0.5, const uint16_t prominence = 20);
+	~PeakFinder();
+
+	size_t find(const uint16_t* data, const size_t size, const float baseline, const uint16_t threshold, std::vector<Peak>& peaks);
+	size_t find(const Event& event, std::vector<Peak>& peaks);
+
+	bool isNegative() const;
+	float getRelease() const;
+	uint16_t getProminence() const;
+
+private:
+	void closePeak(std::vector<Peak>& peaks, const size_t start, const size_t end, const size_t bin, const int32_t amplitude);
+	void markPileUp(std::vector<Peak>& peaks, const size_t first);
+
+	bool m_negative;
+	float m_release; //fraction of the threshold
+	uint16_t m_prominence; //channels
+	std::vector<int32_t> m_signal; //signal relative to the baseline, positive for pulses
+};
+
+#endif /* PEAKFINDER_H_ */
@@ -0,0 +1,451 @@
+/*
+ * PulseTemplateFitter.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "PulseTemplateFitter.h"
+#include "DataPresenceException.h"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Constructor. The fitter has no template until buildTemplate(...) or setTemplate(...) is called. The saturation level is
+ * the one of the current AnalysisConfig for the given polarity and the maximum deviation is 10%. No fit is an afterpulse,
+ * until the afterpulse start bin is set.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param length Number of bins of the template, at least 3
+ * @param pre Number of bins of the template before the extremum, less than length
+ * @param negative If true, pulses undershoot the baseline, else exceed it
+ *
+ * @throw invalid_argument if length or pre are invalid
+ */
+PulseTemplateFitter::PulseTemplateFitter(const unsigned int length, const unsigned int pre, const bool negative) : m_finder(negative)
+{
+	if(length < 3 || pre >= length)
+	{
+		throw invalid_argument("PulseTemplateFitter: the template needs at least 3 bins and its extremum inside");
+	}
+	m_length = length;
+	m_pre = pre;
+	m_negative = negative;
+	const AnalysisConfig& config = AnalysisConfig::current();
+	//the level of the other polarity is mirrored in the FADC range
+	m_saturation_level = negative == config.isNegative() ? config.getSaturationLevel() : ADC_MAX_CHANNEL - config.getSaturationLevel();
+	m_max_deviation = 0.1;
+	m_afterpulse_start_bin = numeric_limits<unsigned short>::max();
+	m_inverse[0] = m_inverse[1] = m_inverse[2] = 0;
+	m_window.resize(length);
+	m_weights.resize(length);
+}
+
+PulseTemplateFitter::~PulseTemplateFitter()
+{
+}
+
+/**
+ * Builds the template as average shape of the isolated pulses of a DataSet. Events are used, if they have exactly one
+ * peak (see PeakFinder), which is neither saturated nor too close to the borders of the event. Each pulse is aligned at
+ * its extremum and normalised to an amplitude of 1 before it is added.
+ *
+ * @brief Build the template from data
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data DataSet with the events
+ *
+ * @return Number of pulses in the template
+ *
+ * @throw DataPresenceException if there is no pulse for the template
+ */
+size_t PulseTemplateFitter::buildTemplate(const DataSet& data)
+{
+	vector<double> sum(m_length,0);
+	size_t nPulses = 0;
+	for(const unique_ptr<Event>& event : data.getData())
+	{
+		if(!event || m_finder.find(*event,m_peaks) != 1)
+		{
+			continue;
+		}
+		bool saturated;
+		const long start = (long)m_peaks[0].bin - m_pre;
+		if(!gather(event->getData().data(),event->getSize(),event->getBaseline(),start,saturated) || m_window[m_pre] <= 0)
+		{
+			continue;
+		}
+		const double norm = 1.0 / m_window[m_pre];
+		for(size_t k = 0; k < m_length; ++k)
+		{
+			sum[k] += m_window[k] * norm;
+		}
+		++nPulses;
+	}
+	if(nPulses == 0)
+	{
+		throw DataPresenceException();
+	}
+	vector<float> shape(m_length);
+	for(size_t k = 0; k < m_length; ++k)
+	{
+		shape[k] = sum[k] / nPulses;
+	}
+	setTemplate(shape);
+	return nPulses;
+}
+
+/**
+ * Sets the template and precomputes its derivative and the inverse normal matrix of the linearised fit. The extremum of
+ * the shape is expected at the bin pre of the constructor.
+ *
+ * @brief Set the template
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param shape Pulse shape with length bins, positive for the pulse and normalised to an amplitude of 1
+ *
+ * @throw invalid_argument if the length does not match or the shape is constant
+ */
+void PulseTemplateFitter::setTemplate(const vector<float>& shape)
+{
+	if(shape.size() != m_length)
+	{
+		throw invalid_argument("PulseTemplateFitter: the template must have the length of the fitter");
+	}
+	m_template = shape;
+	m_derivative.resize(m_length);
+	m_derivative[0] = shape[1] - shape[0];
+	m_derivative[m_length - 1] = shape[m_length - 1] - shape[m_length - 2];
+	for(size_t k = 1; k + 1 < m_length; ++k)
+	{
+		m_derivative[k] = 0.5f * (shape[k + 1] - shape[k - 1]);
+	}
+	double tt = 0, td = 0, dd = 0;
+	for(size_t k = 0; k < m_length; ++k)
+	{
+		tt += shape[k] * shape[k];
+		td += shape[k] * m_derivative[k];
+		dd += m_derivative[k] * m_derivative[k];
+	}
+	const double det = tt * dd - td * td;
+	if(!(det > 0))
+	{
+		throw invalid_argument("PulseTemplateFitter: the template must not be constant");
+	}
+	m_inverse[0] = dd / det;
+	m_inverse[1] = -td / det;
+	m_inverse[2] = tt / det;
+}
+
+/**
+ * Getter for the template.
+ *
+ * @brief Getter for the template
+ *
+ * @return The template, empty if there is none
+ */
+const vector<float>& PulseTemplateFitter::getTemplate() const
+{
+	return m_template;
+}
+
+/**
+ * Fits the template to the given peaks of an event and classifies the fits, see the class description. The fits are
+ * appended to the passed vector.
+ *
+ * @brief Fit the peaks of an event
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param event The event
+ * @param peaks Peaks of the event, see PeakFinder
+ * @param fits The fits, one is appended for every peak
+ *
+ * @return Number of appended fits
+ *
+ * @throw DataPresenceException if there is no template
+ */
+size_t PulseTemplateFitter::fit(const Event& event, const vector<Peak>& peaks, vector<PulseFit>& fits)
+{
+	if(m_template.empty())
+	{
+		throw DataPresenceException();
+	}
+	const size_t first = fits.size();
+	for(const Peak& peak : peaks)
+	{
+		fits.push_back(fitWindow(event,(long)peak.bin - m_pre,peak.piledUp));
+	}
+	classify(fits,first);
+	return fits.size() - first;
+}
+
+/**
+ * Finds the peaks of all events of a DataSet and fits the template to them. The fitter reuses its buffers for all
+ * pulses, so the fits of a whole DataSet only allocate the result.
+ *
+ * @brief Fit all pulses of a DataSet
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data DataSet with the events
+ * @param fits The fits in the order of the events, cleared first
+ *
+ * @return Number of fits
+ *
+ * @throw DataPresenceException if there is no template
+ */
+size_t PulseTemplateFitter::fit(const DataSet& data, vector<PulseFit>& fits)
+{
+	fits.clear();
+	for(const unique_ptr<Event>& event : data.getData())
+	{
+		if(event && m_finder.find(*event,m_peaks) > 0)
+		{
+			fit(*event,m_peaks,fits);
+		}
+	}
+	return fits.size();
+}
+
+/**
+ * Fits all pulses of the DataSet of a tube, see fit(const DataSet&, std::vector<PulseFit>&). Fits from the maximum drift
+ * time of the tube on are afterpulses.
+ *
+ * @brief Fit all pulses of a tube
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param tube The tube
+ * @param fits The fits in the order of the events, cleared first
+ *
+ * @return Number of fits
+ *
+ * @throw DataPresenceException if there is no template
+ */
+size_t PulseTemplateFitter::fit(const Drifttube& tube, vector<PulseFit>& fits)
+{
+	setAfterpulseStartBin(tube.getMaxDrifttime() / AnalysisConfig::current().getBinsToTime());
+	return fit(tube.getDataSet(),fits);
+}
+
+/**
+ * Sets the raw FADC value, at and beyond which samples are saturated and excluded from the fits.
+ *
+ * @brief Setter for the saturation level
+ *
+ * @param level The saturation level
+ */
+void PulseTemplateFitter::setSaturationLevel(const uint16_t level)
+{
+	m_saturation_level = level;
+}
+
+/**
+ * Getter for the saturation level.
+ *
+ * @brief Getter for the saturation level
+ *
+ * @return The raw FADC value, at and beyond which samples are saturated
+ */
+uint16_t PulseTemplateFitter::getSaturationLevel() const
+{
+	return m_saturation_level;
+}
+
+/**
+ * Sets the maximum RMS of the residuals relative to the amplitude, up to which a pulse has the shape of the template.
+ *
+ * @brief Setter for the maximum deviation
+ *
+ * @param deviation The maximum deviation
+ */
+void PulseTemplateFitter::setMaxDeviation(const float deviation)
+{
+	m_max_deviation = deviation;
+}
+
+/**
+ * Getter for the maximum deviation.
+ *
+ * @brief Getter for the maximum deviation
+ *
+ * @return The maximum RMS of the residuals relative to the amplitude
+ */
+float PulseTemplateFitter::getMaxDeviation() const
+{
+	return m_max_deviation;
+}
+
+/**
+ * Sets the first bin, from which on fits are afterpulses, usually the maximum drift time of the tube.
+ *
+ * @brief Setter for the afterpulse start bin
+ *
+ * @param bin The afterpulse start bin
+ */
+void PulseTemplateFitter::setAfterpulseStartBin(const unsigned short bin)
+{
+	m_afterpulse_start_bin = bin;
+}
+
+/**
+ * Getter for the first bin, from which on fits are afterpulses.
+ *
+ * @brief Getter for the afterpulse start bin
+ *
+ * @return The afterpulse start bin
+ */
+unsigned short PulseTemplateFitter::getAfterpulseStartBin() const
+{
+	return m_afterpulse_start_bin;
+}
+
+/**
+ * Copies the window of a pulse relative to the baseline into the scratch buffer and sets the weights, 0 for saturated
+ * samples and samples outside of the event.
+ *
+ * @param data Raw data of the event
+ * @param size Number of bins
+ * @param baseline Baseline of the event
+ * @param start First bin of the window, may be outside of the event
+ * @param saturated Set to true if a sample is saturated
+ *
+ * @return True if no sample is excluded
+ */
+bool PulseTemplateFitter::gather(const uint16_t* data, const size_t size, const float baseline, const long start, bool& saturated)
+{
+	const float sign = m_negative ? -1 : 1;
+	bool complete = true;
+	saturated = false;
+	for(size_t k = 0; k < m_length; ++k)
+	{
+		const long bin = start + (long)k;
+		bool excluded = bin < 0 || bin >= (long)size;
+		if(!excluded)
+		{
+			const uint16_t raw = data[bin];
+			excluded = m_negative ? raw <= m_saturation_level : raw >= m_saturation_level;
+			saturated |= excluded;
+		}
+		m_weights[k] = excluded ? 0 : 1;
+		m_window[k] = excluded ? 0 : sign * (data[bin] - baseline);
+		complete &= !excluded;
+	}
+	return complete;
+}
+
+/**
+ * Fits the template to one window of an event, see the class description.
+ *
+ * @param event The event
+ * @param start First bin of the window, the extremum is expected at start + pre
+ * @param piledUp True if the peak shares its pulse with other peaks
+ *
+ * @return The fit, SIGNAL for a pulse with the shape of the template
+ */
+PulseFit PulseTemplateFitter::fitWindow(const Event& event, const long start, const bool piledUp)
+{
+	PulseFit result = {event.getEventNumber(),0,(float)(start + m_pre),numeric_limits<float>::infinity(),DISTORTED,0};
+	const float* shape = m_template.data();
+	const float* derivative = m_derivative.data();
+	const float* y = m_window.data();
+	const float* w = m_weights.data();
+	long shift = start;
+	for(int iteration = 0; iteration < 2; ++iteration)
+	{
+		bool saturated;
+		const bool complete = gather(event.getData().data(),event.getSize(),event.getBaseline(),shift,saturated);
+		result.saturated = saturated;
+		float yt = 0, yd = 0, yy = 0;
+		for(size_t k = 0; k < m_length; ++k)
+		{
+			yt += y[k] * shape[k];
+			yd += y[k] * derivative[k];
+			yy += y[k] * y[k];
+		}
+		float a, b, nSamples;
+		if(complete)
+		{
+			a = m_inverse[0] * yt + m_inverse[1] * yd;
+			b = m_inverse[1] * yt + m_inverse[2] * yd;
+			nSamples = m_length;
+		}
+		else
+		{
+			//excluded samples: normal matrix of the remaining samples
+			float tt = 0, td = 0, dd = 0;
+			nSamples = 0;
+			for(size_t k = 0; k < m_length; ++k)
+			{
+				tt += w[k] * shape[k] * shape[k];
+				td += w[k] * shape[k] * derivative[k];
+				dd += w[k] * derivative[k] * derivative[k];
+				nSamples += w[k];
+			}
+			const float det = tt * dd - td * td;
+			if(nSamples < 3 || !(det > 0))
+			{
+				return result;
+			}
+			a = (dd * yt - td * yd) / det;
+			b = (tt * yd - td * yt) / det;
+		}
+		const float chi2 = yy - a * yt - b * yd;
+		const float delta = a != 0 ? -b / a : 0;
+		result.amplitude = a;
+		result.time = shift + m_pre + delta;
+		result.deviation = a > 0 ? sqrt((chi2 > 0 ? chi2 : 0) / (nSamples - 2)) / a : numeric_limits<float>::infinity();
+		if(fabs(delta) <= 0.5 || fabs(delta) > m_length)
+		{
+			break;
+		}
+		shift += lround(delta);
+	}
+	if(piledUp)
+	{
+		result.type = PILE_UP;
+	}
+	else if(result.deviation <= m_max_deviation)
+	{
+		result.type = SIGNAL;
+	}
+	return result;
+}
+
+/**
+ * Fits with the shape of the template become AFTERPULSEs, if their extremum is at or after the afterpulse start bin.
+ *
+ * @param fits The fits in the order of the events
+ * @param first Index of the first fit to classify
+ */
+void PulseTemplateFitter::classify(vector<PulseFit>& fits, const size_t first) const
+{
+	for(size_t i = first; i < fits.size(); ++i)
+	{
+		if(fits[i].type == SIGNAL && fits[i].time >= m_afterpulse_start_bin)
+		{
+			fits[i].type = AFTERPULSE;
+		}
+	}
+}
@@ -0,0 +1,105 @@
+/*
+ * PulseTemplateFitter.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef PULSETEMPLATEFITTER_H_
+#define PULSETEMPLATEFITTER_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "DataSet.h"
+#include "Drifttube.h"
+#include "Event.h"
+#include "PeakFinder.h"
+#include "AnalysisConfig.h"
+
+/**
+ * Result of fitting the pulse template to one peak.
+ *
+ * @brief Fit of one pulse
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	uint32_t event; //event number
+	float amplitude; //channels beyond the baseline
+	float time; //bin of the extremum with sub-bin resolution
+	float deviation; //RMS of the residuals relative to the amplitude
+	uint8_t type; //one of PulseTemplateFitter::Type
+	uint8_t saturated; //1 if saturated samples were excluded from the fit, else 0
+} PulseFit;
+
+/**
+ * Fits a reference pulse shape to the pulses of events, to separate afterpulses and pile-up from real signals and to
+ * recover the amplitude of saturated pulses.
+ * The template is the average shape of isolated, unsaturated pulses, aligned at their extremum and normalised to an
+ * amplitude of 1 (see buildTemplate(...)). A pulse y is fitted as A * T(k - d) with amplitude A and time shift d. The model
+ * is linearised with the derivative T' of the template, y = a * T + b * T' with a = A and b = -A * d, so that each fit is
+ * a linear least-squares solve. The derivative and the inverse normal matrix depend on the template only and are
+ * computed once. A fit then costs the dot products of the pulse with T and T', which are vectorised. The shift is
+ * refined once if it exceeds half a bin.
+ * Saturated samples and samples outside of the event are excluded from the fit. For those pulses the normal matrix is
+ * computed with the remaining samples. The fitted amplitude of a saturated pulse then exceeds the range of the FADC.
+ * Each fit is classified: peaks sharing a pulse are PILE_UP (see PeakFinder), fits deviating by more than the maximum
+ * deviation are DISTORTED. The remaining fits are AFTERPULSEs from the afterpulse start bin on, usually the maximum drift
+ * time of the tube as in DataProcessor::countAfterpulses(...), and SIGNALs before it.
+ *
+ * @brief Batched fit of a pulse template
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @warning A fitter is not thread safe, use one fitter per thread.
+ */
+class PulseTemplateFitter
+{
+public:
+	PulseTemplateFitter(const unsigned int length = 64, const unsigned int pre = 8, const bool negative = AnalysisConfig::current().isNegative());
+	~PulseTemplateFitter();
+
+	size_t buildTemplate(const DataSet& data);
+	void setTemplate(const std::vector<float>& shape);
+	const std::vector<float>& getTemplate() const;
+
+	size_t fit(const Event& event, const std::vector<Peak>& peaks, std::vector<PulseFit>& fits);
+	size_t fit(const DataSet& data, std::vector<PulseFit>& fits);
+	size_t fit(const Drifttube& tube, std::vector<PulseFit>& fits);
+
+	void setSaturationLevel(const uint16_t level);
+	uint16_t getSaturationLevel() const;
+	void setMaxDeviation(const float deviation);
+	float getMaxDeviation() const;
+	void setAfterpulseStartBin(const unsigned short bin);
+	unsigned short getAfterpulseStartBin() const;
+
+	enum Type : uint8_t {SIGNAL, AFTERPULSE, PILE_UP, DISTORTED};
+
+private:
+	bool gather(const uint16_t* data, const size_t size, const float baseline, const long start, bool& saturated);
+	PulseFit fitWindow(const Event& event, const long start, const bool piledUp);
+	void classify(std::vector<PulseFit>& fits, const size_t first) const;
+
+	unsigned int m_length; //bins of the template
+	unsigned int m_pre; //bins before the extremum
+	bool m_negative;
+	uint16_t m_saturation_level; //raw FADC value
+	float m_max_deviation;
+	unsigned short m_afterpulse_start_bin;
+	std::vector<float> m_template;
+	std::vector<float> m_derivative;
+	float m_inverse[3]; //inverse normal matrix of the template: [TT], [TD], [DD]
+	std::vector<float> m_window; //signal of the pulse relative to the baseline
+	std::vector<float> m_weights; //0 for excluded samples, else 1
+	PeakFinder m_finder;
+	std::vector<Peak> m_peaks;
+};
+
+#endif /* PULSETEMPLATEFITTER_H_ */
@@ -0,0 +1,181 @@
+/*
+ * RealFFT.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "RealFFT.h"
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Constructor. Precomputes the twiddle factors and the bit reversal permutation.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param length Number of real samples, a power of 2 and at least 4
+ *
+ * @throw invalid_argument if the length is not a power of 2
+ */
+RealFFT::RealFFT(const size_t length)
+{
+	if(length < 4 || (length & (length - 1)) != 0)
+	{
+		throw invalid_argument("RealFFT: length must be a power of 2 and at least 4");
+	}
+	m_length = length;
+	const size_t half = length / 2;
+	m_twiddles.resize(half);
+	for(size_t k = 0; k < half; ++k)
+	{
+		const double phase = -2 * M_PI * k / length;
+		m_twiddles[k] = complex<float>(cos(phase),sin(phase));
+	}
+	m_reversed.resize(half);
+	size_t bits = 0;
+	while(((size_t)1 << bits) < half)
+	{
+		++bits;
+	}
+	for(size_t i = 0; i < half; ++i)
+	{
+		size_t reversed = 0;
+		for(size_t b = 0; b < bits; ++b)
+		{
+			reversed |= ((i >> b) & 1) << (bits - 1 - b);
+		}
+		m_reversed[i] = reversed;
+	}
+	m_buffer.resize(half);
+	m_spectrum.resize(half + 1);
+}
+
+RealFFT::~RealFFT()
+{
+}
+
+/**
+ * Transforms real data.
+ *
+ * @brief Transform
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param input length real samples
+ * @param output length / 2 + 1 frequency bins from 0 to the Nyquist frequency, sum over x[j] * exp(-2 pi i j k / length)
+ */
+void RealFFT::transform(const float* input, complex<float>* output)
+{
+	const size_t half = m_length / 2;
+	//pack even samples to the real and odd samples to the imaginary part, in bit reversed order
+	for(size_t i = 0; i < half; ++i)
+	{
+		const size_t j = m_reversed[i];
+		m_buffer[i] = complex<float>(input[2 * j],input[2 * j + 1]);
+	}
+	fft();
+	//split the transform of the packed data into the transforms of even and odd samples
+	output[0] = complex<float>(m_buffer[0].real() + m_buffer[0].imag(),0);
+	output[half] = complex<float>(m_buffer[0].real() - m_buffer[0].imag(),0);
+	for(size_t k = 1; k < half; ++k)
+	{
+		const complex<float> z = m_buffer[k];
+		const complex<float> zc = conj(m_buffer[half - k]);
+		const complex<float> even = 0.5f * (z + zc);
+		const complex<float> odd = complex<float>(0,-0.5f) * (z - zc);
+		output[k] = even + m_twiddles[k] * odd;
+	}
+}
+
+/**
+ * Power spectrum of real data.
+ *
+ * @brief Power spectrum
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param input length real samples
+ * @param spectrum length / 2 + 1 squared magnitudes of the transform
+ */
+void RealFFT::power(const float* input, float* spectrum)
+{
+	for(size_t k = 0; k <= m_length / 2; ++k)
+	{
+		spectrum[k] = 0;
+	}
+	addPower(input,1,0,spectrum);
+}
+
+/**
+ * Adds the power spectra of a batch of segments to a spectrum, e.g. to average the spectra of many segments.
+ *
+ * @brief Accumulate power spectra
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param input First sample of the first segment
+ * @param nSegments Number of segments
+ * @param stride Distance between the first samples of two segments
+ * @param spectrum length / 2 + 1 bins, the squared magnitudes are added
+ */
+void RealFFT::addPower(const float* input, const size_t nSegments, const size_t stride, float* spectrum)
+{
+	const size_t nBins = m_length / 2 + 1;
+	for(size_t s = 0; s < nSegments; ++s)
+	{
+		transform(input + s * stride,m_spectrum.data());
+		for(size_t k = 0; k < nBins; ++k)
+		{
+			spectrum[k] += norm(m_spectrum[k]);
+		}
+	}
+}
+
+/**
+ * Getter for the length.
+ *
+ * @brief Getter for the length
+ *
+ * @return Number of real samples
+ */
+size_t RealFFT::getLength() const
+{
+	return m_length;
+}
+
+/**
+ * In place radix-2 decimation in time FFT of the bit reversed buffer. The twiddle factors of the full length are used
+ * with a stride of 2, as they are the twiddle factors of half the length.
+ */
+void RealFFT::fft()
+{
+	const size_t n = m_length / 2;
+	complex<float>* data = m_buffer.data();
+	for(size_t size = 2; size <= n; size *= 2)
+	{
+		const size_t halfSize = size / 2;
+		const size_t step = m_length / size;
+		for(size_t start = 0; start < n; start += size)
+		{
+			for(size_t j = 0; j < halfSize; ++j)
+			{
+				const complex<float> t = m_twiddles[j * step] * data[start + j + halfSize];
+				data[start + j + halfSize] = data[start + j] - t;
+				data[start + j] += t;
+			}
+		}
+	}
+}
@@ -0,0 +1,51 @@
+/*
+ * RealFFT.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef REALFFT_H_
+#define REALFFT_H_
+
+#include <vector>
+#include <complex>
+#include <cstddef>
+
+/**
+ * Fast Fourier transform of real data with a length that is a power of 2. The n real samples are packed into n/2 complex
+ * samples, transformed by an iterative radix-2 FFT of half the length and split into the spectrum of the real data.
+ * Twiddle factors and the bit reversal permutation are computed once in the constructor, the transforms of many
+ * segments reuse them and the scratch buffer, so they do not allocate.
+ *
+ * @brief FFT of real data
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @warning An FFT is not thread safe, use one FFT per thread.
+ */
+class RealFFT
+{
+public:
+	RealFFT(const size_t length);
+	~RealFFT();
+
+	void transform(const float* input, std::complex<float>* output);
+	void power(const float* input, float* spectrum);
+	void addPower(const float* input, const size_t nSegments, const size_t stride, float* spectrum);
+
+	size_t getLength() const;
+
+private:
+	void fft();
+
+	size_t m_length; //number of real samples
+	std::vector<std::complex<float>> m_twiddles; //exp(-2 pi i k / length) for k < length / 2
+	std::vector<size_t> m_reversed; //bit reversal permutation of length / 2
+	std::vector<std::complex<float>> m_buffer;
+	std::vector<std::complex<float>> m_spectrum;
+};
+
+#endif /* REALFFT_H_ */
@@ -0,0 +1,251 @@
+/*
+ * RtCalibrator.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "RtCalibrator.h"
+#include "LegendreTrackFinder.h"
+#include <cmath>
+#include <map>
+
+using namespace std;
+
+/**
+ * Constructor. Copies the start values of the rt-relations, the passed rt-relations are not changed. Tubes with the
+ * same start rt-relation share one calibrated rt-relation.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param hits Trigger aligned hits of all tubes, must outlive the calibrator
+ * @param rtRelations Start values of the rt-relations, one per tube in the order of hits
+ * @param radius Radius of the tubes in mm, the upper limit of every rt-relation
+ */
+RtCalibrator::RtCalibrator(const TriggerEventCollection& hits, const vector<const RtRelation*>& rtRelations, const double radius)
+: m_hits(hits)
+{
+	map<const RtRelation*,unsigned int> copies;
+	for(const RtRelation* rtRelation : rtRelations)
+	{
+		if(copies.find(rtRelation) == copies.end())
+		{
+			copies[rtRelation] = m_rt_relations.size();
+			m_rt_relations.push_back(unique_ptr<RtRelation>(new RtRelation(*rtRelation)));
+		}
+		m_rt_index.push_back(copies[rtRelation]);
+	}
+	m_radius = radius;
+	m_n_tracks = 0;
+}
+
+RtCalibrator::~RtCalibrator()
+{
+}
+
+/**
+ * Performs one calibration iteration. The triggers are processed in parallel, each thread fills its own residual
+ * histograms, which are merged afterwards. Only drift time bins with at least MIN_ENTRIES residuals are corrected, the
+ * corrected rt-relations are kept monotonic and within [0,radius].
+ *
+ * @brief One calibration iteration
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @return Largest absolute correction of any rt-relation bin in mm
+ */
+double RtCalibrator::iterate()
+{
+	const long nTriggers = m_hits.getNumberOfTriggers();
+	const size_t nTubes = m_hits.getNumberOfTubes();
+	const vector<array<double,2>>& positions = m_hits.getTubePositions();
+	size_t nBins = 0;
+	for(const unique_ptr<RtRelation>& rtRelation : m_rt_relations)
+	{
+		nBins = rtRelation->getSize() > nBins ? rtRelation->getSize() : nBins;
+	}
+
+	const size_t nRt = m_rt_relations.size();
+	vector<double> sums(nRt * nBins,0.0);
+	vector<unsigned int> counts(nRt * nBins,0);
+	double sumSquares = 0;
+	unsigned long nResiduals = 0;
+	unsigned int nTracks = 0;
+
+	const double binWidth = AnalysisConfig::current().getSpectrumBinWidth();
+	#pragma omp parallel
+	{
+		vector<double> threadSums(nRt * nBins,0.0);
+		vector<unsigned int> threadCounts(nRt * nBins,0);
+		vector<DriftCircle> circles(nTubes);
+		vector<unsigned int> circleTubes(nTubes);
+		LegendreTrackFinder finder;
+		double threadSumSquares = 0;
+		unsigned long threadResiduals = 0;
+		unsigned int threadTracks = 0;
+
+		#pragma omp for schedule(static,1024)
+		for(long trigger = 0; trigger < nTriggers; ++trigger)
+		{
+			const Hit* hits = m_hits.getHits(trigger);
+			size_t n = 0;
+			for(size_t tube = 0; tube < nTubes; ++tube)
+			{
+				if(TriggerEventCollection::isHit(hits[tube]))
+				{
+					circles[n].x = positions[tube][0];
+					circles[n].y = positions[tube][1];
+					circles[n].radius = Track::driftRadius(*m_rt_relations[m_rt_index[tube]],hits[tube].driftTime);
+					circleTubes[n] = tube;
+					++n;
+				}
+			}
+			if(n < 3)
+			{
+				continue;
+			}
+			Track track = n <= TRACK_MAX_COMBINATORIAL_HITS ? Track::fit(circles.data(),n) : finder.find(circles.data(),n);
+			if(!track.isValid())
+			{
+				continue;
+			}
+			++threadTracks;
+			for(size_t i = 0; i < n; ++i)
+			{
+				double residual = track.residual(circles[i]);
+				unsigned int rtIndex = m_rt_index[circleTubes[i]];
+				size_t bin = (size_t)lround(hits[circleTubes[i]].driftTime / binWidth);
+				if(fabs(residual) >= TRACK_HIT_WINDOW || bin >= m_rt_relations[rtIndex]->getSize())
+				{
+					continue;
+				}
+				threadSums[rtIndex * nBins + bin] += residual;
+				++threadCounts[rtIndex * nBins + bin];
+				threadSumSquares += residual * residual;
+				++threadResiduals;
+			}
+		}
+
+		#pragma omp critical
+		{
+			for(size_t i = 0; i < sums.size(); ++i)
+			{
+				sums[i] += threadSums[i];
+				counts[i] += threadCounts[i];
+			}
+			sumSquares += threadSumSquares;
+			nResiduals += threadResiduals;
+			nTracks += threadTracks;
+		}
+	}
+
+	double maxCorrection = 0;
+	for(size_t index = 0; index < nRt; ++index)
+	{
+		RtRelation& rt = *m_rt_relations[index];
+		for(size_t bin = 0; bin < rt.getSize(); ++bin)
+		{
+			if(counts[index * nBins + bin] >= MIN_ENTRIES)
+			{
+				double correction = sums[index * nBins + bin] / counts[index * nBins + bin];
+				rt[bin] += correction;
+				maxCorrection = fabs(correction) > maxCorrection ? fabs(correction) : maxCorrection;
+			}
+			rt[bin] = rt[bin] < 0 ? 0 : (rt[bin] > m_radius ? m_radius : rt[bin]);
+			if(bin > 0 && rt[bin] < rt[bin - 1])
+			{
+				rt[bin] = rt[bin - 1];
+			}
+		}
+	}
+
+	m_residual_rms.push_back(nResiduals > 0 ? sqrt(sumSquares / nResiduals) : 0);
+	m_n_tracks = nTracks;
+
+	return maxCorrection;
+}
+
+/**
+ * Iterates until the largest correction is below the tolerance or the maximum number of iterations is reached.
+ *
+ * @brief Calibrate the rt-relations
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param maxIterations Maximum number of iterations
+ * @param tolerance Largest correction in mm, below which the calibration is converged
+ * @return Number of iterations done
+ */
+unsigned int RtCalibrator::calibrate(const unsigned int maxIterations, const double tolerance)
+{
+	for(unsigned int iteration = 1; iteration <= maxIterations; ++iteration)
+	{
+		if(iterate() < tolerance)
+		{
+			return iteration;
+		}
+	}
+	return maxIterations;
+}
+
+/**
+ * Getter for the current rt-relation of a tube.
+ *
+ * @brief Getter for an rt-relation
+ *
+ * @param tube Index of the tube
+ * @return Const reference to the rt-relation
+ */
+const RtRelation& RtCalibrator::getRtRelation(const unsigned int tube) const
+{
+	return *m_rt_relations[m_rt_index[tube]];
+}
+
+/**
+ * Getter for the current rt-relations of all tubes, in the form DataProcessor::reconstructTracks(...) expects them.
+ *
+ * @brief Getter for all rt-relations
+ *
+ * @return Pointers to the rt-relations of all tubes, valid as long as the calibrator exists
+ */
+vector<const RtRelation*> RtCalibrator::getRtRelations() const
+{
+	vector<const RtRelation*> result;
+	for(unsigned int index : m_rt_index)
+	{
+		result.push_back(m_rt_relations[index].get());
+	}
+	return result;
+}
+
+/**
+ * Getter for the RMS of the residuals of every iteration done so far, measured before the correction of the iteration.
+ *
+ * @brief Getter for the residual RMS
+ *
+ * @return RMS values in mm
+ */
+const vector<double>& RtCalibrator::getResidualRMS() const
+{
+	return m_residual_rms;
+}
+
+/**
+ * Getter for the number of tracks fitted in the last iteration.
+ *
+ * @brief Getter for the number of tracks
+ *
+ * @return Number of tracks
+ */
+unsigned int RtCalibrator::getNumberOfTracks() const
+{
+	return m_n_tracks;
+}
@@ -0,0 +1,57 @@
+/*
+ * RtCalibrator.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef RTCALIBRATOR_H_
+#define RTCALIBRATOR_H_
+
+#include <vector>
+#include <memory>
+#include "RtRelation.h"
+#include "TriggerEventCollection.h"
+#include "globals.h"
+#include "AnalysisConfig.h"
+
+/**
+ * Autocalibration of the rt-relations of all tubes from reconstructed tracks. In each iteration the tracks of all
+ * triggers are fitted with the current rt-relations, the residuals (distance of the track to the wire minus drift
+ * radius) are histogrammed against the drift time for each tube and the mean residual of each drift time bin is added to
+ * the rt-relation. This is repeated until the corrections become smaller than a tolerance.
+ * Tubes that are passed the same start rt-relation are calibrated together with the residuals of all of them.
+ * All iterations work on the compact hit records of a TriggerEventCollection, no waveform is read again.
+ *
+ * @brief Iterative rt-relation calibration
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+class RtCalibrator
+{
+public:
+	RtCalibrator(const TriggerEventCollection& hits, const std::vector<const RtRelation*>& rtRelations, const double radius = AnalysisConfig::current().getTubeRadius());
+	~RtCalibrator();
+
+	double iterate();
+	unsigned int calibrate(const unsigned int maxIterations = 20, const double tolerance = 0.005);
+
+	const RtRelation& getRtRelation(const unsigned int tube) const;
+	std::vector<const RtRelation*> getRtRelations() const;
+	const std::vector<double>& getResidualRMS() const;
+	unsigned int getNumberOfTracks() const;
+
+	static const unsigned int MIN_ENTRIES = 20;
+
+private:
+	const TriggerEventCollection& m_hits;
+	std::vector<std::unique_ptr<RtRelation>> m_rt_relations;
+	std::vector<unsigned int> m_rt_index; //index in m_rt_relations for each tube
+	double m_radius; //mm
+	std::vector<double> m_residual_rms; //mm, one entry per iteration
+	unsigned int m_n_tracks;
+};
+
+#endif /* RTCALIBRATOR_H_ */
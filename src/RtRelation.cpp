@@ -6,6 +6,7 @@
  */
 
 #include "RtRelation.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -69,3 +70,49 @@ RtRelation& RtRelation::operator=(const RtRelation& rhs)
 
 	return *this;
 }
+
+/**
+ * Finds the first bin, at which the drift radius reaches a given radius. The rt-relation is the integral of a drift time
+ * spectrum and thus monotonically increasing, the bin is found by a binary search.
+ *
+ * @brief Drift time bin of a radius
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param radius Drift radius in mm
+ * @return First bin with a radius >= radius, getSize() if the radius is never reached
+ */
+size_t RtRelation::findBin(const double radius) const
+{
+	return lower_bound(m_data.begin(),m_data.end(),radius) - m_data.begin();
+}
+
+/**
+ * Finds the first bins, at which the drift radius reaches each of a list of ascending radii, see findBin(...). All radii
+ * are found in a single pass over the rt-relation.
+ *
+ * @brief Drift time bins of many radii
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param radii Ascending drift radii in mm
+ * @param bins Set to the bin of each radius, getSize() for radii that are never reached
+ */
+void RtRelation::findBins(const vector<double>& radii, vector<size_t>& bins) const
+{
+	const vector<double>& rt = m_data;
+	bins.resize(radii.size());
+	size_t bin = 0;
+	for(size_t i = 0; i < radii.size(); ++i)
+	{
+		while(bin < rt.size() && rt[bin] < radii[i])
+		{
+			++bin;
+		}
+		bins[i] = bin;
+	}
+}
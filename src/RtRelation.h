@@ -11,6 +11,7 @@
 #include "Data.h"
 #include "globals.h"
 #include <iostream>
+#include <vector>
 
 //TODO Change all doc to vector and variable length (Nov. 14, 2018)
 
@@ -24,6 +25,9 @@ public:
 	virtual ~RtRelation();
 
 	RtRelation& operator=(const RtRelation& rhs);
+
+	size_t findBin(const double radius) const;
+	void findBins(const std::vector<double>& radii, std::vector<size_t>& bins) const;
 };
 
 #endif /* RTRELATION_H_ */
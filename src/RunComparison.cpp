@@ -0,0 +1,457 @@
+/*
+ * RunComparison.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "RunComparison.h"
+#include "Archive.h"
+#include "AnalysisConfig.h"
+#include "DataPresenceException.h"
+#include <omp.h>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Number of entries of a spectrum, the sum of its bins.
+ *
+ * @param spectrum The spectrum
+ * @return Sum of the bins
+ */
+static double countEntries(const DriftTimeSpectrum& spectrum)
+{
+	double entries = 0;
+	for(uint32_t content : spectrum.getData())
+	{
+		entries += content;
+	}
+	return entries;
+}
+
+/**
+ * Constructor for a comparison without runs.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+RunComparison::RunComparison()
+{
+}
+
+RunComparison::~RunComparison()
+{
+}
+
+/**
+ * Reads a list of data files, one path per line. Empty lines and lines starting with # are skipped.
+ *
+ * @brief Read a list of runs
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param filename Path to the list
+ * @return Paths of the data files
+ *
+ * @throw DataPresenceException if the list cannot be read
+ */
+vector<string> RunComparison::readList(const string& filename)
+{
+	ifstream file(filename);
+	if(!file.is_open())
+	{
+		throw DataPresenceException();
+	}
+	vector<string> filenames;
+	string line;
+	while(getline(file,line))
+	{
+		const size_t begin = line.find_first_not_of(" \t\r");
+		if(begin == string::npos || line[begin] == '#')
+		{
+			continue;
+		}
+		const size_t end = line.find_last_not_of(" \t\r");
+		filenames.push_back(line.substr(begin,end - begin + 1));
+	}
+	return filenames;
+}
+
+/**
+ * Loads runs from data files in parallel, each thread converts one file at a time with the current AnalysisConfig.
+ * The runs are added in the order of the list. Files that cannot be read or contain no tubes are not added, see
+ * getFailed().
+ *
+ * @brief Load runs in parallel
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param filenames Paths of the data files
+ * @param geometryFilename Chamber geometry of all runs, see Archive
+ */
+void RunComparison::load(const vector<string>& filenames, const string& geometryFilename)
+{
+	const long nFiles = filenames.size();
+	vector<unique_ptr<RunResult>> results(nFiles);
+	#pragma omp parallel for schedule(dynamic)
+	for(long i = 0; i < nFiles; ++i)
+	{
+		try
+		{
+			Archive archive(filenames[i],false,geometryFilename);
+			if(!archive.getTubes().empty())
+			{
+				results[i].reset(new RunResult(summarize(filenames[i],archive.getTubes())));
+			}
+		}
+		catch(Exception& e)
+		{
+			//reported by getFailed()
+		}
+	}
+	for(long i = 0; i < nFiles; ++i)
+	{
+		if(results[i])
+		{
+			m_runs.push_back(move(*results[i]));
+		}
+		else
+		{
+			m_failed.push_back(filenames[i]);
+		}
+	}
+}
+
+/**
+ * Adds a run from its tubes, e.g. of an Archive that is already loaded.
+ *
+ * @brief Add a run
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param filename Name of the run
+ * @param tubes Tubes of the run
+ */
+void RunComparison::add(const string& filename, const vector<unique_ptr<Drifttube>>& tubes)
+{
+	m_runs.push_back(summarize(filename,tubes));
+}
+
+/**
+ * Compares every run with a reference run, tube by tube, see the class description. Runs with different numbers of
+ * tubes are compared for the tubes they have in common. The comparisons are computed in parallel.
+ *
+ * @brief Compare all runs with a reference
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param reference Index of the reference run
+ * @return Differences ordered by run and tube, without the reference run
+ *
+ * @throw invalid_argument if there is no run with the index reference
+ */
+vector<RunDifference> RunComparison::compare(const size_t reference) const
+{
+	if(reference >= m_runs.size())
+	{
+		throw invalid_argument("RunComparison: reference run does not exist");
+	}
+	const RunResult& base = m_runs[reference];
+	vector<RunDifference> differences;
+	for(size_t run = 0; run < m_runs.size(); ++run)
+	{
+		const size_t nTubes = min(base.spectra.size(),m_runs[run].spectra.size());
+		for(size_t tube = 0; tube < nTubes && run != reference; ++tube)
+		{
+			RunDifference difference = {run,tube,0,0,0,0,0};
+			differences.push_back(difference);
+		}
+	}
+	const long nDifferences = differences.size();
+	#pragma omp parallel for schedule(dynamic)
+	for(long i = 0; i < nDifferences; ++i)
+	{
+		RunDifference& difference = differences[i];
+		const RunResult& other = m_runs[difference.run];
+		const DriftTimeSpectrum& first = base.spectra[difference.tube];
+		const DriftTimeSpectrum& second = other.spectra[difference.tube];
+		difference.chi2 = chiSquare(first,second,difference.ndf);
+		difference.ksDistance = kolmogorovDistance(first,second);
+		difference.ksProbability = kolmogorovProbability(difference.ksDistance,countEntries(first),countEntries(second));
+		difference.rtDifference = rtDifference(base.rtRelations[difference.tube],other.rtRelations[difference.tube]);
+	}
+	return differences;
+}
+
+/**
+ * Getter for the loaded runs.
+ *
+ * @brief Getter for the runs
+ *
+ * @return Runs in the order they were loaded or added
+ */
+const vector<RunResult>& RunComparison::getRuns() const
+{
+	return m_runs;
+}
+
+/**
+ * Getter for the files that could not be loaded.
+ *
+ * @brief Getter for the failed files
+ *
+ * @return Paths of the files
+ */
+const vector<string>& RunComparison::getFailed() const
+{
+	return m_failed;
+}
+
+/**
+ * Chi2 test of two drift time spectra with different numbers of entries, sum over (N2 * n1 - N1 * n2)^2 / (n1 + n2)
+ * / (N1 * N2) for all bins with entries. This is the test of the normalised spectra, as done with the ROOT macros.
+ *
+ * @brief Chi2 of two spectra
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param first First spectrum
+ * @param second Second spectrum
+ * @param ndf Set to the degrees of freedom, the number of bins with entries minus one
+ * @return chi2, 0 if one spectrum is empty
+ */
+double RunComparison::chiSquare(const DriftTimeSpectrum& first, const DriftTimeSpectrum& second, unsigned int& ndf)
+{
+	const vector<uint32_t>& a = first.getData();
+	const vector<uint32_t>& b = second.getData();
+	const size_t nBins = max(a.size(),b.size());
+	const double entries[2] = {countEntries(first),countEntries(second)};
+	ndf = 0;
+	if(entries[0] == 0 || entries[1] == 0)
+	{
+		return 0;
+	}
+	double chi2 = 0;
+	unsigned int filled = 0;
+	for(size_t i = 0; i < nBins; ++i)
+	{
+		const double n1 = i < a.size() ? a[i] : 0;
+		const double n2 = i < b.size() ? b[i] : 0;
+		if(n1 + n2 > 0)
+		{
+			const double difference = entries[1] * n1 - entries[0] * n2;
+			chi2 += difference * difference / (n1 + n2);
+			++filled;
+		}
+	}
+	ndf = filled > 0 ? filled - 1 : 0;
+	return chi2 / (entries[0] * entries[1]);
+}
+
+/**
+ * Kolmogorov-Smirnov distance of two drift time spectra, the maximum distance of their normalised cumulative spectra.
+ *
+ * @brief KS distance of two spectra
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param first First spectrum
+ * @param second Second spectrum
+ * @return Distance between 0 and 1, 0 if one spectrum is empty
+ */
+double RunComparison::kolmogorovDistance(const DriftTimeSpectrum& first, const DriftTimeSpectrum& second)
+{
+	const vector<uint32_t>& a = first.getData();
+	const vector<uint32_t>& b = second.getData();
+	const size_t nBins = max(a.size(),b.size());
+	const double entries[2] = {countEntries(first),countEntries(second)};
+	if(entries[0] == 0 || entries[1] == 0)
+	{
+		return 0;
+	}
+	double cumulative[2] = {0,0};
+	double distance = 0;
+	for(size_t i = 0; i < nBins; ++i)
+	{
+		cumulative[0] += i < a.size() ? a[i] : 0;
+		cumulative[1] += i < b.size() ? b[i] : 0;
+		distance = max(distance,fabs(cumulative[0] / entries[0] - cumulative[1] / entries[1]));
+	}
+	return distance;
+}
+
+/**
+ * Probability to find a Kolmogorov-Smirnov distance at least this large for two samples of the same distribution,
+ * with the asymptotic Kolmogorov distribution and the effective number of entries N1 * N2 / (N1 + N2).
+ *
+ * @brief KS probability
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param distance Kolmogorov-Smirnov distance
+ * @param first Entries of the first spectrum
+ * @param second Entries of the second spectrum
+ * @return Probability between 0 and 1, 1 without entries
+ */
+double RunComparison::kolmogorovProbability(const double distance, const double first, const double second)
+{
+	if(first <= 0 || second <= 0)
+	{
+		return 1;
+	}
+	const double entries = sqrt(first * second / (first + second));
+	const double lambda = (entries + 0.12 + 0.11 / entries) * distance;
+	//the series does not converge for small lambda, where the probability is 1
+	if(lambda < 0.2)
+	{
+		return 1;
+	}
+	double probability = 0;
+	double sign = 1;
+	for(int k = 1; k <= 100; ++k)
+	{
+		const double term = sign * 2 * exp(-2 * k * k * lambda * lambda);
+		probability += term;
+		if(fabs(term) < 1e-10 * probability)
+		{
+			break;
+		}
+		sign = -sign;
+	}
+	return probability < 0 ? 0 : (probability > 1 ? 1 : probability);
+}
+
+/**
+ * Maximum difference of two rt-relations over the bins they have in common.
+ *
+ * @brief Difference of two rt-relations
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param first First rt-relation
+ * @param second Second rt-relation
+ * @return Maximum difference of the radii in mm
+ */
+double RunComparison::rtDifference(const RtRelation& first, const RtRelation& second)
+{
+	const size_t nBins = min(first.getSize(),second.getSize());
+	const vector<double>& a = first.getData();
+	const vector<double>& b = second.getData();
+	double difference = 0;
+	for(size_t i = 0; i < nBins; ++i)
+	{
+		difference = max(difference,fabs(a[i] - b[i]));
+	}
+	return difference;
+}
+
+/**
+ * Deviation of an rt-relation from a straight line, like rootscripts/checkRtLinearity.cpp. A line r = p0 + p1 * t is
+ * fitted to the rt-relation from fitStart up to the time, where fitEndRadius is reached. For the radii step, 2 * step, ...
+ * below the radius of the tube, the deviation is (t - tLinear) / tLinear, with the drift time t, at which the radius is
+ * reached, and the drift time tLinear of the line. The drift times of all radii are found in one pass over the
+ * rt-relation, see RtRelation::findBins(...).
+ *
+ * @brief Linearity of an rt-relation
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param rt The rt-relation
+ * @param radius Radius of the tube in mm
+ * @param deviations Set to the relative deviation for every radius, NaN for radii that are never reached or before the
+ * line starts, empty if the line cannot be fitted
+ * @param step Distance of the radii in mm
+ * @param fitStart Start of the fit in ns
+ * @param fitEndRadius Radius in mm, up to which the line is fitted
+ */
+void RunComparison::linearity(const RtRelation& rt, const double radius, vector<double>& deviations, const double step,
+		const double fitStart, const double fitEndRadius)
+{
+	deviations.clear();
+	if(!(step > 0))
+	{
+		throw invalid_argument("RunComparison: the step of the radii must be positive");
+	}
+	const double binWidth = AnalysisConfig::current().getSpectrumBinWidth();
+	const size_t startBin = (size_t)ceil(fitStart / binWidth);
+	const size_t endBin = rt.findBin(fitEndRadius);
+	double s = 0, st = 0, stt = 0, sr = 0, str = 0;
+	for(size_t i = startBin; i < endBin; ++i)
+	{
+		const double t = i * binWidth;
+		s += 1;
+		st += t;
+		stt += t * t;
+		sr += rt[i];
+		str += t * rt[i];
+	}
+	const double det = s * stt - st * st;
+	if(!(det > 0))
+	{
+		return;
+	}
+	const double slope = (s * str - st * sr) / det;
+	const double intercept = (stt * sr - st * str) / det;
+	if(!(slope > 0))
+	{
+		return;
+	}
+
+	vector<double> radii;
+	for(size_t k = 1; k * step < radius; ++k)
+	{
+		radii.push_back(k * step);
+	}
+	vector<size_t> bins;
+	rt.findBins(radii,bins);
+	deviations.resize(radii.size());
+	for(size_t k = 0; k < radii.size(); ++k)
+	{
+		const double linear = (radii[k] - intercept) / slope;
+		deviations[k] = bins[k] < rt.getSize() && linear > 0 ? (bins[k] * binWidth - linear) / linear : NAN;
+	}
+}
+
+/**
+ * Keeps the drift time spectra and rt-relations of the tubes of a run.
+ *
+ * @param filename Name of the run
+ * @param tubes Tubes of the run
+ * @return Results of the run
+ */
+RunResult RunComparison::summarize(const string& filename, const vector<unique_ptr<Drifttube>>& tubes)
+{
+	RunResult result;
+	result.filename = filename;
+	for(const unique_ptr<Drifttube>& tube : tubes)
+	{
+		result.spectra.push_back(tube->getDriftTimeSpectrum());
+		result.rtRelations.push_back(tube->getRtRelation());
+		result.radii.push_back(tube->getRadius() / 1000.0);
+	}
+	return result;
+}
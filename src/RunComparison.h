@@ -0,0 +1,99 @@
+/*
+ * RunComparison.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef RUNCOMPARISON_H_
+#define RUNCOMPARISON_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "DriftTimeSpectrum.h"
+#include "RtRelation.h"
+#include "Drifttube.h"
+
+/**
+ * Results of one run, that are needed for comparisons with other runs.
+ *
+ * @brief Results of a run
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	std::string filename;
+	std::vector<DriftTimeSpectrum> spectra; //per tube
+	std::vector<RtRelation> rtRelations; //per tube
+	std::vector<double> radii; //per tube, mm
+} RunResult;
+
+/**
+ * Differences of one tube between a run and the reference run.
+ *
+ * @brief Difference between two runs
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	size_t run;
+	size_t tube;
+	double chi2; //of the normalised drift time spectra
+	unsigned int ndf;
+	double ksDistance; //maximum distance of the normalised cumulative drift time spectra
+	double ksProbability;
+	double rtDifference; //maximum difference of the rt-relations, mm
+} RunDifference;
+
+/**
+ * Comparison of many runs, e.g. of a scan of gas mixtures, replacing the ROOT macros in rootscripts that compare
+ * processed files one by one. The runs are loaded in parallel, one Archive per thread. Only the drift time spectra and
+ * rt-relations of the tubes are kept, the Events are dropped as soon as a run is loaded.
+ * Every run is compared to a reference run, tube by tube:
+ * - chi2 test of the drift time spectra for two histograms with different numbers of entries
+ * - Kolmogorov-Smirnov distance and probability of the drift time spectra
+ * - maximum difference of the rt-relations
+ * The linearity of an rt-relation (see linearity(...)) is found with one pass over the rt-relation for all radii.
+ *
+ * @brief Comparison of many runs
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+class RunComparison
+{
+public:
+	RunComparison();
+	~RunComparison();
+
+	static std::vector<std::string> readList(const std::string& filename);
+	void load(const std::vector<std::string>& filenames, const std::string& geometryFilename = "");
+	void add(const std::string& filename, const std::vector<std::unique_ptr<Drifttube>>& tubes);
+	std::vector<RunDifference> compare(const size_t reference = 0) const;
+
+	const std::vector<RunResult>& getRuns() const;
+	const std::vector<std::string>& getFailed() const;
+
+	static double chiSquare(const DriftTimeSpectrum& first, const DriftTimeSpectrum& second, unsigned int& ndf);
+	static double kolmogorovDistance(const DriftTimeSpectrum& first, const DriftTimeSpectrum& second);
+	static double kolmogorovProbability(const double distance, const double first, const double second);
+	static double rtDifference(const RtRelation& first, const RtRelation& second);
+	static void linearity(const RtRelation& rt, const double radius, std::vector<double>& deviations, const double step = 0.1,
+			const double fitStart = 25, const double fitEndRadius = 8);
+
+private:
+	static RunResult summarize(const std::string& filename, const std::vector<std::unique_ptr<Drifttube>>& tubes);
+
+	std::vector<RunResult> m_runs;
+	std::vector<std::string> m_failed; //files that could not be read
+};
+
+#endif /* RUNCOMPARISON_H_ */
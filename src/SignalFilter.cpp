@@ -0,0 +1,471 @@
+/*
+ * SignalFilter.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "SignalFilter.h"
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Limits a filtered value to the range of the FADC.
+ *
+ * @param value Filtered value including the offset
+ * @return The value as FADC value
+ */
+static inline uint16_t toSample(const float value)
+{
+	const float rounded = value + 0.5f;
+	return rounded < 0 ? 0 : (rounded > UINT16_MAX ? UINT16_MAX : (uint16_t)rounded);
+}
+
+/**
+ * Converts a parsed parameter to the width of a filter stage.
+ *
+ * @param value Parsed parameter
+ * @param name Name of the filter stage for the error message
+ * @return The width in bins
+ *
+ * @throw invalid_argument if the value is not a positive integer
+ */
+static unsigned int toWidth(const float value, const string& name)
+{
+	if(!(value >= 1) || value > UINT16_MAX || value != floor(value))
+	{
+		throw invalid_argument("SignalFilter::parse: the width of " + name + " must be a positive integer");
+	}
+	return (unsigned int)value;
+}
+
+/**
+ * Constructor. Creates an empty filter, that leaves the data unchanged.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param offset FADC offset of the zero voltage, the filters work on the signal relative to it
+ * @param baselineBins Number of samples at the begin of each event, whose mean is the baseline for pole-zero, 0 to use
+ * the offset
+ */
+SignalFilter::SignalFilter(const uint16_t offset, const unsigned short baselineBins)
+{
+	m_offset = offset;
+	m_baseline_bins = baselineBins;
+}
+
+SignalFilter::~SignalFilter()
+{
+}
+
+/**
+ * Creates a filter from its text form, stages separated by '+', each stage a name and its parameters after a ':':
+ * 	average:width - moving average over an odd number of width bins
+ * 	fir:t0,t1,... - FIR with the given taps, normalised to a sum of 1 unless they sum up to 0
+ * 	polezero:tau - pole-zero correction for the decay constant tau in bins
+ * 	derivative:width - difference to the sample width bins earlier
+ * An empty text gives an empty filter.
+ *
+ * @brief Parse a filter chain
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param description The filter chain as text
+ * @param offset FADC offset of the zero voltage
+ * @param baselineBins Number of samples at the begin of each event for the baseline of pole-zero, 0 to use the offset
+ * @return The filter
+ *
+ * @throw invalid_argument for unknown filters and invalid parameters
+ */
+SignalFilter SignalFilter::parse(const string& description, const uint16_t offset, const unsigned short baselineBins)
+{
+	SignalFilter filter(offset,baselineBins);
+	stringstream stages(description);
+	string stage;
+	while(getline(stages,stage,'+'))
+	{
+		size_t colonPos = stage.find(':');
+		const string name = stage.substr(0,colonPos);
+		vector<float> parameters;
+		if(colonPos != string::npos)
+		{
+			stringstream values(stage.substr(colonPos + 1));
+			string value;
+			while(getline(values,value,','))
+			{
+				char* end;
+				parameters.push_back(strtof(value.c_str(),&end));
+				if(value.empty() || *end != '\0')
+				{
+					throw invalid_argument("SignalFilter::parse: invalid parameter '" + value + "' of " + name);
+				}
+			}
+		}
+		if(name != "fir" && parameters.size() != 1)
+		{
+			throw invalid_argument("SignalFilter::parse: " + name + " needs one parameter");
+		}
+
+		if(name == "average")
+		{
+			filter.addMovingAverage(toWidth(parameters[0],name));
+		}
+		else if(name == "fir")
+		{
+			filter.addFir(parameters);
+		}
+		else if(name == "polezero")
+		{
+			filter.addPoleZero(parameters[0]);
+		}
+		else if(name == "derivative")
+		{
+			filter.addDerivative(toWidth(parameters[0],name));
+		}
+		else
+		{
+			throw invalid_argument("SignalFilter::parse: unknown filter " + name);
+		}
+	}
+	return filter;
+}
+
+/**
+ * Appends a moving average. Each sample becomes the mean of the width samples centred on it, at the borders of the
+ * event the first and last sample are repeated.
+ *
+ * @brief Add a moving average
+ *
+ * @param width Odd number of bins, so that the window is centred on the sample
+ *
+ * @throw invalid_argument if width is even
+ */
+void SignalFilter::addMovingAverage(const unsigned int width)
+{
+	if(width % 2 == 0)
+	{
+		throw invalid_argument("SignalFilter: width of the moving average must be odd");
+	}
+	m_stages.push_back({MOVING_AVERAGE,width,0,{}});
+}
+
+/**
+ * Appends a FIR filter. The taps are normalised to a sum of 1, so that the amplitude of slow signals is kept, unless
+ * they sum up to 0 like the taps of a differentiator. The middle tap is applied to the sample itself.
+ *
+ * @brief Add a FIR filter
+ *
+ * @param taps The taps
+ *
+ * @throw invalid_argument if there are no taps
+ */
+void SignalFilter::addFir(const vector<float>& taps)
+{
+	if(taps.empty())
+	{
+		throw invalid_argument("SignalFilter: FIR filter without taps");
+	}
+	FilterStage stage = {FIR,(unsigned int)taps.size(),0,taps};
+	float sum = 0;
+	for(float tap : taps)
+	{
+		sum += tap;
+	}
+	if(fabs(sum) > 1e-6)
+	{
+		for(float& tap : stage.taps)
+		{
+			tap /= sum;
+		}
+	}
+	m_stages.push_back(stage);
+}
+
+/**
+ * Appends a pole-zero correction. AC coupling with the decay constant tau turns a step into an exponential decay and
+ * each pulse into a pulse followed by an undershoot. The correction adds the integral of the preceding signal weighted
+ * with 1 - exp(-1/tau), which inverts the coupling and restores the baseline after pulses.
+ *
+ * @brief Add a pole-zero correction
+ *
+ * @param tau Decay constant in bins
+ *
+ * @throw invalid_argument if tau is not positive
+ */
+void SignalFilter::addPoleZero(const float tau)
+{
+	if(!(tau > 0))
+	{
+		throw invalid_argument("SignalFilter: decay constant of the pole-zero correction must be positive");
+	}
+	m_stages.push_back({POLE_ZERO,0,tau,{}});
+}
+
+/**
+ * Appends a derivative filter, the difference of each sample to the sample width bins earlier. The first width samples
+ * become the offset.
+ *
+ * @brief Add a derivative
+ *
+ * @param width Distance in bins, at least 1
+ *
+ * @throw invalid_argument if width is 0
+ */
+void SignalFilter::addDerivative(const unsigned int width)
+{
+	if(width == 0)
+	{
+		throw invalid_argument("SignalFilter: width of the derivative must be positive");
+	}
+	m_stages.push_back({DERIVATIVE,width,0,{}});
+}
+
+/**
+ * Filters one event in place.
+ *
+ * @brief Filter an event
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data Samples of the event, overwritten with the filtered samples
+ * @param size Number of samples
+ */
+void SignalFilter::apply(uint16_t* data, const size_t size)
+{
+	if(m_input.size() < size)
+	{
+		m_input.resize(size);
+		m_output.resize(size);
+	}
+	for(const FilterStage& stage : m_stages)
+	{
+		switch(stage.type)
+		{
+		case MOVING_AVERAGE:
+			movingAverage(data,size,stage.width);
+			break;
+		case FIR:
+			fir(data,size,stage.taps);
+			break;
+		case POLE_ZERO:
+			poleZero(data,size,stage.tau);
+			break;
+		case DERIVATIVE:
+			derivative(data,size,stage.width);
+			break;
+		}
+	}
+}
+
+/**
+ * Filters a chunk of events, that are stored one after another in one buffer, in place.
+ *
+ * @brief Filter a chunk of events
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param buffer Samples of all events, overwritten with the filtered samples
+ * @param nEvents Number of events
+ * @param eventSize Number of samples per event
+ */
+void SignalFilter::apply(uint16_t* buffer, const size_t nEvents, const size_t eventSize)
+{
+	if(m_stages.empty())
+	{
+		return;
+	}
+	for(size_t i = 0; i < nEvents; ++i)
+	{
+		apply(buffer + i * eventSize,eventSize);
+	}
+}
+
+/**
+ * Checks, if the filter has no stages and thus leaves the data unchanged.
+ *
+ * @brief Check for an empty filter
+ *
+ * @return True if there are no stages
+ */
+bool SignalFilter::empty() const
+{
+	return m_stages.empty();
+}
+
+/**
+ * Getter for the number of stages.
+ *
+ * @brief Getter for the number of stages
+ *
+ * @return Number of stages
+ */
+size_t SignalFilter::getNumberOfStages() const
+{
+	return m_stages.size();
+}
+
+/**
+ * Getter for the stages in the order they are applied.
+ *
+ * @brief Getter for the stages
+ *
+ * @return The stages
+ */
+const vector<FilterStage>& SignalFilter::getStages() const
+{
+	return m_stages;
+}
+
+/**
+ * Moving average kernel. The sums are accumulated tap by tap over all bins, the inner loop has no dependencies.
+ *
+ * @param data Samples, filtered in place
+ * @param size Number of samples
+ * @param width Odd number of bins to average
+ */
+void SignalFilter::movingAverage(uint16_t* data, const size_t size, const unsigned int width)
+{
+	const size_t half = width / 2;
+	if(size <= 2 * half)
+	{
+		return;
+	}
+	int32_t* input = m_input.data();
+	float* sums = m_output.data();
+	for(size_t i = 0; i < size; ++i)
+	{
+		input[i] = data[i];
+		sums[i] = 0;
+	}
+	//inner bins, all samples of the window exist
+	const size_t end = size - half;
+	for(unsigned int k = 0; k < width; ++k)
+	{
+		for(size_t i = half; i < end; ++i)
+		{
+			sums[i] += input[i + k - half];
+		}
+	}
+	//border bins, the first and last sample are repeated
+	for(size_t i = 0; i < half; ++i)
+	{
+		for(unsigned int k = 0; k < width; ++k)
+		{
+			const long left = (long)i + k - half;
+			const long right = (long)(end + i) + k - half;
+			sums[i] += input[left < 0 ? 0 : left];
+			sums[end + i] += input[right >= (long)size ? size - 1 : right];
+		}
+	}
+	const float norm = 1.0f / width;
+	for(size_t i = 0; i < size; ++i)
+	{
+		data[i] = toSample(sums[i] * norm);
+	}
+}
+
+/**
+ * FIR kernel. The taps are applied to the signal relative to the offset, one tap after another over all bins, so that the
+ * inner loop has no dependencies. Outside of the event the signal is 0.
+ *
+ * @param data Samples, filtered in place
+ * @param size Number of samples
+ * @param taps The taps
+ */
+void SignalFilter::fir(uint16_t* data, const size_t size, const vector<float>& taps)
+{
+	int32_t* input = m_input.data();
+	float* output = m_output.data();
+	for(size_t i = 0; i < size; ++i)
+	{
+		input[i] = (int32_t)data[i] - m_offset;
+		output[i] = 0;
+	}
+	const long centre = taps.size() / 2;
+	for(size_t k = 0; k < taps.size(); ++k)
+	{
+		const long shift = (long)k - centre;
+		const size_t first = shift < 0 ? -shift : 0;
+		const size_t last = shift > 0 ? (size > (size_t)shift ? size - shift : 0) : size;
+		const float tap = taps[k];
+		for(size_t i = first; i < last; ++i)
+		{
+			output[i] += tap * input[i + shift];
+		}
+	}
+	for(size_t i = 0; i < size; ++i)
+	{
+		data[i] = toSample(output[i] + m_offset);
+	}
+}
+
+/**
+ * Pole-zero kernel, a recursion over the bins. The signal is integrated relative to the baseline of the event, which is
+ * kept in the output.
+ *
+ * @param data Samples, filtered in place
+ * @param size Number of samples
+ * @param tau Decay constant in bins
+ */
+void SignalFilter::poleZero(uint16_t* data, const size_t size, const float tau)
+{
+	const float weight = 1 - exp(-1 / tau);
+	const size_t nBaseline = m_baseline_bins < size ? m_baseline_bins : size;
+	float baseline = m_offset;
+	if(nBaseline > 0)
+	{
+		float sum = 0;
+		for(size_t i = 0; i < nBaseline; ++i)
+		{
+			sum += data[i];
+		}
+		baseline = sum / nBaseline;
+	}
+	float integral = 0;
+	for(size_t i = 0; i < size; ++i)
+	{
+		const float signal = (float)data[i] - baseline;
+		data[i] = toSample(signal + weight * integral + baseline);
+		integral += signal;
+	}
+}
+
+/**
+ * Derivative kernel, the difference of each sample to the one width bins earlier.
+ *
+ * @param data Samples, filtered in place
+ * @param size Number of samples
+ * @param width Distance in bins
+ */
+void SignalFilter::derivative(uint16_t* data, const size_t size, const unsigned int width)
+{
+	int32_t* input = m_input.data();
+	for(size_t i = 0; i < size; ++i)
+	{
+		input[i] = data[i];
+	}
+	const int32_t offset = m_offset;
+	for(size_t i = 0; i < size && i < width; ++i)
+	{
+		data[i] = m_offset;
+	}
+	for(size_t i = width; i < size; ++i)
+	{
+		const int32_t difference = input[i] - input[i - width] + offset;
+		data[i] = difference < 0 ? 0 : (difference > UINT16_MAX ? UINT16_MAX : difference);
+	}
+}
@@ -0,0 +1,97 @@
+/*
+ * SignalFilter.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef SIGNALFILTER_H_
+#define SIGNALFILTER_H_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "globals.h"
+
+/**
+ * One stage of a SignalFilter.
+ *
+ * @brief Stage of a filter chain
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	uint8_t type; //one of SignalFilter::Type
+	unsigned int width; //bins, for moving average and derivative
+	float tau; //decay constant in bins, for pole-zero
+	std::vector<float> taps; //for FIR
+} FilterStage;
+
+/**
+ * Chain of digital filters that is applied to raw FADC data before the discrimination, e.g. to suppress noise that
+ * crosses the threshold before the signal. The stages are applied in the order they were added:
+ * - moving average: centred mean over an odd number of bins
+ * - FIR: convolution with arbitrary taps, centred on the middle tap
+ * - pole-zero: restores the baseline of AC coupled signals with decay constant tau, the undershoot after a pulse vanishes
+ * - derivative: difference to the sample width bins earlier, the leading edge of a pulse becomes a peak
+ * All filters work on the signal relative to the offset and write it back with the offset added, so thresholds keep their
+ * meaning. Pole-zero integrates the signal relative to the baseline of each event instead, the mean of its first
+ * baseline bins, so that a baseline away from the offset is not integrated into a ramp. The results are rounded and
+ * limited to the range of the FADC.
+ * The data is filtered in place. The scratch buffers of a filter are reused for all events, so filtering a chunk of
+ * events does not allocate. The loops of moving average, FIR and derivative run over the bins of an event without
+ * dependencies and are vectorised, pole-zero is a recursion over the bins.
+ * A chain is written as text, the stages separated by '+', e.g.
+ * @code
+ * average:5+fir:1,2,1+polezero:250+derivative:3
+ * @endcode
+ *
+ * @brief Filter chain for raw data
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @warning A filter is not thread safe, use one filter per thread.
+ */
+class SignalFilter
+{
+public:
+	SignalFilter(const uint16_t offset = ABSOLUTE_OFFSET_ZERO_VOLTAGE, const unsigned short baselineBins = 0);
+	~SignalFilter();
+
+	static SignalFilter parse(const std::string& description, const uint16_t offset = ABSOLUTE_OFFSET_ZERO_VOLTAGE,
+			const unsigned short baselineBins = 0);
+
+	void addMovingAverage(const unsigned int width);
+	void addFir(const std::vector<float>& taps);
+	void addPoleZero(const float tau);
+	void addDerivative(const unsigned int width);
+
+	void apply(uint16_t* data, const size_t size);
+	void apply(uint16_t* buffer, const size_t nEvents, const size_t eventSize);
+
+	bool empty() const;
+	size_t getNumberOfStages() const;
+	const std::vector<FilterStage>& getStages() const;
+
+	enum Type : uint8_t {MOVING_AVERAGE, FIR, POLE_ZERO, DERIVATIVE};
+
+private:
+	void movingAverage(uint16_t* data, const size_t size, const unsigned int width);
+	void fir(uint16_t* data, const size_t size, const std::vector<float>& taps);
+	void poleZero(uint16_t* data, const size_t size, const float tau);
+	void derivative(uint16_t* data, const size_t size, const unsigned int width);
+
+	std::vector<FilterStage> m_stages;
+	uint16_t m_offset;
+	unsigned short m_baseline_bins; //samples at the begin of each event for the baseline of pole-zero, 0 for the offset
+	std::vector<int32_t> m_input; //copy of the event relative to the offset
+	std::vector<float> m_output;
+};
+
+#endif /* SIGNALFILTER_H_ */
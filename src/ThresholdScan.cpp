@@ -0,0 +1,329 @@
+/*
+ * ThresholdScan.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "ThresholdScan.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Constructor. Creates an empty scan for the given thresholds.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param thresholds Thresholds in FADC channels relative to the baseline of each event, with the sign of the threshold
+ * of the current AnalysisConfig. They are sorted from the loosest to the strictest one for its polarity.
+ * @param afterpulseStartBin First bin, in which pulses count as afterpulses, usually the maximum drift time
+ */
+ThresholdScan::ThresholdScan(const vector<int>& thresholds, const unsigned short afterpulseStartBin)
+{
+	m_thresholds = thresholds;
+	if(AnalysisConfig::current().isNegative())
+	{
+		sort(m_thresholds.begin(),m_thresholds.end(),greater<int>());
+	}
+	else
+	{
+		sort(m_thresholds.begin(),m_thresholds.end(),less<int>());
+	}
+	m_afterpulse_start_bin = afterpulseStartBin;
+	m_n_events = 0;
+	m_histogram.resize(m_thresholds.size());
+	m_rejected.resize(m_thresholds.size(),0);
+	m_afterpulses.resize(m_thresholds.size(),0);
+}
+
+ThresholdScan::~ThresholdScan()
+{
+}
+
+/**
+ * Scans the events of a tube. Afterpulses are counted from the maximum drift time of the tube on, as in
+ * DataProcessor::countAfterpulses(...).
+ *
+ * @brief Scan a tube
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param tube The tube
+ * @param thresholds Thresholds in FADC channels relative to the baseline of each event
+ * @return The filled scan
+ */
+ThresholdScan ThresholdScan::scan(const Drifttube& tube, const vector<int>& thresholds)
+{
+	ThresholdScan result(thresholds,tube.getMaxDrifttime() / AnalysisConfig::current().getBinsToTime());
+	result.fill(tube.getDataSet());
+	return result;
+}
+
+/**
+ * Fills the events of a DataSet into the scan. The events are processed in parallel, each thread fills its own
+ * histograms, which are merged afterwards. The samples of every event are shifted by its baseline onto the offset of
+ * the AnalysisConfig and, for positive signals, mirrored at it, so that one lookup table serves all events and both
+ * polarities.
+ *
+ * @brief Fill the scan
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param data The events
+ *
+ * @throw invalid_argument if events were suppressed, but a threshold is looser than the one of the AnalysisConfig, as the
+ * suppressed events may have crossed it
+ */
+void ThresholdScan::fill(const DataSet& data)
+{
+	const size_t nThresholds = m_thresholds.size();
+	const AnalysisConfig& config = AnalysisConfig::current();
+	const unsigned short triggerBin = config.getTriggerBin();
+	const bool negative = config.isNegative();
+	const int offset = config.getOffset();
+	const vector<unique_ptr<Event>>& events = data.getData();
+	const long nEvents = events.size();
+
+	const bool suppressed = any_of(events.begin(),events.end(),[](const unique_ptr<Event>& event){return !event;});
+	if(suppressed && nThresholds > 0 && (negative ? m_thresholds[0] > config.getThreshold() : m_thresholds[0] < config.getThreshold()))
+	{
+		throw invalid_argument("ThresholdScan::fill: thresholds looser than the configured one need zerosuppression=0");
+	}
+
+	//number of thresholds, that a shifted value is below of (drift time) and at or below of (afterpulses)
+	vector<uint16_t> below(65536,0);
+	vector<uint16_t> atOrBelow(65536,0);
+	for(int threshold : m_thresholds)
+	{
+		int absolute = offset + (negative ? threshold : -threshold);
+		for(int value = 0; value < 65536 && value <= absolute; ++value)
+		{
+			below[value] += value < absolute;
+			++atOrBelow[value];
+		}
+	}
+
+	#pragma omp parallel
+	{
+		ThresholdScan threadScan(m_thresholds,m_afterpulse_start_bin);
+		vector<int> pulseEdges(nThresholds + 1,0);
+
+		#pragma omp for schedule(static,1024)
+		for(long i = 0; i < nEvents; ++i)
+		{
+			++threadScan.m_n_events;
+			if(!events[i])
+			{
+				for(size_t k = 0; k < nThresholds; ++k)
+				{
+					++threadScan.m_rejected[k];
+				}
+				continue;
+			}
+			const EventSamples& samples = events[i]->getData();
+			const size_t nSamples = samples.size();
+			const int baseline = lround(events[i]->getBaseline());
+			//sample shifted onto the offset, mirrored for positive signals, limited to the range of the tables
+			auto shifted = [&](const uint16_t sample) -> uint16_t
+			{
+				const int value = negative ? sample - baseline + offset : baseline - sample + offset;
+				return value < 0 ? 0 : (value > UINT16_MAX ? UINT16_MAX : value);
+			};
+			if(nThresholds > 0 && threadScan.m_histogram[0].size() < nSamples)
+			{
+				for(vector<uint32_t>& spectrum : threadScan.m_histogram)
+				{
+					spectrum.resize(nSamples,0);
+				}
+			}
+
+			//first crossings, a sample below n thresholds crosses all of them that were not crossed before
+			size_t crossed = 0;
+			for(size_t j = 0; j < nSamples && crossed < nThresholds; ++j)
+			{
+				const size_t level = below[shifted(samples[j])];
+				const size_t bin = j > triggerBin ? j - triggerBin : 0;
+				for(; crossed < level; ++crossed)
+				{
+					++threadScan.m_histogram[crossed][bin];
+				}
+			}
+			for(size_t k = crossed; k < nThresholds; ++k)
+			{
+				++threadScan.m_rejected[k];
+			}
+
+			//afterpulses, a rising level starts a pulse for every threshold between the old and the new level
+			size_t previous = 0;
+			for(size_t j = m_afterpulse_start_bin; j < nSamples; ++j)
+			{
+				const size_t level = atOrBelow[shifted(samples[j])];
+				if(level > previous)
+				{
+					++pulseEdges[previous];
+					--pulseEdges[level];
+				}
+				previous = level;
+			}
+		}
+
+		int pulses = 0;
+		for(size_t k = 0; k < nThresholds; ++k)
+		{
+			pulses += pulseEdges[k];
+			threadScan.m_afterpulses[k] = pulses;
+		}
+
+		#pragma omp critical
+		{
+			merge(threadScan);
+		}
+	}
+}
+
+/**
+ * Adds the results of another scan, e.g. of another file of the same run.
+ *
+ * @brief Merge two scans
+ *
+ * @param other Scan with the same thresholds
+ *
+ * @throw invalid_argument if the thresholds differ
+ */
+void ThresholdScan::merge(const ThresholdScan& other)
+{
+	if(other.m_thresholds != m_thresholds)
+	{
+		throw invalid_argument("ThresholdScan::merge: different thresholds");
+	}
+	m_n_events += other.m_n_events;
+	for(size_t k = 0; k < m_thresholds.size(); ++k)
+	{
+		vector<uint32_t>& spectrum = m_histogram[k];
+		const vector<uint32_t>& otherSpectrum = other.m_histogram[k];
+		if(spectrum.size() < otherSpectrum.size())
+		{
+			spectrum.resize(otherSpectrum.size(),0);
+		}
+		for(size_t bin = 0; bin < otherSpectrum.size(); ++bin)
+		{
+			spectrum[bin] += otherSpectrum[bin];
+		}
+		m_rejected[k] += other.m_rejected[k];
+		m_afterpulses[k] += other.m_afterpulses[k];
+	}
+}
+
+/**
+ * Getter for the number of thresholds.
+ *
+ * @brief Getter for the number of thresholds
+ *
+ * @return Number of thresholds
+ */
+size_t ThresholdScan::getNumberOfThresholds() const
+{
+	return m_thresholds.size();
+}
+
+/**
+ * Getter for the thresholds. The index of a threshold in this vector is the index used by all other getters.
+ *
+ * @brief Getter for the thresholds
+ *
+ * @return Thresholds relative to the baseline, from the loosest to the strictest one
+ */
+const vector<int>& ThresholdScan::getThresholds() const
+{
+	return m_thresholds;
+}
+
+/**
+ * Getter for the number of events filled, including suppressed events.
+ *
+ * @brief Getter for the number of events
+ *
+ * @return Number of events
+ */
+unsigned int ThresholdScan::getNumberOfEvents() const
+{
+	return m_n_events;
+}
+
+/**
+ * Getter for the 2D histogram of the drift times of all thresholds.
+ *
+ * @brief Getter for the threshold x drift time histogram
+ *
+ * @return Histogram, indexed by threshold and drift time bin
+ */
+const vector<vector<uint32_t>>& ThresholdScan::getHistogram() const
+{
+	return m_histogram;
+}
+
+/**
+ * Getter for the drift time spectrum of one threshold, in the form DataProcessor::calculateRtRelation(...) expects it.
+ *
+ * @brief Drift time spectrum of a threshold
+ *
+ * @param threshold Index of the threshold
+ * @return The drift time spectrum, events without crossing are rejected
+ */
+const DriftTimeSpectrum ThresholdScan::getDriftTimeSpectrum(const unsigned int threshold) const
+{
+	unique_ptr<vector<uint32_t>> spectrum(new vector<uint32_t>(m_histogram[threshold]));
+	return DriftTimeSpectrum(move(spectrum),m_n_events,m_rejected[threshold]);
+}
+
+/**
+ * Getter for the efficiency at one threshold, defined as in Drifttube::getEfficiency().
+ *
+ * @brief Efficiency of a threshold
+ *
+ * @param threshold Index of the threshold
+ * @return Events with crossing over all events, 0 without events
+ */
+double ThresholdScan::getEfficiency(const unsigned int threshold) const
+{
+	return m_n_events > 0 ? (m_n_events - m_rejected[threshold]) / (double)m_n_events : 0;
+}
+
+/**
+ * Getter for the number of afterpulses at one threshold.
+ *
+ * @brief Afterpulses of a threshold
+ *
+ * @param threshold Index of the threshold
+ * @return Number of afterpulses
+ */
+unsigned int ThresholdScan::getAfterpulses(const unsigned int threshold) const
+{
+	return m_afterpulses[threshold];
+}
+
+/**
+ * Getter for the afterpulse probability at one threshold, thus the afterpulses per event with crossing.
+ *
+ * @brief Afterpulse probability of a threshold
+ *
+ * @param threshold Index of the threshold
+ * @return Afterpulses per event with signal, 0 without such events
+ */
+double ThresholdScan::getAfterpulseProbability(const unsigned int threshold) const
+{
+	unsigned int signals = m_n_events - m_rejected[threshold];
+	return signals > 0 ? m_afterpulses[threshold] / (double)signals : 0;
+}
@@ -0,0 +1,65 @@
+/*
+ * ThresholdScan.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef THRESHOLDSCAN_H_
+#define THRESHOLDSCAN_H_
+
+#include <vector>
+#include "DataSet.h"
+#include "DriftTimeSpectrum.h"
+#include "Drifttube.h"
+#include "globals.h"
+
+/**
+ * Efficiency, drift time spectra and afterpulses of a tube for a list of thresholds, computed in a single pass over the
+ * events. Thresholds are relative to the baseline of each event and follow the polarity of the AnalysisConfig. Before
+ * the pass, every FADC value is mapped to the number of thresholds it crosses. Since the thresholds
+ * are sorted, a sample crosses exactly the first n of them, so the first crossing of every threshold and the
+ * pulses of every threshold follow from one loop over the samples of an event, independent of the number of
+ * thresholds. The drift time spectra of all thresholds form a 2D histogram threshold x drift time.
+ * The definitions follow the ones for the threshold of the AnalysisConfig: the drift time is the first sample below the
+ * threshold (see DataProcessor::findDriftTimeBin(...)), afterpulses are pulses at or below the threshold starting after
+ * the afterpulse start bin (see DataProcessor::countAfterpulses(...)). Suppressed events (see
+ * AnalysisConfig::isZeroSuppressed()) count as events without signal, so with suppressed events only thresholds at or
+ * beyond the configured one can be scanned.
+ *
+ * @brief Threshold scan in one pass
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+class ThresholdScan
+{
+public:
+	ThresholdScan(const std::vector<int>& thresholds, const unsigned short afterpulseStartBin);
+	~ThresholdScan();
+
+	static ThresholdScan scan(const Drifttube& tube, const std::vector<int>& thresholds);
+
+	void fill(const DataSet& data);
+	void merge(const ThresholdScan& other);
+
+	size_t getNumberOfThresholds() const;
+	const std::vector<int>& getThresholds() const;
+	unsigned int getNumberOfEvents() const;
+	const std::vector<std::vector<uint32_t>>& getHistogram() const;
+	const DriftTimeSpectrum getDriftTimeSpectrum(const unsigned int threshold) const;
+	double getEfficiency(const unsigned int threshold) const;
+	unsigned int getAfterpulses(const unsigned int threshold) const;
+	double getAfterpulseProbability(const unsigned int threshold) const;
+
+private:
+	std::vector<int> m_thresholds; //relative to the baseline, loosest first
+	unsigned short m_afterpulse_start_bin;
+	unsigned int m_n_events;
+	std::vector<std::vector<uint32_t>> m_histogram; //m_histogram[threshold][drift time bin]
+	std::vector<unsigned int> m_rejected; //events without crossing per threshold
+	std::vector<unsigned int> m_afterpulses; //per threshold
+};
+
+#endif /* THRESHOLDSCAN_H_ */
@@ -6,15 +6,421 @@
  */
 
 #include "Track.h"
+#include "AnalysisConfig.h"
+#include <cmath>
+#include <vector>
 
+using namespace std;
+
+/**
+ * Default constructor. Creates an invalid track, that is returned if there are not enough hits for a fit.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
 Track::Track()
 {
-	// TODO Auto-generated constructor stub
+	m_theta = 0;
+	m_distance = 0;
+	m_chi2 = -1;
+	m_n_hits = 0;
+}
 
+/**
+ * Constructor for a track with known parameters, that has not been fitted to any hits.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param theta Angle of the normal of the track in rad
+ * @param distance Signed distance of the track to the origin in mm
+ */
+Track::Track(const double theta, const double distance)
+{
+	m_theta = theta;
+	m_distance = distance;
+	m_chi2 = 0;
+	m_n_hits = 0;
+	normalize();
 }
 
 Track::~Track()
 {
-	// TODO Auto-generated destructor stub
 }
 
+/**
+ * Getter for the angle of the normal of the track.
+ *
+ * @brief Getter for theta
+ *
+ * @return Angle in rad in [0,pi)
+ */
+double Track::getTheta() const
+{
+	return m_theta;
+}
+
+/**
+ * Getter for the signed distance of the track to the origin.
+ *
+ * @brief Getter for the distance
+ *
+ * @return Distance in mm
+ */
+double Track::getDistance() const
+{
+	return m_distance;
+}
+
+/**
+ * Getter for the sum of the squared residuals of the fit, thus chi^2 for a resolution of 1 mm.
+ *
+ * @brief Getter for chi^2
+ *
+ * @return Sum of squared residuals in mm^2, -1 for an invalid track
+ */
+double Track::getChi2() const
+{
+	return m_chi2;
+}
+
+/**
+ * Getter for the number of hits, that the track was fitted to.
+ *
+ * @brief Getter for the number of hits
+ *
+ * @return Number of hits
+ */
+unsigned int Track::getNumberOfHits() const
+{
+	return m_n_hits;
+}
+
+/**
+ * Returns, whether the track holds a result. This is not the case for default constructed tracks, as returned by
+ * fit(...) if there were not enough hits.
+ *
+ * @brief Check validity
+ *
+ * @return true if the track is valid
+ */
+bool Track::isValid() const
+{
+	return m_chi2 >= 0;
+}
+
+/**
+ * Calculates the signed distance of a point to the track. The sign tells on which side of the track the point is.
+ *
+ * @brief Distance of a point to the track
+ *
+ * @param x x-coordinate of the point in mm
+ * @param y y-coordinate of the point in mm
+ * @return Signed distance in mm
+ */
+double Track::distanceTo(const double x, const double y) const
+{
+	return x * cos(m_theta) + y * sin(m_theta) - m_distance;
+}
+
+/**
+ * Calculates the residual of a drift circle, which is the distance of the track to the wire minus the drift radius.
+ *
+ * @brief Residual of a drift circle
+ *
+ * @param circle The drift circle
+ * @return Residual in mm, positive if the track passes outside the circle
+ */
+double Track::residual(const DriftCircle& circle) const
+{
+	return fabs(distanceTo(circle.x,circle.y)) - circle.radius;
+}
+
+/**
+ * Fits a track tangent to the passed drift circles. With the distance eliminated, the sum of squared residuals only depends
+ * on the angle, the second moments of the wire positions and three sums over the signed radii. The left/right
+ * combinations are therefore enumerated in Gray code order, so that each combination only updates these sums, and the
+ * global minimum over the angle is found for all combinations at once by a vectorized solution of the secular equation
+ * in the principal axes of the wires. The sign of the first circle
+ * is fixed, as flipping all signs describes the same set of lines. The best combination is finally refined by
+ * Gauss-Newton iterations.
+ *
+ * @brief Fit a track to drift circles
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param circles Pointer to the first drift circle
+ * @param n Number of drift circles
+ * @return Fitted track, invalid if n < 3 or n > MAX_AMBIGUITY_HITS
+ */
+Track Track::fit(const DriftCircle* circles, const size_t n)
+{
+	Track result;
+	if(n < 3 || n > MAX_AMBIGUITY_HITS)
+	{
+		return result;
+	}
+
+	double meanX = 0, meanY = 0, sumR2 = 0;
+	for(size_t i = 0; i < n; ++i)
+	{
+		meanX += circles[i].x;
+		meanY += circles[i].y;
+		sumR2 += circles[i].radius * circles[i].radius;
+	}
+	meanX /= n;
+	meanY /= n;
+	double sxx = 0, syy = 0, sxy = 0;
+	for(size_t i = 0; i < n; ++i)
+	{
+		sxx += (circles[i].x - meanX) * (circles[i].x - meanX);
+		syy += (circles[i].y - meanY) * (circles[i].y - meanY);
+		sxy += (circles[i].x - meanX) * (circles[i].y - meanY);
+	}
+	//seed: principal axis of the wire positions
+	const double seedTheta = 0.5 * atan2(2 * sxy, sxx - syy) + M_PI / 2;
+	const double seedCos = cos(seedTheta);
+	const double seedSin = sin(seedTheta);
+
+	//sums over the signed radii for every combination, the sign of circle i + 1 is bit i of the Gray code
+	const unsigned int nCombinations = 1u << (n - 1);
+	double sumR[1u << (MAX_AMBIGUITY_HITS - 1)];
+	double sumXR[1u << (MAX_AMBIGUITY_HITS - 1)];
+	double sumYR[1u << (MAX_AMBIGUITY_HITS - 1)];
+	double chi2[1u << (MAX_AMBIGUITY_HITS - 1)];
+	double cosTheta[1u << (MAX_AMBIGUITY_HITS - 1)];
+	double sinTheta[1u << (MAX_AMBIGUITY_HITS - 1)];
+	sumR[0] = sumXR[0] = sumYR[0] = 0;
+	for(size_t i = 0; i < n; ++i)
+	{
+		sumR[0] += circles[i].radius;
+		sumXR[0] += (circles[i].x - meanX) * circles[i].radius;
+		sumYR[0] += (circles[i].y - meanY) * circles[i].radius;
+	}
+	for(unsigned int combination = 1; combination < nCombinations; ++combination)
+	{
+		unsigned int flip = __builtin_ctz(combination);
+		double sign = ((combination ^ (combination >> 1)) >> flip) & 1 ? -1 : 1;
+		double change = 2 * sign * circles[flip + 1].radius;
+		sumR[combination] = sumR[combination - 1] + change;
+		sumXR[combination] = sumXR[combination - 1] + change * (circles[flip + 1].x - meanX);
+		sumYR[combination] = sumYR[combination - 1] + change * (circles[flip + 1].y - meanY);
+	}
+
+	//for the normal n = (cos(theta), sin(theta)) the sum of squared residuals is n^T S n - 2 * n * (sumXR, sumYR) + const.
+	//with the covariance S of the wires, its minimum on the unit circle solves (S - lambda) n = (sumXR, sumYR) for
+	//lambda below the smallest eigenvalue. In the eigenbasis of S, which is shared by all combinations, lambda is found
+	//by Newton iterations on the secular equation 1 / |n(lambda)| = 1, starting below the solution.
+	const double halfTrace = 0.5 * (sxx + syy);
+	const double halfSpread = sqrt(0.25 * (sxx - syy) * (sxx - syy) + sxy * sxy);
+	const double minorEigenvalue = halfTrace - halfSpread;
+	const double majorEigenvalue = halfTrace + halfSpread;
+	const double majorCos = -seedSin, majorSin = seedCos;
+	#pragma omp simd
+	for(unsigned int combination = 0; combination < nCombinations; ++combination)
+	{
+		double minor = sumXR[combination] * seedCos + sumYR[combination] * seedSin;
+		double major = sumXR[combination] * majorCos + sumYR[combination] * majorSin;
+		double lambda = minorEigenvalue - sqrt(minor * minor + major * major);
+		for(unsigned int iteration = 0; iteration < 3; ++iteration)
+		{
+			double inverseMinor = 1 / (minorEigenvalue - lambda + 1e-12);
+			double inverseMajor = 1 / (majorEigenvalue - lambda + 1e-12);
+			double norm2 = minor * minor * inverseMinor * inverseMinor + major * major * inverseMajor * inverseMajor + 1e-300;
+			double derivative = minor * minor * inverseMinor * inverseMinor * inverseMinor + major * major * inverseMajor * inverseMajor * inverseMajor;
+			double inverseNorm = 1 / sqrt(norm2);
+			//h = 1 / |n| - 1, h' = -|n|^-3 * derivative
+			lambda += (inverseNorm - 1) * norm2 / (inverseNorm * derivative + 1e-300);
+			lambda = lambda < minorEigenvalue ? lambda : minorEigenvalue;
+		}
+		double nMinor = minor / (minorEigenvalue - lambda + 1e-12);
+		double nMajor = major / (majorEigenvalue - lambda + 1e-12);
+		double norm2 = nMinor * nMinor + nMajor * nMajor;
+		//hard case: no linear term along the minor axis, e.g. collinear wires, the minor component completes n
+		double completed = nMajor * nMajor < 1 ? sqrt(1 - nMajor * nMajor) : 0;
+		nMinor = norm2 < 1 ? (minor < 0 ? -completed : completed) : nMinor / sqrt(norm2);
+		nMajor = norm2 < 1 ? nMajor : nMajor / sqrt(norm2);
+		cosTheta[combination] = nMinor * seedCos + nMajor * majorCos;
+		sinTheta[combination] = nMinor * seedSin + nMajor * majorSin;
+		chi2[combination] = minorEigenvalue * nMinor * nMinor + majorEigenvalue * nMajor * nMajor
+				- 2 * (minor * nMinor + major * nMajor) + sumR2 - sumR[combination] * sumR[combination] / n;
+	}
+
+	unsigned int best = 0;
+	for(unsigned int combination = 1; combination < nCombinations; ++combination)
+	{
+		best = chi2[combination] < chi2[best] ? combination : best;
+	}
+	signed char bestSigns[MAX_AMBIGUITY_HITS];
+	unsigned int gray = best ^ (best >> 1);
+	bestSigns[0] = 1;
+	for(size_t i = 1; i < n; ++i)
+	{
+		bestSigns[i] = (gray >> (i - 1)) & 1 ? -1 : 1;
+	}
+	const double bestCos = cosTheta[best], bestSin = sinTheta[best], bestSumR = sumR[best];
+
+	result.m_theta = atan2(bestSin,bestCos);
+	result.m_distance = meanX * bestCos + meanY * bestSin - bestSumR / n;
+	result.m_chi2 = fitSigns(circles,bestSigns,n,result.m_theta,result.m_distance,20);
+	result.m_n_hits = n;
+	result.normalize();
+
+	return result;
+}
+
+/**
+ * Fits a track tangent to the passed drift circles starting from a seed track, e.g. a candidate of the
+ * LegendreTrackFinder. The left/right ambiguity of each circle is taken from the side of the seed, on which its wire
+ * lies, so the cost only grows linearly with the number of circles.
+ *
+ * @brief Fit a track to drift circles from a seed
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param circles Pointer to the first drift circle
+ * @param n Number of drift circles
+ * @param seed Start value of the fit
+ * @return Fitted track, invalid if n < 3
+ */
+Track Track::fit(const DriftCircle* circles, const size_t n, const Track& seed)
+{
+	Track result;
+	if(n < 3)
+	{
+		return result;
+	}
+
+	vector<signed char> signs(n);
+	for(size_t i = 0; i < n; ++i)
+	{
+		signs[i] = seed.distanceTo(circles[i].x,circles[i].y) < 0 ? -1 : 1;
+	}
+	result.m_theta = seed.m_theta;
+	result.m_distance = seed.m_distance;
+	result.m_chi2 = fitSigns(circles,signs.data(),n,result.m_theta,result.m_distance,20);
+	result.m_n_hits = n;
+	result.normalize();
+
+	return result;
+}
+
+/**
+ * Converts a drift time to a drift radius using the rt-relation. The rt-relation is linearly interpolated between its
+ * bins, drift times beyond its range are mapped to the first or last radius.
+ *
+ * @brief Drift time to drift radius
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param rtRelation The rt-relation of the tube
+ * @param driftTime Drift time in ns
+ * @return Drift radius in mm
+ */
+double Track::driftRadius(const RtRelation& rtRelation, const double driftTime)
+{
+	const vector<double>& rt = rtRelation.getData();
+	if(rt.empty())
+	{
+		return 0;
+	}
+	double bin = driftTime / AnalysisConfig::current().getSpectrumBinWidth();
+	if(bin <= 0)
+	{
+		return rt[0];
+	}
+	size_t lower = (size_t)bin;
+	if(lower + 1 >= rt.size())
+	{
+		return rt.back();
+	}
+	double fraction = bin - lower;
+	return rt[lower] + fraction * (rt[lower + 1] - rt[lower]);
+}
+
+/**
+ * Fits a line to drift circles with fixed left/right signs by Gauss-Newton iterations. The residual of circle i is
+ * x_i * cos(theta) + y_i * sin(theta) - distance - sign_i * r_i.
+ *
+ * @brief Fit with fixed signs
+ *
+ * @param circles Pointer to the first drift circle
+ * @param signs Side of the track for each circle, +1 or -1
+ * @param n Number of drift circles
+ * @param theta Start value, contains the result afterwards
+ * @param distance Start value, contains the result afterwards
+ * @param iterations Maximum number of iterations
+ * @return Sum of squared residuals after the fit
+ */
+double Track::fitSigns(const DriftCircle* circles, const signed char* signs, const size_t n, double& theta, double& distance, const unsigned int iterations)
+{
+	for(unsigned int iteration = 0; iteration < iterations; ++iteration)
+	{
+		double c = cos(theta);
+		double s = sin(theta);
+		double sgg = 0, sg = 0, se = 0, sge = 0;
+		for(size_t i = 0; i < n; ++i)
+		{
+			double e = circles[i].x * c + circles[i].y * s - distance - signs[i] * circles[i].radius;
+			double g = -circles[i].x * s + circles[i].y * c;
+			sgg += g * g;
+			sg += g;
+			se += e;
+			sge += g * e;
+		}
+		double det = sgg * n - sg * sg;
+		if(fabs(det) < 1e-12)
+		{
+			break;
+		}
+		double deltaTheta = -(n * sge - sg * se) / det;
+		double deltaDistance = -(sg * sge - sgg * se) / det;
+		theta += deltaTheta;
+		distance += deltaDistance;
+		if(fabs(deltaTheta) < 1e-12 && fabs(deltaDistance) < 1e-9)
+		{
+			break;
+		}
+	}
+
+	double c = cos(theta);
+	double s = sin(theta);
+	double chi2 = 0;
+	for(size_t i = 0; i < n; ++i)
+	{
+		double e = circles[i].x * c + circles[i].y * s - distance - signs[i] * circles[i].radius;
+		chi2 += e * e;
+	}
+	return chi2;
+}
+
+/**
+ * Brings theta into [0,pi), the distance changes its sign if the normal is flipped.
+ *
+ * @brief Normalize track parameters
+ */
+void Track::normalize()
+{
+	m_theta = fmod(m_theta, 2 * M_PI);
+	if(m_theta < 0)
+	{
+		m_theta += 2 * M_PI;
+	}
+	if(m_theta >= M_PI)
+	{
+		m_theta -= M_PI;
+		m_distance = -m_distance;
+	}
+}
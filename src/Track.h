@@ -8,9 +8,32 @@
 #ifndef TRACK_H_
 #define TRACK_H_
 
+#include <cstddef>
+#include "RtRelation.h"
+#include "globals.h"
+
+/**
+ * Drift circle of one hit tube. The track passes tangent to the circle around the wire position.
+ *
+ * @brief Drift circle
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	double x; //wire position [mm]
+	double y; //wire position [mm]
+	double radius; //drift radius [mm]
+} DriftCircle;
+
 /**
  * A track that is reconstructed from several drift times measured for one triggersignal. A track does always correspond to a
  * TriggerEventCollection.
+ * The track is a straight line in Hesse normal form x * cos(theta) + y * sin(theta) = distance, with theta in [0,pi).
+ * It is fitted tangent to the drift circles of the hit tubes, the left/right ambiguity of each circle is resolved by
+ * fitting all sign combinations and keeping the one with the smallest sum of squared residuals.
  *
  * @author Stefan Bieschke
  * @version Alpha 2.0
@@ -20,10 +43,31 @@ class Track
 {
 public:
 	Track();
+	Track(const double theta, const double distance);
 	~Track();
 
+	double getTheta() const;
+	double getDistance() const;
+	double getChi2() const;
+	unsigned int getNumberOfHits() const;
+	bool isValid() const;
+	double distanceTo(const double x, const double y) const;
+	double residual(const DriftCircle& circle) const;
+
+	static Track fit(const DriftCircle* circles, const size_t n);
+	static Track fit(const DriftCircle* circles, const size_t n, const Track& seed);
+	static double driftRadius(const RtRelation& rtRelation, const double driftTime);
+
+	static const size_t MAX_AMBIGUITY_HITS = TRACK_MAX_COMBINATORIAL_HITS; //more hits are seeded by the LegendreTrackFinder
+
 private:
-	double m_alpha;
+	static double fitSigns(const DriftCircle* circles, const signed char* signs, const size_t n, double& theta, double& distance, const unsigned int iterations);
+	void normalize();
+
+	double m_theta; //angle of the normal of the track [rad]
+	double m_distance; //signed distance of the track to the origin [mm]
+	double m_chi2; //sum of squared residuals [mm^2]
+	unsigned int m_n_hits;
 };
 
 #endif /* TRACK_H_ */
@@ -7,14 +7,247 @@
 
 #include "TriggerEventCollection.h"
 
-TriggerEventCollection::TriggerEventCollection()
+using namespace std;
+
+/**
+ * Constructor. Builds the trigger-major hit store from the DataSets of the passed tubes. The triggers are processed in
+ * blocks in parallel, within a block the events of each tube are read sequentially, so that the transpose stays cache
+ * friendly. Events that are not present (zero suppression) or have no drift time result in an empty Hit.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param tubes The tubes of the chamber. All DataSets are expected to have the same number of events, if not, only the
+ * triggers present in all tubes are used.
+ */
+TriggerEventCollection::TriggerEventCollection(const vector<unique_ptr<Drifttube>>& tubes)
 {
-	// TODO Auto-generated constructor stub
+	m_n_tubes = tubes.size();
+	m_n_triggers = 0;
+	if(m_n_tubes > 0)
+	{
+		m_n_triggers = tubes[0]->getDataSet().getSize();
+	}
+	for(size_t tube = 0; tube < m_n_tubes; ++tube)
+	{
+		m_tube_positions.push_back(tubes[tube]->getPosition());
+		m_n_triggers = tubes[tube]->getDataSet().getSize() < m_n_triggers ? tubes[tube]->getDataSet().getSize() : m_n_triggers;
+	}
+	m_hits.resize(m_n_triggers * m_n_tubes);
 
+	const long blockSize = 256;
+	const long nBlocks = (m_n_triggers + blockSize - 1) / blockSize;
+	#pragma omp parallel for schedule(dynamic)
+	for(long block = 0; block < nBlocks; ++block)
+	{
+		size_t first = block * blockSize;
+		size_t last = first + blockSize < m_n_triggers ? first + blockSize : m_n_triggers;
+		for(size_t tube = 0; tube < m_n_tubes; ++tube)
+		{
+			const vector<unique_ptr<Event>>& events = tubes[tube]->getDataSet().getData();
+			for(size_t trigger = first; trigger < last; ++trigger)
+			{
+				Hit hit = {-1.0f, 0, 0};
+				if(events[trigger])
+				{
+					hit = extractHit(*events[trigger]);
+				}
+				m_hits[trigger * m_n_tubes + tube] = hit;
+			}
+		}
+	}
 }
 
 TriggerEventCollection::~TriggerEventCollection()
 {
-	// TODO Auto-generated destructor stub
 }
 
+/**
+ * Getter for the number of triggers stored in this collection.
+ *
+ * @brief Getter for number of triggers
+ *
+ * @return Number of triggers
+ */
+size_t TriggerEventCollection::getNumberOfTriggers() const
+{
+	return m_n_triggers;
+}
+
+/**
+ * Getter for the number of tubes, thus the number of hits stored per trigger.
+ *
+ * @brief Getter for number of tubes
+ *
+ * @return Number of tubes
+ */
+size_t TriggerEventCollection::getNumberOfTubes() const
+{
+	return m_n_tubes;
+}
+
+/**
+ * Getter for the hit of one tube for one trigger.
+ *
+ * @brief Getter for a single hit
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param trigger Number of the trigger
+ * @param tube Index of the tube
+ * @return Const reference to the hit
+ *
+ * @require trigger < getNumberOfTriggers() && tube < getNumberOfTubes()
+ */
+const Hit& TriggerEventCollection::getHit(const unsigned int trigger, const unsigned int tube) const
+{
+	return m_hits[trigger * m_n_tubes + tube];
+}
+
+/**
+ * Getter for all hits of one trigger. The returned pointer points to getNumberOfTubes() contiguous hits, ordered like the tubes.
+ *
+ * @brief Getter for the hits of a trigger
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param trigger Number of the trigger
+ * @return Pointer to the first hit of the trigger
+ *
+ * @require trigger < getNumberOfTriggers()
+ */
+const Hit* TriggerEventCollection::getHits(const unsigned int trigger) const
+{
+	return &m_hits[trigger * m_n_tubes];
+}
+
+/**
+ * Getter for the whole hit store. Hits are stored trigger-major, the hit of tube j for trigger i is at index
+ * i * getNumberOfTubes() + j.
+ *
+ * @brief Getter for all hits
+ *
+ * @return Const reference to the vector of hits
+ */
+const vector<Hit>& TriggerEventCollection::getData() const
+{
+	return m_hits;
+}
+
+/**
+ * Getter for the wire positions of the tubes in mm, ordered like the hits of a trigger.
+ *
+ * @brief Getter for the tube positions
+ *
+ * @return Const reference to the vector of positions
+ */
+const vector<array<double,2>>& TriggerEventCollection::getTubePositions() const
+{
+	return m_tube_positions;
+}
+
+/**
+ * Counts the tubes with a hit for one trigger.
+ *
+ * @brief Count hits of a trigger
+ *
+ * @param trigger Number of the trigger
+ * @return Number of tubes with a hit
+ */
+unsigned int TriggerEventCollection::countHits(const unsigned int trigger) const
+{
+	const Hit* hits = getHits(trigger);
+	unsigned int n = 0;
+	for(size_t tube = 0; tube < m_n_tubes; ++tube)
+	{
+		n += isHit(hits[tube]);
+	}
+	return n;
+}
+
+/**
+ * Returns, whether a Hit record contains an actual hit, thus a drift time was found.
+ *
+ * @brief Check for a hit
+ *
+ * @param hit The Hit to check
+ * @return true if there is a drift time
+ */
+bool TriggerEventCollection::isHit(const Hit& hit)
+{
+	return hit.driftTime >= 0;
+}
+
+/**
+ * Access operator for the hits of one trigger, see getHits(const unsigned int trigger).
+ *
+ * @param trigger Number of the trigger
+ * @return Pointer to the first hit of the trigger
+ */
+const Hit* TriggerEventCollection::operator[](const unsigned int trigger) const
+{
+	return getHits(trigger);
+}
+
+/**
+ * Extracts the compact Hit from an Event. The amplitude is the extremum of the event in the direction of the polarity
+ * relative to its baseline,
+ * the time over threshold is measured from the bin of the threshold crossing to the first bin above the threshold again. The drift time of
+ * the Hit is relative to the trigger bin of the AnalysisConfig like the drift time spectra and rt-relations, so it can be
+ * converted to a radius directly. Drift times before the trigger are set to 0, as in the spectra.
+ *
+ * @brief Extract a Hit from an Event
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param event The Event
+ * @return Hit record for the Event
+ */
+Hit TriggerEventCollection::extractHit(const Event& event)
+{
+	Hit hit = {-1.0f, 0, 0};
+	const EventSamples& data = event.getData();
+	const AnalysisConfig& config = AnalysisConfig::current();
+	const uint16_t threshold = config.getAbsoluteThreshold(event.getBaseline(),event.getNoise());
+
+	const bool negative = config.isNegative();
+	uint16_t minimum = 0xFFFF;
+	uint16_t maximum = 0;
+	for(size_t i = 0; i < data.size(); ++i)
+	{
+		minimum = data[i] < minimum ? data[i] : minimum;
+		maximum = data[i] > maximum ? data[i] : maximum;
+	}
+	hit.amplitude = (int16_t)lround((negative ? minimum : maximum) - event.getBaseline());
+
+	if(event.getDriftTime() < 0)
+	{
+		return hit;
+	}
+	const float triggerTime = config.getTriggerBin() * config.getBinsToTime();
+	hit.driftTime = event.getDriftTime() > triggerTime ? event.getDriftTime() - triggerTime : 0;
+
+	//with interpolated or cfd timing the drift time lies before the bin of the threshold crossing, where the pulse starts
+	size_t start = event.getDriftTime() / config.getBinsToTime();
+	while(start < data.size() && !(negative ? data[start] < threshold : data[start] > threshold))
+	{
+		++start;
+	}
+	size_t end = start;
+	while(end < data.size() && (negative ? data[end] <= threshold : data[end] >= threshold))
+	{
+		++end;
+	}
+	hit.tot = (end - start) * config.getBinsToTime();
+
+	return hit;
+}
@@ -6,14 +6,34 @@
  */
 
 #include <vector>
-//#include <stdint.h>
+#include <array>
+#include <memory>
 #include "Drifttube.h"
 
 #ifndef TRIGGEREVENTCOLLECTION_H_
 #define TRIGGEREVENTCOLLECTION_H_
 
+/**
+ * Compact record of the signal of one tube for one trigger.
+ *
+ * @brief Hit of one tube
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+typedef struct
+{
+	float driftTime; //ns after the trigger bin of the AnalysisConfig, negative if the tube has no hit for this trigger
+	int16_t amplitude; //FADC channels relative to the baseline of the event, signed like the threshold
+	uint16_t tot; //time over threshold of the pulse at the drift time in ns
+} Hit;
+
 /**
  * A triggersignal results in the readout of a raw voltage signal for each drift tube channel on the FADC.
+ * This collection holds one compact Hit per tube for every trigger. The hits are stored trigger-major, thus all hits of
+ * one trigger are contiguous in memory and iterating the triggers in order is a sequential scan. It is built from the
+ * tube-major DataSets of the tubes in a single parallel transpose pass.
  *
  * @author Stefan Bieschke
  * @version Alpha 2.0
@@ -22,13 +42,28 @@
 class TriggerEventCollection
 {
 public:
-	TriggerEventCollection();
+	TriggerEventCollection(const std::vector<std::unique_ptr<Drifttube>>& tubes);
 	~TriggerEventCollection();
 
+	size_t getNumberOfTriggers() const;
+	size_t getNumberOfTubes() const;
+	const Hit& getHit(const unsigned int trigger, const unsigned int tube) const;
+	const Hit* getHits(const unsigned int trigger) const;
+	const std::vector<Hit>& getData() const;
+	const std::vector<std::array<double,2>>& getTubePositions() const;
+	unsigned int countHits(const unsigned int trigger) const;
+
+	static bool isHit(const Hit& hit);
+
+	const Hit* operator[](const unsigned int trigger) const;
+
 private:
-	//TODO don't store raw pointers here
-	std::vector<Drifttube*> m_tubes;
-	unsigned int m_triggerID;
+	static Hit extractHit(const Event& event);
+
+	std::vector<Hit> m_hits; //m_hits[trigger * m_n_tubes + tube]
+	std::vector<std::array<double,2>> m_tube_positions; //mm
+	size_t m_n_tubes;
+	size_t m_n_triggers;
 };
 
 #endif /* TRIGGEREVENTCOLLECTION_H_ */
@@ -0,0 +1,277 @@
+/*
+ * TubePerformanceMap.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "TubePerformanceMap.h"
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Constructor. Creates empty histograms for all tubes.
+ *
+ * @brief ctor
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param nTubes Number of tubes, thus of FADC channels
+ * @param nBins Number of bins of the track distance between 0 and radius
+ * @param radius Upper edge of the last bin in mm
+ */
+TubePerformanceMap::TubePerformanceMap(const size_t nTubes, const unsigned int nBins, const double radius)
+{
+	m_n_tubes = nTubes;
+	m_n_bins = nBins;
+	m_radius = radius;
+	m_crossed.resize(nTubes * nBins,0);
+	m_hits.resize(nTubes * nBins,0);
+	m_residual_entries.resize(nTubes * nBins,0);
+	m_residual_sum.resize(nTubes * nBins,0.0);
+	m_residual_squares.resize(nTubes * nBins,0.0);
+}
+
+TubePerformanceMap::~TubePerformanceMap()
+{
+}
+
+/**
+ * Fills the histograms with the tracks of one file. The triggers are processed in parallel, each thread fills its own
+ * map, which is merged afterwards. The tubes crossed by a track are taken from the spatial index of the geometry.
+ *
+ * @brief Fill the histograms
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param hits Trigger aligned hits of all tubes, the tube index is the FADC channel
+ * @param tracks One track per trigger as returned by DataProcessor::reconstructTracks(...), invalid tracks are skipped
+ * @param geometry Geometry of the chamber
+ * @param rtRelations rt-relations of the tubes in the order of hits
+ */
+void TubePerformanceMap::fill(const TriggerEventCollection& hits, const vector<Track>& tracks, const ChamberGeometry& geometry, const vector<const RtRelation*>& rtRelations)
+{
+	const long nTriggers = tracks.size() < hits.getNumberOfTriggers() ? tracks.size() : hits.getNumberOfTriggers();
+	const size_t nTubes = hits.getNumberOfTubes() < m_n_tubes ? hits.getNumberOfTubes() : m_n_tubes;
+	const double binWidth = getBinWidth();
+
+	#pragma omp parallel
+	{
+		TubePerformanceMap threadMap(m_n_tubes,m_n_bins,m_radius);
+		vector<unsigned int> crossed;
+
+		#pragma omp for schedule(static,1024)
+		for(long trigger = 0; trigger < nTriggers; ++trigger)
+		{
+			const Track& track = tracks[trigger];
+			if(!track.isValid())
+			{
+				continue;
+			}
+			const Hit* triggerHits = hits.getHits(trigger);
+			geometry.tubesCrossedBy(track,crossed);
+			for(unsigned int index : crossed)
+			{
+				const TubeGeometry& tubeGeometry = geometry[index];
+				if(tubeGeometry.channel >= nTubes)
+				{
+					continue;
+				}
+				double distance = fabs(track.distanceTo(tubeGeometry.x,tubeGeometry.y));
+				unsigned int bin = (unsigned int)(distance / binWidth);
+				if(bin >= m_n_bins)
+				{
+					continue;
+				}
+				size_t entry = tubeGeometry.channel * m_n_bins + bin;
+				++threadMap.m_crossed[entry];
+
+				const Hit& hit = triggerHits[tubeGeometry.channel];
+				if(!TriggerEventCollection::isHit(hit))
+				{
+					continue;
+				}
+				++threadMap.m_hits[entry];
+				double residual = Track::driftRadius(*rtRelations[tubeGeometry.channel],hit.driftTime) - distance;
+				if(fabs(residual) < TRACK_HIT_WINDOW)
+				{
+					++threadMap.m_residual_entries[entry];
+					threadMap.m_residual_sum[entry] += residual;
+					threadMap.m_residual_squares[entry] += residual * residual;
+				}
+			}
+		}
+
+		#pragma omp critical
+		{
+			merge(threadMap);
+		}
+	}
+}
+
+/**
+ * Adds the histograms of another map, e.g. of another file of the same run.
+ *
+ * @brief Merge two maps
+ *
+ * @param other Map with the same number of tubes and the same binning
+ *
+ * @throw invalid_argument if the number of tubes or the binning differ
+ */
+void TubePerformanceMap::merge(const TubePerformanceMap& other)
+{
+	if(other.m_n_tubes != m_n_tubes || other.m_n_bins != m_n_bins || other.m_radius != m_radius)
+	{
+		throw invalid_argument("TubePerformanceMap::merge: different binning");
+	}
+	for(size_t i = 0; i < m_crossed.size(); ++i)
+	{
+		m_crossed[i] += other.m_crossed[i];
+		m_hits[i] += other.m_hits[i];
+		m_residual_entries[i] += other.m_residual_entries[i];
+		m_residual_sum[i] += other.m_residual_sum[i];
+		m_residual_squares[i] += other.m_residual_squares[i];
+	}
+}
+
+/**
+ * Getter for the number of tubes.
+ *
+ * @brief Getter for the number of tubes
+ *
+ * @return Number of tubes
+ */
+size_t TubePerformanceMap::getNumberOfTubes() const
+{
+	return m_n_tubes;
+}
+
+/**
+ * Getter for the number of distance bins per tube.
+ *
+ * @brief Getter for the number of bins
+ *
+ * @return Number of bins
+ */
+unsigned int TubePerformanceMap::getNumberOfBins() const
+{
+	return m_n_bins;
+}
+
+/**
+ * Getter for the width of the distance bins, bin i covers [i * width, (i + 1) * width).
+ *
+ * @brief Getter for the bin width
+ *
+ * @return Bin width in mm
+ */
+double TubePerformanceMap::getBinWidth() const
+{
+	return m_radius / m_n_bins;
+}
+
+/**
+ * Getter for the number of tracks, that crossed a tube within a distance bin.
+ *
+ * @brief Getter for the crossing tracks
+ *
+ * @param tube Index of the tube
+ * @param bin Distance bin
+ * @return Number of crossing tracks
+ */
+unsigned long TubePerformanceMap::getCrossed(const unsigned int tube, const unsigned int bin) const
+{
+	return m_crossed[tube * m_n_bins + bin];
+}
+
+/**
+ * Getter for the number of crossing tracks, for which the tube had a hit.
+ *
+ * @brief Getter for the hits
+ *
+ * @param tube Index of the tube
+ * @param bin Distance bin
+ * @return Number of hits
+ */
+unsigned long TubePerformanceMap::getHits(const unsigned int tube, const unsigned int bin) const
+{
+	return m_hits[tube * m_n_bins + bin];
+}
+
+/**
+ * Getter for the efficiency of a tube within a distance bin.
+ *
+ * @brief Efficiency versus radius
+ *
+ * @param tube Index of the tube
+ * @param bin Distance bin
+ * @return Hits over crossing tracks, 0 if no track crossed the bin
+ */
+double TubePerformanceMap::getEfficiency(const unsigned int tube, const unsigned int bin) const
+{
+	unsigned long crossed = getCrossed(tube,bin);
+	return crossed > 0 ? getHits(tube,bin) / (double)crossed : 0;
+}
+
+/**
+ * Getter for the efficiency of a tube integrated over all distances.
+ *
+ * @brief Efficiency of a tube
+ *
+ * @param tube Index of the tube
+ * @return Hits over crossing tracks, 0 if no track crossed the tube
+ */
+double TubePerformanceMap::getEfficiency(const unsigned int tube) const
+{
+	unsigned long crossed = 0;
+	unsigned long hits = 0;
+	for(unsigned int bin = 0; bin < m_n_bins; ++bin)
+	{
+		crossed += getCrossed(tube,bin);
+		hits += getHits(tube,bin);
+	}
+	return crossed > 0 ? hits / (double)crossed : 0;
+}
+
+/**
+ * Getter for the mean residual of a tube within a distance bin. A mean different from zero shows a wrong rt-relation.
+ *
+ * @brief Mean residual versus radius
+ *
+ * @param tube Index of the tube
+ * @param bin Distance bin
+ * @return Mean of drift radius minus track distance in mm, 0 without entries
+ */
+double TubePerformanceMap::getMeanResidual(const unsigned int tube, const unsigned int bin) const
+{
+	size_t entry = tube * m_n_bins + bin;
+	return m_residual_entries[entry] > 0 ? m_residual_sum[entry] / m_residual_entries[entry] : 0;
+}
+
+/**
+ * Getter for the spatial resolution of a tube within a distance bin, thus the RMS of the residuals. The tube itself is
+ * part of the track fit, so the value is slightly smaller than the unbiased resolution.
+ *
+ * @brief Resolution versus radius
+ *
+ * @param tube Index of the tube
+ * @param bin Distance bin
+ * @return RMS of the residuals in mm, 0 without entries
+ */
+double TubePerformanceMap::getResolution(const unsigned int tube, const unsigned int bin) const
+{
+	size_t entry = tube * m_n_bins + bin;
+	if(m_residual_entries[entry] == 0)
+	{
+		return 0;
+	}
+	double mean = m_residual_sum[entry] / m_residual_entries[entry];
+	double variance = m_residual_squares[entry] / m_residual_entries[entry] - mean * mean;
+	return variance > 0 ? sqrt(variance) : 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * TubePerformanceMap.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#ifndef TUBEPERFORMANCEMAP_H_
+#define TUBEPERFORMANCEMAP_H_
+
+#include <vector>
+#include "ChamberGeometry.h"
+#include "RtRelation.h"
+#include "Track.h"
+#include "TriggerEventCollection.h"
+#include "globals.h"
+#include "AnalysisConfig.h"
+
+/**
+ * Track based efficiency and resolution of every tube as a function of the distance of the track to the wire. For every
+ * reconstructed track the chamber geometry gives the tubes, that the track crossed. Each crossed tube counts as a trial
+ * in the bin of the track distance, a hit in the tube as a success. For tubes with hit, the residual (drift radius minus
+ * track distance) is histogrammed in the same bin, its RMS is the resolution. Tubes outside the acceptance of a track
+ * are not counted, unlike in Drifttube::getEfficiency().
+ * Maps of several files with the same binning can be merged, so that a run spread over many files is analysed in one
+ * pass over each file.
+ *
+ * @brief Per tube efficiency and resolution versus radius
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ */
+class TubePerformanceMap
+{
+public:
+	TubePerformanceMap(const size_t nTubes, const unsigned int nBins = 36, const double radius = AnalysisConfig::current().getTubeRadius());
+	~TubePerformanceMap();
+
+	void fill(const TriggerEventCollection& hits, const std::vector<Track>& tracks, const ChamberGeometry& geometry, const std::vector<const RtRelation*>& rtRelations);
+	void merge(const TubePerformanceMap& other);
+
+	size_t getNumberOfTubes() const;
+	unsigned int getNumberOfBins() const;
+	double getBinWidth() const;
+	unsigned long getCrossed(const unsigned int tube, const unsigned int bin) const;
+	unsigned long getHits(const unsigned int tube, const unsigned int bin) const;
+	double getEfficiency(const unsigned int tube, const unsigned int bin) const;
+	double getEfficiency(const unsigned int tube) const;
+	double getMeanResidual(const unsigned int tube, const unsigned int bin) const;
+	double getResolution(const unsigned int tube, const unsigned int bin) const;
+
+private:
+	size_t m_n_tubes;
+	unsigned int m_n_bins;
+	double m_radius; //mm
+	std::vector<unsigned long> m_crossed; //m_crossed[tube * m_n_bins + bin]
+	std::vector<unsigned long> m_hits;
+	std::vector<unsigned long> m_residual_entries; //hits with residual within TRACK_HIT_WINDOW
+	std::vector<double> m_residual_sum; //mm
+	std::vector<double> m_residual_squares; //mm^2
+};
+
+#endif /* TUBEPERFORMANCEMAP_H_ */
@@ -21,6 +21,7 @@
 static const double ADC_CHANNELS_TO_VOLTAGE = 2.0 / 4096; //V per channel
 static const short ADC_BINS_TO_TIME = 4; //ns
 static const unsigned short ADC_TRIGGERPOS_BIN = 0;
+static const unsigned short ADC_MAX_CHANNEL = 4095; //upper end of the FADC range
 
 //Absolute values if no dynamically calculated value is wanted.
 static const unsigned short ABSOLUTE_OFFSET_ZERO_VOLTAGE = 2200; //channels
@@ -31,6 +32,12 @@ static const double DRIFT_TUBE_RADIUS = 18.15;//mm
 //values for actual physics:
 static const short ABSOLUTE_EVENT_THRESHOLD_VOLTAGE = -300; //channels relative to OFFSET_ZERO_VOLTAGE
 static const short RELATIVE_THRESHOLD_VOLTAGE = -5; // times the mean amplitude of the noise
+static const unsigned short SATURATION_MARGIN = 25; //channels from the end of the FADC range, in which signals are saturated
+
+//variables for track reconstruction:
+static const unsigned int TRACK_MAX_COMBINATORIAL_HITS = 6; //triggers with more hits are seeded by the Legendre transform, limit of Track::fit(...)
+static const double TRACK_HIT_WINDOW = 2.0; //mm, maximum residual of a hit assigned to a track candidate
+static const double TRACK_RADIUS_RESOLUTION = 0.25; //mm, finest distance binning of the Legendre track finder
 
 
 #endif /* GLOBALS_H_ */
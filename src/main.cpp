@@ -4,6 +4,17 @@
 #include "omp.h"
 #include <cmath>
 #include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include "AnalysisConfig.h"
+#include "PulseTemplateFitter.h"
+#include "NoiseSpectrum.h"
+#include "EventFinder.h"
+#include "EventIndex.h"
+#include "RunComparison.h"
+#include "ThresholdScan.h"
+#include "DataPresenceException.h"
 
 
 using namespace std;
@@ -11,7 +22,8 @@ using namespace std;
 /**
  * A struct containing information given as commandline parameters on program start.
  * Contains information about the datafile that is to be used as well as the mode
- * of operation in that the program is to be executed.
+ * of operation in that the program is to be executed. The boolean flags select the products
+ * that are computed, anything that is not requested is not computed at all.
  *
  * @brief Parsed command line parameters
  *
@@ -23,16 +35,33 @@ typedef struct
 {
 	string infilename;
 	char mode;
+	bool efficiency;
+	bool dtSpect;
+	bool rtRelation;
+	bool afterpulses;
+	bool pulseShape;
+	bool noise;
+	bool signalEnd;
+	bool edges;
+	bool thresholdScan;
+	bool plot;
+	bool save;
+	bool hugePages;
+	string geometryFilename;
+	string runsFilename;
+	vector<int> thresholds;
+	AnalysisConfig config;
 } ParsedArgs;
 
 ParsedArgs parseCmdArgs(int argc, char** argv);
+int compareRuns(const ParsedArgs& args);
 
 //TODO rework comment
 /**
  * Startup of the application is managed here
- * 
+ *
  * @brief main
- * 
+ *
  * @author Stefan
  * @date May 27, 2016
  * @version 0.1
@@ -47,49 +76,230 @@ int main(int argc, char** argv)
 		return -1;
 	}
 
-	ParsedArgs args = parseCmdArgs(argc,argv);
+	ParsedArgs args;
+	try
+	{
+		args = parseCmdArgs(argc,argv);
+	}
+	catch(Exception& e)
+	{
+		cerr << "Cannot read the analysis configuration: " << e.error() << endl;
+		return -1;
+	}
+	catch(invalid_argument& e)
+	{
+		cerr << e.what() << endl;
+		return -1;
+	}
+	AnalysisConfig::setCurrent(args.config);
+	if(!args.runsFilename.empty())
+	{
+		return compareRuns(args);
+	}
 
 	string filename = args.infilename;
 	cout << "using file: " << filename << endl;
 
 	double beginRuntime = omp_get_wtime();
 
-	Archive archive(filename);
+	unique_ptr<Archive> archivePtr;
+	try
+	{
+		archivePtr.reset(new Archive(filename,args.hugePages,args.geometryFilename));
+	}
+	catch(Exception& e)
+	{
+		cerr << "Cannot read the data or chamber geometry: " << e.error() << endl;
+		return -1;
+	}
+	Archive& archive = *archivePtr;
 	string outFileName = archive.getDirname();
 	outFileName.append("processed_");
 	outFileName.append(archive.getFilename());
-	vector<vector<int>> integrals;
-	for(size_t i = 0; i < archive.getTubes()[0]->getDataSet().getSize(); ++i)
+	const Drifttube& tube = *archive.getTubes()[0];
+
+	if(args.efficiency)
 	{
+		double eff = tube.getEfficiency();
+		unsigned int entries = tube.getDriftTimeSpectrum().getEntries();
+		cout << "Efficiency: " << eff << " +- " << sqrt(eff * (1 - eff) / entries) << endl;
+	}
+	if(args.afterpulses)
+	{
+		const DriftTimeSpectrum& dt1 = tube.getDriftTimeSpectrum();
+		unsigned int afterpulses = DataProcessor::countAfterpulses(tube);
+		cout << "Afterpulses: " << afterpulses << " Probability: " << afterpulses/(double)(dt1.getEntries() - dt1.getRejected()) << endl;
+	}
+	if(args.pulseShape)
+	{
+		PulseTemplateFitter fitter;
 		try
 		{
-			integrals.push_back(DataProcessor::integrate(archive.getTubes()[0]->getDataSet()[i]));
+			size_t nTemplate = fitter.buildTemplate(tube.getDataSet());
+			vector<PulseFit> fits;
+			fitter.fit(tube,fits);
+			unsigned int types[PulseTemplateFitter::DISTORTED + 1] = {0};
+			unsigned int saturated = 0;
+			for(const PulseFit& fit : fits)
+			{
+				++types[fit.type];
+				saturated += fit.saturated;
+			}
+			cout << "Pulses: " << fits.size() << " Signals: " << types[PulseTemplateFitter::SIGNAL] << " Afterpulses: "
+					<< types[PulseTemplateFitter::AFTERPULSE] << " Pile-up: " << types[PulseTemplateFitter::PILE_UP]
+					<< " Distorted: " << types[PulseTemplateFitter::DISTORTED] << " Saturated: " << saturated
+					<< " (template of " << nTemplate << " pulses)" << endl;
+		}
+		catch(DataPresenceException& e)
+		{
+			cerr << "No isolated pulses for the pulse template" << endl;
+		}
+	}
+
+	vector<NoiseSpectrum> noiseSpectra;
+	if(args.noise)
+	{
+		for(size_t i = 0; i < archive.getTubes().size(); ++i)
+		{
+			noiseSpectra.push_back(NoiseSpectrum());
+			NoiseSpectrum& spectrum = noiseSpectra.back();
+			spectrum.accumulate(archive.getTubes()[i]->getDataSet());
+			cout << "Noise tube " << i << ": RMS " << sqrt(spectrum.getVariance()) << " from " << spectrum.getSegments() << " segments";
+			for(size_t line : spectrum.findLines())
+			{
+				cout << ", line at " << spectrum.getFrequency(line) << " MHz";
+			}
+			cout << endl;
 		}
-		catch(Exception& e)
+	}
+
+	if(args.signalEnd)
+	{
+		for(size_t i = 0; i < archive.getTubes().size(); ++i)
 		{
-			continue;
+			EventFinder finder(archive.getTubes()[i]->getDataSet(),EventIndex::filename(filename,i));
+			const string signal = "drifttime >= 0";
+			FeatureSummary end = finder.summarize("signalend",signal);
+			FeatureSummary minimum = finder.summarize("minimumpos",signal);
+			FeatureSummary integral = finder.summarize("integralmin",signal);
+			FeatureSummary saturated = finder.summarize("saturated");
+			cout << "Signal end tube " << i << ": " << end.mean << " +- " << end.rms << " ns, minimum at " << minimum.mean
+					<< " ns, integral minimum " << integral.mean << ", saturated " << 100 * saturated.mean << " %" << endl;
 		}
 	}
-	unsigned int afterpulses = DataProcessor::countAfterpulses(*archive.getTubes()[0]);
-	DriftTimeSpectrum dt1 = archive.getTubes()[0]->getDriftTimeSpectrum();
-	RtRelation rt1 = archive.getTubes()[0]->getRtRelation();
-	cout << "Afterpulses: " << afterpulses << " Probability: " << afterpulses/(double)(dt1.getEntries() - dt1.getRejected()) << endl;
+
+	if(args.edges)
+	{
+		const vector<unique_ptr<Drifttube>>& tubes = archive.getTubes();
+		const long nTubes = tubes.size();
+		//each tube fits and caches its own spectrum
+		#pragma omp parallel for schedule(dynamic)
+		for(long i = 0; i < nTubes; ++i)
+		{
+			tubes[i]->getDriftTimeEdges();
+		}
+		for(long i = 0; i < nTubes; ++i)
+		{
+			const DriftTimeEdges& edges = tubes[i]->getDriftTimeEdges();
+			cout << "t0 tube " << i << ": ";
+			if(edges.leading.valid)
+			{
+				cout << edges.leading.time << " +- " << edges.leading.error << " ns";
+			}
+			else
+			{
+				cout << "fit failed";
+			}
+			cout << ", tmax: ";
+			if(edges.trailing.valid)
+			{
+				cout << edges.trailing.time << " +- " << edges.trailing.error << " ns";
+			}
+			else
+			{
+				cout << "fit failed";
+			}
+			cout << endl;
+		}
+	}
+
+	if(args.thresholdScan)
+	{
+		const vector<unique_ptr<Drifttube>>& tubes = archive.getTubes();
+		vector<ThresholdScan> scans;
+		for(size_t i = 0; i < tubes.size(); ++i)
+		{
+			scans.push_back(ThresholdScan::scan(*tubes[i],args.thresholds));
+			const ThresholdScan& scan = scans.back();
+			for(size_t k = 0; k < scan.getNumberOfThresholds(); ++k)
+			{
+				cout << "Threshold " << scan.getThresholds()[k] << " tube " << i << ": efficiency " << scan.getEfficiency(k)
+						<< ", afterpulse probability " << scan.getAfterpulseProbability(k) << endl;
+			}
+		}
+
+		//threshold x drift time histogram of the first tube, one block per threshold
+		const ThresholdScan& scan = scans[0];
+		const double binWidth = AnalysisConfig::current().getBinsToTime();
+		ofstream f("scripts/plots/data/thresholdscan.dat");
+		for(size_t k = 0; k < scan.getNumberOfThresholds(); ++k)
+		{
+			const vector<uint32_t>& spectrum = scan.getHistogram()[k];
+			for(size_t bin = 0; bin < spectrum.size(); ++bin)
+			{
+				f << scan.getThresholds()[k] << "\t" << bin * binWidth << "\t" << spectrum[bin] << endl;
+			}
+			f << endl;
+		}
+		f.close();
+	}
 
 	double endRuntime = omp_get_wtime();
 
 	//save data as ASCII table for plotting in gnuplot - don't like it
-	ofstream f("scripts/plots/data/out.dat");
+	if(args.dtSpect || args.rtRelation || args.plot)
+	{
+		const DriftTimeSpectrum& dt1 = tube.getDriftTimeSpectrum();
+		ofstream f("scripts/plots/data/out.dat");
 
-	for(size_t i = 0; i < dt1.getData().size(); ++i)
+		for(size_t i = 0; i < dt1.getSize(); ++i)
+		{
+			f << i * AnalysisConfig::current().getSpectrumBinWidth() << "\t" << dt1[i];
+			if(args.rtRelation || args.plot)
+			{
+				f << "\t" << tube.getRtRelation()[i];
+			}
+			f << endl;
+		}
+		f.close();
+	}
+
+	//noise power spectra of all tubes next to the drift time spectrum, one column per tube
+	if(!noiseSpectra.empty())
 	{
-		f << 4*i << "\t" << dt1[i] << "\t" << rt1[i] << endl;
+		ofstream f("scripts/plots/data/noise.dat");
+		for(size_t k = 0; k < noiseSpectra[0].getSize(); ++k)
+		{
+			f << noiseSpectra[0].getFrequency(k);
+			for(const NoiseSpectrum& spectrum : noiseSpectra)
+			{
+				f << "\t" << spectrum.getPower(k);
+			}
+			f << endl;
+		}
+		f.close();
 	}
-	f.close();
 
-	//TODO get rid of system call... why system() is evil http://www.cplusplus.com/forum/articles/11153/
-	system("gnuplot -p scripts/plots/dtAndRt.plt");
+	if(args.plot)
+	{
+		//TODO get rid of system call... why system() is evil http://www.cplusplus.com/forum/articles/11153/
+		system("gnuplot -p scripts/plots/dtAndRt.plt");
+	}
 
-	archive.writeToFile(outFileName);
+	if(args.save)
+	{
+		archive.writeToFile(outFileName);
+	}
 
 
 	cout << "Computation without saving took " << endRuntime - beginRuntime << " seconds" << endl;
@@ -97,22 +307,206 @@ int main(int argc, char** argv)
 	return 0;
 }
 
-//TODO to be implemented
+/**
+ * Parses the command line arguments. Known arguments are:
+ * 	if=path/to/file.drift - the input file
+ * 	products=eff,dt,rt,ap,shape,noise,end,edges,scan,plot,save - comma separated list of the products that shall be computed. Without this
+ * 	argument, eff,dt,rt,ap,plot,save are computed. The expensive products shape, noise, end, edges and scan are only computed on request.
+ * 	thresholds=-100,-200,-300 - thresholds of the threshold scan relative to the baseline. Without this argument, 0.2 to 2 times the
+ * 	configured threshold are scanned. The scan turns zero suppression off, as suppressed events could cross the lower thresholds.
+ * 	hugepages=1 - back the memory for the Events with transparent huge pages
+ * 	geometry=path/to/chamber.geo - chamber geometry file, see ChamberGeometry. Without it, a single layer of tubes is assumed.
+ * 	config=path/to/analysis.cfg - analysis configuration file, see AnalysisConfig. Without it, the values of globals.h are used.
+ * 	runs=path/to/runs.list - compare the runs in the list instead of analysing a single file, see compareRuns(...)
+ * 	key=value - any key of AnalysisConfig::set(...), e.g. threshold=-250. These override the configuration file.
+ *
+ * @brief Parse command line arguments
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return ParsedArgs struct containing the parsed arguments
+ *
+ * @throw DataPresenceException if the configuration file cannot be read
+ * @throw invalid_argument for invalid configuration values
+ */
 ParsedArgs parseCmdArgs(int argc, char** argv)
 {
 	ParsedArgs result;
+	result.mode = 0;
+	result.hugePages = false;
+	result.pulseShape = result.noise = result.signalEnd = result.edges = result.thresholdScan = false;
+	result.efficiency = result.dtSpect = result.rtRelation = result.afterpulses = result.plot = result.save = true;
+	string configFilename;
+	vector<pair<string,string>> overrides;
 	if(argc > 1)
 	{
 		for(int i = 0; i < argc; i++)
 		{
-			if(argv[i][0] == 'i' && argv[i][1] == 'f' && argv[i][2] == '=')
+			string arg(argv[i]);
+			size_t equalSignPos = arg.find_first_of('=') + 1;
+			if(arg.compare(0,3,"if=") == 0)
 			{
-				string file(argv[i]);
-				int equalSignPos = file.find_first_of('=') + 1;
-				string filename = file.substr(equalSignPos,file.length());
+				string filename = arg.substr(equalSignPos,arg.length());
 				result.infilename = filename;
 			}
+			else if(arg.compare(0,9,"products=") == 0)
+			{
+				result.efficiency = result.dtSpect = result.rtRelation = result.afterpulses = result.pulseShape = result.noise = result.signalEnd = result.edges = result.thresholdScan = result.plot = result.save = false;
+				stringstream products(arg.substr(equalSignPos));
+				string product;
+				while(getline(products,product,','))
+				{
+					result.efficiency |= product == "eff";
+					result.dtSpect |= product == "dt";
+					result.rtRelation |= product == "rt";
+					result.afterpulses |= product == "ap";
+					result.pulseShape |= product == "shape";
+					result.noise |= product == "noise";
+					result.signalEnd |= product == "end";
+					result.edges |= product == "edges";
+					result.thresholdScan |= product == "scan";
+					result.plot |= product == "plot";
+					result.save |= product == "save";
+				}
+			}
+			else if(arg.compare(0,11,"thresholds=") == 0)
+			{
+				stringstream thresholds(arg.substr(equalSignPos));
+				string threshold;
+				while(getline(thresholds,threshold,','))
+				{
+					try
+					{
+						result.thresholds.push_back(stoi(threshold));
+					}
+					catch(logic_error& e)
+					{
+						throw invalid_argument("Invalid threshold: " + threshold);
+					}
+				}
+			}
+			else if(arg.compare(0,10,"hugepages=") == 0)
+			{
+				result.hugePages = arg.substr(equalSignPos) == "1";
+			}
+			else if(arg.compare(0,9,"geometry=") == 0)
+			{
+				result.geometryFilename = arg.substr(equalSignPos);
+			}
+			else if(arg.compare(0,7,"config=") == 0)
+			{
+				configFilename = arg.substr(equalSignPos);
+			}
+			else if(arg.compare(0,5,"runs=") == 0)
+			{
+				result.runsFilename = arg.substr(equalSignPos);
+			}
+			else if(equalSignPos > 0)
+			{
+				overrides.push_back(make_pair(arg.substr(0,equalSignPos - 1),arg.substr(equalSignPos)));
+			}
+		}
+	}
+	if(!configFilename.empty())
+	{
+		result.config = AnalysisConfig::load(configFilename);
+	}
+	for(const pair<string,string>& option : overrides)
+	{
+		if(!result.config.set(option.first,option.second))
+		{
+			cerr << "Unknown argument: " << option.first << endl;
+		}
+	}
+	if(result.thresholdScan)
+	{
+		if(result.config.isZeroSuppressed())
+		{
+			cout << "Threshold scan: zero suppression turned off" << endl;
+			result.config.set("zerosuppression","0");
+		}
+		for(int k = 1; result.thresholds.empty() && k <= 10; ++k)
+		{
+			result.thresholds.push_back(result.config.getThreshold() * k / 5);
 		}
 	}
 	return result;
 }
+
+/**
+ * Compares many runs, e.g. of a scan of gas mixtures, see RunComparison. The runs are read from a list of data files,
+ * one per line, and loaded in parallel. Every run is compared tube by tube with the first run of the list. The deviations
+ * of the rt-relations of the first tube from a straight line are written to scripts/plots/data/linearity.dat, one column
+ * per run.
+ *
+ * @brief Compare runs
+ *
+ * @author Stefan Bieschke
+ * @date Oct. 18, 2026
+ * @version 1.0
+ *
+ * @param args Parsed arguments with the list of runs and the chamber geometry
+ * @return 0 on success, -1 if the list cannot be read or no run can be loaded
+ */
+int compareRuns(const ParsedArgs& args)
+{
+	double beginRuntime = omp_get_wtime();
+	RunComparison comparison;
+	try
+	{
+		comparison.load(RunComparison::readList(args.runsFilename),args.geometryFilename);
+	}
+	catch(Exception& e)
+	{
+		cerr << "Cannot read the list of runs: " << e.error() << endl;
+		return -1;
+	}
+	for(const string& failed : comparison.getFailed())
+	{
+		cerr << "Cannot read run " << failed << endl;
+	}
+	const vector<RunResult>& runs = comparison.getRuns();
+	if(runs.empty())
+	{
+		return -1;
+	}
+	cout << "Reference: " << runs[0].filename << endl;
+	for(const RunDifference& difference : comparison.compare())
+	{
+		cout << runs[difference.run].filename << " tube " << difference.tube << ": chi2/ndf " << difference.chi2 << "/"
+				<< difference.ndf << ", KS distance " << difference.ksDistance << " (probability " << difference.ksProbability
+				<< "), rt difference " << difference.rtDifference << " mm" << endl;
+	}
+
+	//deviation k belongs to the radius (k + 1) * 0.1 mm
+	vector<vector<double>> deviations(runs.size());
+	size_t nRadii = 0;
+	for(size_t i = 0; i < runs.size(); ++i)
+	{
+		RunComparison::linearity(runs[i].rtRelations[0],runs[i].radii[0],deviations[i]);
+		nRadii = max(nRadii,deviations[i].size());
+	}
+	ofstream f("scripts/plots/data/linearity.dat");
+	const double step = 0.1;
+	for(size_t k = 0; k < nRadii; ++k)
+	{
+		f << (k + 1) * step;
+		for(const vector<double>& deviation : deviations)
+		{
+			f << "\t";
+			if(k < deviation.size())
+			{
+				f << deviation[k];
+			}
+			else
+			{
+				f << NAN;
+			}
+		}
+		f << endl;
+	}
+	f.close();
+
+	cout << "Comparison of " << runs.size() << " runs took " << omp_get_wtime() - beginRuntime << " seconds" << endl;
+	return 0;
+}
@@ -0,0 +1,206 @@
+/*
+ * AnalysisConfig_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../AnalysisConfig.h"
+#include "../DataProcessor.h"
+#include "../DataSet.h"
+#include "../Event.h"
+#include "../DataPresenceException.h"
+#include "../EdgeFitter.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <cstdio>
+#include <stdexcept>
+
+using namespace std;
+
+class AnalysisConfigTest : public ::testing::Test
+{
+public:
+	AnalysisConfigTest()
+	{
+		//negative pulse of depth 500 at bin 30, positive pulse of height 500 at bin 60
+		samples = new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE);
+		for(unsigned int bin = 30; bin < 36; ++bin)
+		{
+			(*samples)[bin] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 500;
+		}
+		for(unsigned int bin = 60; bin < 66; ++bin)
+		{
+			(*samples)[bin] = ABSOLUTE_OFFSET_ZERO_VOLTAGE + 500;
+		}
+	}
+
+	~AnalysisConfigTest()
+	{
+		delete samples;
+	}
+
+protected:
+	vector<uint16_t>* samples;
+};
+
+TEST_F(AnalysisConfigTest,TestDefaults)
+{
+	AnalysisConfig config;
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE,config.getOffset());
+	ASSERT_EQ(ABSOLUTE_EVENT_THRESHOLD_VOLTAGE,config.getThreshold());
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE + ABSOLUTE_EVENT_THRESHOLD_VOLTAGE,config.getAbsoluteThreshold());
+	ASSERT_TRUE(config.isNegative());
+	ASSERT_EQ(ADC_BINS_TO_TIME,config.getBinsToTime());
+	ASSERT_EQ(ADC_TRIGGERPOS_BIN,config.getTriggerBin());
+	ASSERT_DOUBLE_EQ(DRIFT_TUBE_RADIUS,config.getTubeRadius());
+#ifdef ZEROSUP
+	ASSERT_TRUE(config.isZeroSuppressed());
+#else
+	ASSERT_FALSE(config.isZeroSuppressed());
+#endif
+}
+
+TEST_F(AnalysisConfigTest,TestSet)
+{
+	AnalysisConfig config;
+	ASSERT_TRUE(config.set("threshold","-250"));
+	ASSERT_TRUE(config.set("polarity","positive"));
+	ASSERT_TRUE(config.set("radius","15"));
+	ASSERT_TRUE(config.set("zerosuppression","0"));
+	//the threshold follows the polarity
+	ASSERT_EQ(250,config.getThreshold());
+	ASSERT_FALSE(config.isNegative());
+	ASSERT_DOUBLE_EQ(15.0,config.getTubeRadius());
+	ASSERT_FALSE(config.isZeroSuppressed());
+
+	ASSERT_FALSE(config.set("products","eff"));
+	ASSERT_THROW(config.set("threshold","-25x"),invalid_argument);
+	ASSERT_THROW(config.set("polarity","up"),invalid_argument);
+	ASSERT_THROW(config.set("binstotime","0"),invalid_argument);
+	ASSERT_THROW(config.set("threshold","-250"),invalid_argument);
+	ASSERT_EQ(250,config.getThreshold());
+
+	ASSERT_TRUE(config.set("offset","100"));
+	ASSERT_EQ(100 + 250,config.getAbsoluteThreshold());
+
+	//noisy events of positive polarity keep the threshold above the baseline
+	ASSERT_EQ(0,config.getBaselineBins());
+	ASSERT_TRUE(config.set("baselinebins","64"));
+	ASSERT_TRUE(config.set("relativethreshold","-6"));
+	ASSERT_EQ(64,config.getBaselineBins());
+	ASSERT_EQ(2000 + 250,config.getAbsoluteThreshold(2000,10));
+	ASSERT_EQ(2000 + 300,config.getAbsoluteThreshold(2000,50));
+
+	ASSERT_TRUE(config.set("polarity","negative"));
+	ASSERT_EQ(-250,config.getThreshold());
+	ASSERT_THROW(config.set("threshold","250"),invalid_argument);
+	ASSERT_EQ(0,config.getAbsoluteThreshold());
+	ASSERT_EQ(2000 - 250,config.getAbsoluteThreshold(2000,10));
+	ASSERT_EQ(2000 - 300,config.getAbsoluteThreshold(2000,50));
+
+	ASSERT_TRUE(config.getFilter().empty());
+	ASSERT_TRUE(config.set("filter","average:3+derivative:2"));
+	ASSERT_EQ("average:3+derivative:2",config.getFilter());
+	ASSERT_THROW(config.set("filter","average:0"),invalid_argument);
+
+	ASSERT_EQ(AnalysisConfig::THRESHOLD,config.getTiming());
+	ASSERT_TRUE(config.set("timing","cfd"));
+	ASSERT_TRUE(config.set("cfdfraction","0.5"));
+	ASSERT_TRUE(config.set("cfdwindow","20"));
+	ASSERT_EQ(AnalysisConfig::CONSTANT_FRACTION,config.getTiming());
+	ASSERT_FLOAT_EQ(0.5,config.getCfdFraction());
+	ASSERT_EQ(20,config.getCfdWindow());
+	ASSERT_THROW(config.set("timing","leading"),invalid_argument);
+	ASSERT_THROW(config.set("cfdfraction","1"),invalid_argument);
+	ASSERT_THROW(config.set("cfdwindow","0"),invalid_argument);
+
+	ASSERT_EQ(EdgeFitter::FERMI,config.getEdgeModel());
+	ASSERT_TRUE(config.set("edgefit","linear"));
+	ASSERT_EQ(EdgeFitter::LINEAR,config.getEdgeModel());
+	ASSERT_THROW(config.set("edgefit","gauss"),invalid_argument);
+
+	ASSERT_EQ(1,config.getSubBins());
+	ASSERT_TRUE(config.set("subbins","4"));
+	ASSERT_EQ(4,config.getSubBins());
+	ASSERT_DOUBLE_EQ(ADC_BINS_TO_TIME / 4.0,config.getSpectrumBinWidth());
+	ASSERT_THROW(config.set("subbins","0"),invalid_argument);
+
+	ASSERT_TRUE(config.set("polarity","negative"));
+	ASSERT_EQ(SATURATION_MARGIN,config.getSaturationLevel());
+	ASSERT_TRUE(config.set("saturation","10"));
+	ASSERT_EQ(10,config.getSaturationLevel());
+	ASSERT_TRUE(config.set("polarity","positive"));
+	ASSERT_EQ(ADC_MAX_CHANNEL - 10,config.getSaturationLevel());
+	ASSERT_THROW(config.set("saturation","5000"),invalid_argument);
+}
+
+TEST_F(AnalysisConfigTest,TestLoad)
+{
+	const char* filename = "AnalysisConfig_test.cfg";
+	ofstream file(filename);
+	file << "# analysis configuration" << endl;
+	file << "offset = 2100" << endl;
+	file << "  threshold=-400  " << endl;
+	file << endl;
+	file << "binstotime = 2" << endl;
+	file.close();
+
+	AnalysisConfig config = AnalysisConfig::load(filename);
+	ASSERT_EQ(2100,config.getOffset());
+	ASSERT_EQ(1700,config.getAbsoluteThreshold());
+	ASSERT_EQ(2,config.getBinsToTime());
+	ASSERT_DOUBLE_EQ(DRIFT_TUBE_RADIUS,config.getTubeRadius());
+
+	file.open(filename);
+	file << "treshold = -400" << endl;
+	file.close();
+	ASSERT_THROW(AnalysisConfig::load(filename),invalid_argument);
+	remove(filename);
+
+	ASSERT_THROW(AnalysisConfig::load("does/not/exist.cfg"),DataPresenceException);
+}
+
+TEST_F(AnalysisConfigTest,TestKernels)
+{
+	AnalysisConfig positive;
+	positive.set("polarity","positive");
+	positive.set("threshold","300");
+	ASSERT_EQ(30,DataProcessor::findDriftTimeBin(samples->data(),samples->size(),AnalysisConfig()));
+	ASSERT_EQ(60,DataProcessor::findDriftTimeBin(samples->data(),samples->size(),positive));
+	ASSERT_EQ(30,(DataProcessor::findDriftTimeBin<true,800>(samples->data(),0,ABSOLUTE_OFFSET_ZERO_VOLTAGE - 300)));
+	ASSERT_EQ(-42,(DataProcessor::findDriftTimeBin<false,800>(samples->data(),0,ABSOLUTE_OFFSET_ZERO_VOLTAGE + 600)));
+}
+
+TEST_F(AnalysisConfigTest,TestScope)
+{
+	AnalysisConfig config;
+	config.set("polarity","positive");
+	config.set("threshold","300");
+	config.set("binstotime","3");
+	config.set("zerosuppression","0");
+	{
+		AnalysisConfig::Scope scope(config);
+		ASSERT_EQ(&config,&AnalysisConfig::current());
+
+		Event event(0,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(*samples)));
+		ASSERT_DOUBLE_EQ(180.0,event.getDriftTime());
+
+		//without zero suppression, events without signal are rejected by the DataSet
+		vector<unique_ptr<Event>> events;
+		events.push_back(unique_ptr<Event>(new Event(0,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(*samples)))));
+		events.push_back(unique_ptr<Event>(new Event(1,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE)))));
+		DataSet data(events);
+		ASSERT_EQ(1,data.getRejected());
+		ASSERT_EQ(1,data.getDriftTimeHistogram()[60]);
+	}
+	ASSERT_TRUE(AnalysisConfig::current().isNegative());
+	Event event(0,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(*samples)));
+	ASSERT_DOUBLE_EQ(120.0,event.getDriftTime());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,4 +1,5 @@
 #include "../Archive.h"
+#include "../DataPresenceException.h"
 #include <gtest/gtest.h>
 #include <array>
 #include <string>
@@ -37,6 +38,78 @@ TEST_F(ArchiveTest,TestParser)
 }
 
 
+TEST_F(ArchiveTest,TestZeroSuppressionAtRead)
+{
+	//write a file with one tube and three events, only event 1 has a drift time (bin 20)
+	string filename = "zeroSuppressionTest.drift";
+	{
+		ofstream file(filename, ios::out | ios::binary);
+		uint32_t header[3] = {1,3,100};
+		file.write((char*)header,sizeof(header));
+		for(uint32_t i = 0; i < 3; ++i)
+		{
+			vector<uint16_t> samples(100,ABSOLUTE_OFFSET_ZERO_VOLTAGE);
+			if(i == 1)
+			{
+				samples[20] = ABSOLUTE_OFFSET_ZERO_VOLTAGE + 2 * ABSOLUTE_EVENT_THRESHOLD_VOLTAGE;
+			}
+			file.write((char*)samples.data(),samples.size() * sizeof(uint16_t));
+		}
+	}
+	Archive archive(filename);
+	remove(filename.c_str());
+
+	const Drifttube& tube = *archive.getTubes()[0];
+	ASSERT_EQ(3,tube.getDataSet().getSize());
+	ASSERT_EQ(80,tube.getDataSet()[1].getDriftTime());
+	ASSERT_EQ(1,tube.getDriftTimeSpectrum()[20 - ADC_TRIGGERPOS_BIN]);
+#ifdef ZEROSUP
+	ASSERT_EQ(nullptr,tube.getDataSet().getData()[0].get());
+	ASSERT_EQ(nullptr,tube.getDataSet().getData()[2].get());
+#endif
+	ASSERT_DOUBLE_EQ(1/3.0,tube.getEfficiency());
+}
+
+TEST_F(ArchiveTest,TestFilterKeepsRawData)
+{
+	//a single spike at bin 20, the moving average spreads it over bins 19 to 21
+	string filename = "filterTest.drift";
+	{
+		ofstream file(filename, ios::out | ios::binary);
+		uint32_t header[3] = {1,1,100};
+		file.write((char*)header,sizeof(header));
+		vector<uint16_t> samples(100,ABSOLUTE_OFFSET_ZERO_VOLTAGE);
+		samples[20] = ABSOLUTE_OFFSET_ZERO_VOLTAGE + 6 * ABSOLUTE_EVENT_THRESHOLD_VOLTAGE;
+		file.write((char*)samples.data(),samples.size() * sizeof(uint16_t));
+	}
+	AnalysisConfig config;
+	config.set("filter","average:3");
+	AnalysisConfig::Scope scope(config);
+	Archive archive(filename);
+	remove(filename.c_str());
+
+	const Event& event = archive.getTubes()[0]->getDataSet()[0];
+	ASSERT_EQ(76,event.getDriftTime());
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE,event[19]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE + 6 * ABSOLUTE_EVENT_THRESHOLD_VOLTAGE,event[20]);
+}
+
+TEST_F(ArchiveTest,TestTruncatedFile)
+{
+	//the header claims three events, but only two are in the file
+	string filename = "truncatedTest.drift";
+	{
+		ofstream file(filename, ios::out | ios::binary);
+		uint32_t header[3] = {1,3,100};
+		file.write((char*)header,sizeof(header));
+		vector<uint16_t> samples(100,ABSOLUTE_OFFSET_ZERO_VOLTAGE);
+		file.write((char*)samples.data(),samples.size() * sizeof(uint16_t));
+		file.write((char*)samples.data(),samples.size() * sizeof(uint16_t));
+	}
+	ASSERT_THROW(Archive archive(filename),DataPresenceException);
+	remove(filename.c_str());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
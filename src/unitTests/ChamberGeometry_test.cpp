@@ -0,0 +1,113 @@
+/*
+ * ChamberGeometry_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../ChamberGeometry.h"
+#include "../DataPresenceException.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+
+using namespace std;
+
+class ChamberGeometryTest : public ::testing::Test
+{
+public:
+	ChamberGeometryTest()
+	{
+		//staggered chamber of 8 layers with 16 tubes each
+		vector<TubeGeometry> tubes;
+		for(unsigned int layer = 0; layer < 8; ++layer)
+		{
+			for(unsigned int tube = 0; tube < 16; ++tube)
+			{
+				TubeGeometry geometry;
+				geometry.channel = layer * 16 + tube;
+				geometry.x = 2 * DRIFT_TUBE_RADIUS * tube + DRIFT_TUBE_RADIUS * (layer % 2);
+				geometry.y = 31.5 * layer;
+				geometry.radius = DRIFT_TUBE_RADIUS;
+				tubes.push_back(geometry);
+			}
+		}
+		chamber = new ChamberGeometry(tubes);
+	}
+
+	~ChamberGeometryTest()
+	{
+		delete chamber;
+	}
+
+protected:
+	ChamberGeometry* chamber;
+};
+
+TEST_F(ChamberGeometryTest,TestLoad)
+{
+	const char* filename = "ChamberGeometry_test.geo";
+	ofstream file(filename);
+	file << "# channel x y radius" << endl;
+	file << "3 0.0 0.0 15.0" << endl;
+	file << "0 21.0 36.4" << endl;
+	file.close();
+
+	ChamberGeometry geometry = ChamberGeometry::load(filename);
+	remove(filename);
+	ASSERT_EQ(2,geometry.getNumberOfTubes());
+	ASSERT_EQ(1,geometry.findChannel(0));
+	ASSERT_EQ(-1,geometry.findChannel(1));
+	ASSERT_EQ(0,geometry.findChannel(3));
+	ASSERT_EQ(-1,geometry.findChannel(42));
+	ASSERT_DOUBLE_EQ(15.0,geometry[0].radius);
+	ASSERT_DOUBLE_EQ(21.0,geometry[1].x);
+	ASSERT_DOUBLE_EQ(36.4,geometry[1].y);
+	ASSERT_DOUBLE_EQ(DRIFT_TUBE_RADIUS,geometry[1].radius);
+
+	ASSERT_THROW(ChamberGeometry::load("does/not/exist.geo"),DataPresenceException);
+}
+
+TEST_F(ChamberGeometryTest,TestSingleLayer)
+{
+	ChamberGeometry layer = ChamberGeometry::singleLayer(3);
+	ASSERT_EQ(3,layer.getNumberOfTubes());
+	ASSERT_DOUBLE_EQ(4 * DRIFT_TUBE_RADIUS,layer[2].x);
+	ASSERT_EQ(2,layer.findChannel(2));
+
+	//a vertical track through the middle of the first tube
+	vector<unsigned int> crossed = layer.tubesCrossedBy(Track(0,1.0));
+	ASSERT_EQ(1,crossed.size());
+	ASSERT_EQ(0,crossed[0]);
+	//a track parallel to the layer crosses all tubes
+	ASSERT_EQ(3,layer.tubesCrossedBy(Track(M_PI / 2,0.5)).size());
+	//a track far away crosses none
+	ASSERT_EQ(0,layer.tubesCrossedBy(Track(M_PI / 2,100.0)).size());
+}
+
+TEST_F(ChamberGeometryTest,TestTubesCrossedBy)
+{
+	vector<unsigned int> crossed;
+	for(unsigned int i = 0; i < 200; ++i)
+	{
+		Track track(i * 0.0157,i * 1.7 - 50);
+		chamber->tubesCrossedBy(track,crossed);
+
+		vector<unsigned int> expected;
+		for(unsigned int tube = 0; tube < chamber->getNumberOfTubes(); ++tube)
+		{
+			if(fabs(track.distanceTo((*chamber)[tube].x,(*chamber)[tube].y)) < (*chamber)[tube].radius)
+			{
+				expected.push_back(tube);
+			}
+		}
+		ASSERT_EQ(expected,crossed);
+	}
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,107 @@
+/*
+ * CoincidenceAnalysis_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../CoincidenceAnalysis.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace std;
+
+class CoincidenceAnalysisTest : public ::testing::Test
+{
+public:
+	CoincidenceAnalysisTest()
+	{
+		//tube 0 at 200 ns and tube 1 at 232 ns in every trigger, tube 2 at 160 ns in even triggers, tube 3 never
+		const unsigned int pulseBins[4] = {50, 58, 40, 0};
+		for(unsigned int tube = 0; tube < 4; ++tube)
+		{
+			vector<unique_ptr<Event>> events;
+			for(unsigned int i = 0; i < 300; ++i)
+			{
+				unique_ptr<vector<uint16_t>> data(new vector<uint16_t>(200,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+				if(tube < 2 || (tube == 2 && i % 2 == 0))
+				{
+					for(unsigned int bin = pulseBins[tube]; bin < pulseBins[tube] + 10; ++bin)
+					{
+						(*data)[bin] = 1500;
+					}
+				}
+				events.push_back(unique_ptr<Event>(new Event(i,move(data))));
+			}
+			tubes.push_back(unique_ptr<Drifttube>(new Drifttube(tube * 42,10,unique_ptr<DataSet>(new DataSet(events)))));
+		}
+		hits = new TriggerEventCollection(tubes);
+	}
+
+	~CoincidenceAnalysisTest()
+	{
+		delete hits;
+	}
+
+protected:
+	vector<unique_ptr<Drifttube>> tubes;
+	TriggerEventCollection* hits;
+};
+
+TEST_F(CoincidenceAnalysisTest,TestPairs)
+{
+	CoincidenceAnalysis analysis(4);
+	ASSERT_EQ(6,analysis.getNumberOfPairs());
+	ASSERT_EQ(0,analysis.getPairIndex(0,1));
+	ASSERT_EQ(2,analysis.getPairIndex(0,3));
+	ASSERT_EQ(3,analysis.getPairIndex(1,2));
+	ASSERT_EQ(5,analysis.getPairIndex(3,2));
+	ASSERT_EQ(400,analysis.getNumberOfBins());
+}
+
+TEST_F(CoincidenceAnalysisTest,TestFill)
+{
+	CoincidenceAnalysis analysis(4);
+	analysis.fill(*hits);
+	ASSERT_EQ(300,analysis.getNumberOfTriggers());
+	ASSERT_EQ(300,analysis.getHits(1));
+	ASSERT_EQ(150,analysis.getHits(2));
+	ASSERT_EQ(0,analysis.getHits(3));
+	ASSERT_EQ(300,analysis.getCoincidences(0,1));
+	ASSERT_EQ(150,analysis.getCoincidences(2,1));
+	ASSERT_EQ(0,analysis.getCoincidences(0,3));
+
+	//t1 - t0 = 32 ns and t2 - t0 = -40 ns
+	const unsigned int* deltaT = analysis.getDeltaTHistogram(0,1);
+	ASSERT_EQ(300,deltaT[(32 + 800) / 4]);
+	ASSERT_DOUBLE_EQ(34,analysis.getBinCenter((32 + 800) / 4));
+	ASSERT_EQ(150,analysis.getDeltaTHistogram(0,2)[(-40 + 800) / 4]);
+
+	ASSERT_EQ(150,analysis.getMultiplicity()[2]);
+	ASSERT_EQ(150,analysis.getMultiplicity()[3]);
+	ASSERT_EQ(150,analysis.getMultiplicity(0,1)[2]);
+	ASSERT_EQ(150,analysis.getMultiplicity(0,1)[3]);
+	ASSERT_EQ(0,analysis.getMultiplicity(0,2)[2]);
+}
+
+TEST_F(CoincidenceAnalysisTest,TestMerge)
+{
+	CoincidenceAnalysis first(4);
+	CoincidenceAnalysis second(4);
+	first.fill(*hits);
+	second.fill(*hits);
+	first.merge(second);
+	ASSERT_EQ(600,first.getNumberOfTriggers());
+	ASSERT_EQ(600,first.getDeltaTHistogram(0,1)[(32 + 800) / 4]);
+
+	CoincidenceAnalysis other(4,400);
+	ASSERT_THROW(first.merge(other),invalid_argument);
+	CoincidenceAnalysis wrongTubes(3);
+	ASSERT_THROW(wrongTubes.fill(*hits),invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
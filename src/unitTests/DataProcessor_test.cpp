@@ -6,6 +6,7 @@
 #include "../DriftTimeSpectrum.h"
 #include "../DataSet.h"
 #include "../globals.h"
+#include "../TriggerEventCollection.h"
 
 using namespace std;
 
@@ -102,6 +103,74 @@ TEST_F(DataProcessorTest,TestFindDriftTime)
 {
 	ASSERT_EQ(400,DataProcessor::findDriftTimeBin(*min_at_400,6));
 	ASSERT_EQ(-42,DataProcessor::findDriftTimeBin(*max_uint,100));
+
+	//raw buffer
+	ASSERT_EQ(400,DataProcessor::findDriftTimeBin(min_at_400->getData().data(),min_at_400->getSize(),6));
+	ASSERT_EQ(-42,DataProcessor::findDriftTimeBin(min_at_400->getData().data(),400,6));
+}
+
+TEST_F(DataProcessorTest,TestEstimateBaseline)
+{
+	float baseline, noise;
+	DataProcessor::estimateBaseline(const1->getData().data(),100,baseline,noise);
+	ASSERT_FLOAT_EQ(1,baseline);
+	ASSERT_FLOAT_EQ(0,noise);
+
+	//alternating 90 and 110: mean 100, rms 10
+	vector<uint16_t> samples(64);
+	for(size_t i = 0; i < samples.size(); ++i)
+	{
+		samples[i] = i % 2 ? 110 : 90;
+	}
+	DataProcessor::estimateBaseline(samples.data(),samples.size(),baseline,noise);
+	ASSERT_FLOAT_EQ(100,baseline);
+	ASSERT_FLOAT_EQ(10,noise);
+
+	//without baseline bins, the offset is the baseline
+	AnalysisConfig config;
+	DataProcessor::estimateBaseline(samples.data(),samples.size(),config,baseline,noise);
+	ASSERT_FLOAT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE,baseline);
+	ASSERT_FLOAT_EQ(0,noise);
+	config.set("baselinebins","1000");
+	DataProcessor::estimateBaseline(samples.data(),samples.size(),config,baseline,noise);
+	ASSERT_FLOAT_EQ(100,baseline);
+}
+
+TEST_F(DataProcessorTest,TestRefineDriftTime)
+{
+	//linear falling edge of 40 channels per bin from bin 100 on, flat minimum 1600 at bins [109,115)
+	vector<uint16_t> samples(200,2000);
+	for(size_t i = 100; i < 115; ++i)
+	{
+		samples[i] = i < 109 ? 2000 - 40 * (i - 99) : 1600;
+	}
+	const short bin = DataProcessor::findDriftTimeBin(samples.data(),samples.size(),1850);
+	ASSERT_EQ(103,bin);
+
+	AnalysisConfig config;
+	ASSERT_FLOAT_EQ(103,DataProcessor::refineDriftTimeBin(samples.data(),samples.size(),bin,1850,2000,config));
+	ASSERT_FLOAT_EQ(-42,DataProcessor::refineDriftTimeBin(samples.data(),samples.size(),-42,1850,2000,config));
+	config.set("timing","interpolated");
+	ASSERT_FLOAT_EQ(102.75,DataProcessor::refineDriftTimeBin(samples.data(),samples.size(),bin,1850,2000,config));
+
+	//half of the amplitude is crossed at 104, independent of the amplitude
+	config.set("timing","cfd");
+	config.set("cfdfraction","0.5");
+	ASSERT_FLOAT_EQ(104,DataProcessor::refineDriftTimeBin(samples.data(),samples.size(),bin,1850,2000,config));
+	for(size_t i = 100; i < 115; ++i)
+	{
+		samples[i] = i < 109 ? 2000 - 80 * (i - 99) : 1200;
+	}
+	ASSERT_EQ(101,DataProcessor::findDriftTimeBin(samples.data(),samples.size(),1850));
+	ASSERT_FLOAT_EQ(104,DataProcessor::refineDriftTimeBin(samples.data(),samples.size(),101,1850,2000,config));
+
+	//positive polarity
+	for(size_t i = 0; i < samples.size(); ++i)
+	{
+		samples[i] = 4000 - samples[i];
+	}
+	config.set("polarity","positive");
+	ASSERT_FLOAT_EQ(104,DataProcessor::refineDriftTimeBin(samples.data(),samples.size(),101,2150,2000,config));
 }
 
 TEST_F(DataProcessorTest,TestFindLastFilledBin)
@@ -154,6 +223,60 @@ TEST_F(DataProcessorTest,TestCalculateDriftTimeSpectrum)
 	//Create a DataSet
 	ASSERT_EQ(1,spect.getEntries());
 	ASSERT_EQ(1,spect[50]);
+
+	//sub-bin drift times
+	evts.push_back(unique_ptr<Event>(new Event(0,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(800)),50.25,ABSOLUTE_OFFSET_ZERO_VOLTAGE,0)));
+	evts.push_back(unique_ptr<Event>(new Event(1,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(800)),50.75,ABSOLUTE_OFFSET_ZERO_VOLTAGE,0)));
+	DataSet sub_set(evts);
+	DriftTimeSpectrum coarse = DataProcessor::calculateDriftTimeSpectrum(sub_set,1);
+	ASSERT_EQ(2,coarse[50]);
+	DriftTimeSpectrum fine = DataProcessor::calculateDriftTimeSpectrum(sub_set,4);
+	ASSERT_EQ(3200,fine.getSize());
+	ASSERT_EQ(0,fine[200]);
+	ASSERT_EQ(1,fine[201]);
+	ASSERT_EQ(1,fine[203]);
+}
+
+TEST_F(DataProcessorTest,TestReconstructTracks)
+{
+	//four tubes on both sides of the vertical track x = 10 mm, every drift radius is 10 mm
+	const int positions[4][2] = {{0,0},{20,40},{0,80},{20,120}};
+	vector<unique_ptr<Drifttube>> tubes;
+	for(unsigned int tube = 0; tube < 4; ++tube)
+	{
+		vector<unique_ptr<Event>> events;
+		for(unsigned int i = 0; i < 10; ++i)
+		{
+			unique_ptr<vector<uint16_t>> data(new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+			//last trigger has only two hits
+			if(i < 9 || tube < 2)
+			{
+				(*data)[100] = ABSOLUTE_OFFSET_ZERO_VOLTAGE + 2 * ABSOLUTE_EVENT_THRESHOLD_VOLTAGE;
+			}
+			events.push_back(unique_ptr<Event>(new Event(i,move(data))));
+		}
+		tubes.push_back(unique_ptr<Drifttube>(new Drifttube(positions[tube][0],positions[tube][1],unique_ptr<DataSet>(new DataSet(events)))));
+	}
+	TriggerEventCollection hits(tubes);
+
+	unique_ptr<vector<double>> rt(new vector<double>(800));
+	for(unsigned int i = 0; i < 800; ++i)
+	{
+		(*rt)[i] = 0.1 * i;
+	}
+	RtRelation rtRelation(move(rt));
+	vector<const RtRelation*> rtRelations(4,&rtRelation);
+
+	vector<Track> tracks = DataProcessor::reconstructTracks(hits,rtRelations);
+	ASSERT_EQ(10,tracks.size());
+	for(unsigned int i = 0; i < 9; ++i)
+	{
+		ASSERT_TRUE(tracks[i].isValid());
+		ASSERT_EQ(4,tracks[i].getNumberOfHits());
+		ASSERT_NEAR(0.0,tracks[i].getTheta(),1e-6);
+		ASSERT_NEAR(10.0,tracks[i].getDistance(),1e-6);
+	}
+	ASSERT_FALSE(tracks[9].isValid());
 }
 
 int main(int argc, char **argv)
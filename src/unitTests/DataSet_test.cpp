@@ -67,7 +67,7 @@ TEST_F(DataSetTest,TestCopyConstruction)
 TEST_F(DataSetTest,TestAddData)
 {
 	//build test arrays that are filled with 42 or 1337 respectively
-	vector<uint16_t> test1(800,42), test2(800,1337);
+	EventSamples test1(800,42), test2(800,1337);
 
 	//create a unique pointer to an Event containing an array filled with 42 and push it to d1
 	unique_ptr<vector<uint16_t>> arr(new vector<uint16_t>(800,42));
@@ -146,6 +146,29 @@ TEST_F(DataSetTest,Test_mean_noise_amplitude)
 	delete d;
 }
 
+TEST_F(DataSetTest,TestIncrementalStatistics)
+{
+	//events filled with 1 and 2 added one by one must result in the same statistics as a constructed DataSet
+	for(int i = 0; i < 2; i++)
+	{
+		unique_ptr<vector<uint16_t>> arr(new vector<uint16_t>(800,i+1));
+		d1->addData(unique_ptr<Event>(new Event(i,move(arr))));
+	}
+	ASSERT_DOUBLE_EQ(1.5,d1->get_mean_offset_voltage());
+	ASSERT_DOUBLE_EQ(0.5,d1->get_mean_noise_amplitude());
+
+	//an event with a drift time in bin 50 and a rejected one
+	unique_ptr<vector<uint16_t>> arr(new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+	(*arr)[50] = ABSOLUTE_OFFSET_ZERO_VOLTAGE + 2 * ABSOLUTE_EVENT_THRESHOLD_VOLTAGE;
+	DataSet d;
+	d.addData(unique_ptr<Event>(new Event(0,move(arr))));
+	d.addData(unique_ptr<Event>());
+	ASSERT_EQ(2,d.getSize());
+	ASSERT_EQ(1,d.getRejected());
+	ASSERT_EQ(800,d.getDriftTimeHistogram().size());
+	ASSERT_EQ(1,d.getDriftTimeHistogram()[50 - ADC_TRIGGERPOS_BIN]);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -84,8 +84,8 @@ TEST_F(DrifttubeTest,TestPosArray)
 	ASSERT_EQ(4,d2->getPosition()[1]);
 
 	//create new test-arrays to check the == operator for the array from the getter method
-	array<int,2> test1 = {1,2};
-	array<int,2> test2 = {3,4};
+	array<double,2> test1 = {1,2};
+	array<double,2> test2 = {3,4};
 	ASSERT_TRUE(test1 == d1->getPosition());
 	ASSERT_TRUE(test2 == d2->getPosition());
 
@@ -157,6 +157,67 @@ TEST_F(DrifttubeTest,TestMaxDrifttime)
 	ASSERT_EQ((50 - ADC_TRIGGERPOS_BIN + 1) * 4,d3_filled->getMaxDrifttime());
 }
 
+TEST_F(DrifttubeTest,TestInvalidate)
+{
+	//results of a copy are computed lazily as well and must equal the ones of the original
+	Drifttube copyOfD3(*d3_filled);
+	ASSERT_EQ(1,copyOfD3.getEfficiency());
+
+	vector<uint32_t> before = d3_filled->getDriftTimeSpectrum().getData();
+	double maxDrifttime = d3_filled->getMaxDrifttime();
+	d3_filled->invalidate();
+	ASSERT_EQ(before,d3_filled->getDriftTimeSpectrum().getData());
+	ASSERT_EQ(maxDrifttime,d3_filled->getMaxDrifttime());
+	ASSERT_EQ(copyOfD3.getRtRelation().getData(),d3_filled->getRtRelation().getData());
+}
+
+TEST_F(DrifttubeTest,TestAddEvent)
+{
+	ASSERT_EQ(1,d3_filled->getDriftTimeSpectrum().getEntries());
+
+	unique_ptr<vector<uint16_t>> arr(new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+	(*arr)[100] = ABSOLUTE_OFFSET_ZERO_VOLTAGE + (2 * ABSOLUTE_EVENT_THRESHOLD_VOLTAGE);
+	d3_filled->addEvent(unique_ptr<Event>(new Event(2,move(arr))));
+	d3_filled->addEvent(unique_ptr<Event>());
+
+	ASSERT_EQ(3,d3_filled->getDriftTimeSpectrum().getEntries());
+	ASSERT_EQ(1,d3_filled->getDriftTimeSpectrum().getRejected());
+	ASSERT_EQ(1,d3_filled->getDriftTimeSpectrum()[100]);
+	ASSERT_DOUBLE_EQ(2/3.0,d3_filled->getEfficiency());
+	ASSERT_DOUBLE_EQ(DRIFT_TUBE_RADIUS / 2,d3_filled->getRtRelation()[51]);
+	ASSERT_EQ((100 - ADC_TRIGGERPOS_BIN + 1) * 4,d3_filled->getMaxDrifttime());
+}
+
+TEST_F(DrifttubeTest,TestSharedDataSet)
+{
+	//copies share the DataSet, no Event is copied
+	Drifttube copyOfD3(*d3_filled);
+	ASSERT_EQ(&d3_filled->getDataSet(),&copyOfD3.getDataSet());
+	Drifttube assigned = *d1;
+	assigned = *d3_filled;
+	ASSERT_EQ(&d3_filled->getDataSet(),&assigned.getDataSet());
+
+	//adding an event to the copy does not change the original
+	unique_ptr<vector<uint16_t>> arr(new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+	(*arr)[100] = ABSOLUTE_OFFSET_ZERO_VOLTAGE + (2 * ABSOLUTE_EVENT_THRESHOLD_VOLTAGE);
+	copyOfD3.addEvent(unique_ptr<Event>(new Event(2,move(arr))));
+	ASSERT_FALSE(&d3_filled->getDataSet() == &copyOfD3.getDataSet());
+	ASSERT_EQ(1,d3_filled->getDataSet().getSize());
+	ASSERT_EQ(2,copyOfD3.getDataSet().getSize());
+	ASSERT_EQ(1,d3_filled->getDriftTimeSpectrum().getEntries());
+	ASSERT_EQ(2,copyOfD3.getDriftTimeSpectrum().getEntries());
+}
+
+TEST_F(DrifttubeTest,TestMoveConstruction)
+{
+	const DataSet* data = &d3_filled->getDataSet();
+	vector<uint32_t> spect = d3_filled->getDriftTimeSpectrum().getData();
+	Drifttube moved(move(*d3_filled));
+	ASSERT_EQ(data,&moved.getDataSet());
+	ASSERT_EQ(spect,moved.getDriftTimeSpectrum().getData());
+	ASSERT_EQ(5,moved.getPositionX());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
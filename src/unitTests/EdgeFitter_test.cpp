@@ -0,0 +1,109 @@
+/*
+ * EdgeFitter_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../EdgeFitter.h"
+#include "../DriftTimeSpectrum.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+
+class EdgeFitterTest : public ::testing::Test
+{
+public:
+	EdgeFitterTest()
+	{
+		//bins of 4 ns, t0 = 100 ns and tmax = 700 ns with a width of 8 ns, height 1000 on a background of 5
+		fermi = new vector<double>(250);
+		for(size_t i = 0; i < fermi->size(); ++i)
+		{
+			const double t = 4.0 * i;
+			(*fermi)[i] = 5 + 1000 / (1 + exp(-(t - 100) / 8)) / (1 + exp((t - 700) / 8));
+		}
+		//trapezoid rising from 80 ns to 120 ns and falling from 680 ns to 720 ns
+		trapezoid = new vector<double>(250);
+		for(size_t i = 0; i < trapezoid->size(); ++i)
+		{
+			const double t = 4.0 * i;
+			const double rise = t < 80 ? 0 : (t > 120 ? 1 : (t - 80) / 40);
+			const double fall = t < 680 ? 1 : (t > 720 ? 0 : (720 - t) / 40);
+			(*trapezoid)[i] = 1000 * rise * fall;
+		}
+	}
+
+	~EdgeFitterTest()
+	{
+		delete fermi;
+		delete trapezoid;
+	}
+
+protected:
+	vector<double>* fermi;
+	vector<double>* trapezoid;
+};
+
+TEST_F(EdgeFitterTest,TestFermi)
+{
+	EdgeFitter fitter;
+	ASSERT_EQ(EdgeFitter::FERMI,fitter.getModel());
+	DriftTimeEdges edges = fitter.fit(*fermi,4);
+	ASSERT_TRUE(edges.leading.valid);
+	ASSERT_TRUE(edges.trailing.valid);
+	ASSERT_NEAR(100,edges.leading.time,0.5);
+	ASSERT_NEAR(700,edges.trailing.time,0.5);
+	ASSERT_NEAR(8,edges.leading.width,0.5);
+	ASSERT_NEAR(8,edges.trailing.width,0.5);
+	ASSERT_GT(edges.leading.error,0);
+	ASSERT_LT(edges.leading.error,2);
+	ASSERT_GT(edges.trailing.error,0);
+	ASSERT_LT(edges.trailing.chi2,1);
+}
+
+TEST_F(EdgeFitterTest,TestLinear)
+{
+	EdgeFitter fitter(EdgeFitter::LINEAR);
+	DriftTimeEdges edges = fitter.fit(*trapezoid,4);
+	ASSERT_TRUE(edges.leading.valid);
+	ASSERT_TRUE(edges.trailing.valid);
+	ASSERT_NEAR(80,edges.leading.time,0.5);
+	ASSERT_NEAR(720,edges.trailing.time,0.5);
+	ASSERT_NEAR(40,edges.leading.width,0.5);
+	ASSERT_GT(edges.trailing.error,0);
+}
+
+TEST_F(EdgeFitterTest,TestSpectrum)
+{
+	unique_ptr<vector<uint32_t>> contents(new vector<uint32_t>(fermi->size()));
+	for(size_t i = 0; i < fermi->size(); ++i)
+	{
+		(*contents)[i] = lround((*fermi)[i]);
+	}
+	DriftTimeSpectrum spectrum(move(contents),0,0);
+	DriftTimeEdges edges = EdgeFitter().fit(spectrum,4);
+	ASSERT_TRUE(edges.leading.valid);
+	ASSERT_NEAR(100,edges.leading.time,0.5);
+	ASSERT_NEAR(700,edges.trailing.time,0.5);
+}
+
+TEST_F(EdgeFitterTest,TestEmpty)
+{
+	vector<double> empty(250,0);
+	DriftTimeEdges edges = EdgeFitter().fit(empty,4);
+	ASSERT_FALSE(edges.leading.valid);
+	ASSERT_FALSE(edges.trailing.valid);
+	edges = EdgeFitter(EdgeFitter::LINEAR).fit(vector<double>(),4);
+	ASSERT_FALSE(edges.leading.valid);
+	ASSERT_THROW(EdgeFitter(2),invalid_argument);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc,argv);
+	return RUN_ALL_TESTS();
+}
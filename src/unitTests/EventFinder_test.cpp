@@ -0,0 +1,208 @@
+/*
+ * EventFinder_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../EventFinder.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace std;
+
+class EventFinderTest : public ::testing::Test
+{
+public:
+	EventFinderTest()
+	{
+		//event i has a pulse at bin 20 + i % 50 of depth 100 * (i % 7 + 4), every 4th event a second pulse, every 10th none
+		vector<unique_ptr<Event>> events;
+		for(unsigned int i = 0; i < 10000; ++i)
+		{
+			unique_ptr<vector<uint16_t>> data(new vector<uint16_t>(200,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+			if(i % 10 != 9)
+			{
+				for(unsigned int bin = 20 + i % 50; bin < 25 + i % 50 + i % 3; ++bin)
+				{
+					(*data)[bin] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 100 * (i % 7 + 4);
+				}
+				if(i % 4 == 0)
+				{
+					for(unsigned int bin = 150; bin < 155; ++bin)
+					{
+						(*data)[bin] = 1500;
+					}
+				}
+			}
+			events.push_back(unique_ptr<Event>(new Event(i,move(data))));
+		}
+		data = new DataSet(events);
+		finder = new EventFinder(*data);
+	}
+
+	~EventFinderTest()
+	{
+		delete finder;
+		delete data;
+	}
+
+protected:
+	DataSet* data;
+	EventFinder* finder;
+};
+
+TEST_F(EventFinderTest,TestFeatures)
+{
+	ASSERT_EQ(10000,finder->getSize());
+	ASSERT_FLOAT_EQ(4 * 21,finder->getFeature("drifttime")[1]);
+	ASSERT_FLOAT_EQ(-1,finder->getFeature("drifttime")[9]);
+	ASSERT_FLOAT_EQ(-500,finder->getFeature("amplitude")[1]);
+	ASSERT_FLOAT_EQ(1500 - ABSOLUTE_OFFSET_ZERO_VOLTAGE,finder->getFeature("amplitude")[8]);
+	ASSERT_FLOAT_EQ(2,finder->getFeature("npulses")[4]);
+	ASSERT_FLOAT_EQ(1,finder->getFeature("npulses")[5]);
+	ASSERT_FLOAT_EQ(0,finder->getFeature("npulses")[9]);
+	ASSERT_FLOAT_EQ(4 * 7,finder->getFeature("tot")[2]);
+	ASSERT_THROW(finder->getFeature("charge"),invalid_argument);
+
+	//event 1: pulse of depth 500 at bins [21,27), event 8: pulses at [28,35) and [150,155)
+	ASSERT_FLOAT_EQ(4 * 26,finder->getFeature("signalend")[1]);
+	ASSERT_FLOAT_EQ(4 * 154,finder->getFeature("signalend")[8]);
+	ASSERT_FLOAT_EQ(-1,finder->getFeature("signalend")[9]);
+	ASSERT_FLOAT_EQ(4 * 21,finder->getFeature("minimumpos")[1]);
+	ASSERT_FLOAT_EQ(4 * 150,finder->getFeature("minimumpos")[8]);
+	ASSERT_FLOAT_EQ(-500 * 6,finder->getFeature("integralmin")[1]);
+	ASSERT_FLOAT_EQ(4 * 26,finder->getFeature("integralminpos")[1]);
+	ASSERT_FLOAT_EQ(0,finder->getFeature("saturated")[1]);
+
+	//a pulse still open at the end of the event ends with its last bin, after an earlier closed pulse
+	vector<unique_ptr<Event>> events;
+	unique_ptr<vector<uint16_t>> samples(new vector<uint16_t>(100,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+	for(unsigned int bin = 10; bin < 15; ++bin)
+	{
+		(*samples)[bin] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 500;
+	}
+	for(unsigned int bin = 90; bin < 100; ++bin)
+	{
+		(*samples)[bin] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 500;
+	}
+	events.push_back(unique_ptr<Event>(new Event(0,move(samples))));
+	DataSet open(events);
+	EventFinder openFinder(open);
+	ASSERT_FLOAT_EQ(2,openFinder.getFeature("npulses")[0]);
+	ASSERT_FLOAT_EQ(4 * 99,openFinder.getFeature("signalend")[0]);
+}
+
+TEST_F(EventFinderTest,TestSummarize)
+{
+	FeatureSummary all = finder->summarize("drifttime");
+	ASSERT_EQ(10000,all.entries);
+	ASSERT_FLOAT_EQ(-1,all.minimum);
+	FeatureSummary signal = finder->summarize("drifttime","drifttime >= 0");
+	ASSERT_EQ(9000,signal.entries);
+	ASSERT_FLOAT_EQ(4 * 20,signal.minimum);
+	ASSERT_FLOAT_EQ(4 * 68,signal.maximum);
+	FeatureSummary empty = finder->summarize("amplitude","npulses == 0");
+	ASSERT_EQ(1000,empty.entries);
+	ASSERT_FLOAT_EQ(0,empty.mean);
+	ASSERT_FLOAT_EQ(0,empty.rms);
+	ASSERT_FLOAT_EQ(0,finder->summarize("saturated").mean);
+
+	//half of the events saturate the FADC
+	vector<unique_ptr<Event>> events;
+	for(unsigned int i = 0; i < 4; ++i)
+	{
+		unique_ptr<vector<uint16_t>> samples(new vector<uint16_t>(100,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+		(*samples)[50] = i % 2 ? 0 : 1000;
+		events.push_back(unique_ptr<Event>(new Event(i,move(samples))));
+	}
+	DataSet saturating(events);
+	EventFinder saturatingFinder(saturating);
+	ASSERT_FLOAT_EQ(0.5,saturatingFinder.summarize("saturated").mean);
+
+	//positive signals saturate at the upper end of the FADC range
+	AnalysisConfig config;
+	config.set("polarity","positive");
+	config.set("threshold","300");
+	AnalysisConfig::Scope scope(config);
+	vector<unique_ptr<Event>> positive;
+	for(unsigned int i = 0; i < 4; ++i)
+	{
+		vector<uint16_t> samples(100,ABSOLUTE_OFFSET_ZERO_VOLTAGE);
+		samples[50] = i % 2 ? ADC_MAX_CHANNEL : 3000;
+		positive.push_back(unique_ptr<Event>(new Event(i,samples.data(),samples.size(),50,ABSOLUTE_OFFSET_ZERO_VOLTAGE,0)));
+	}
+	DataSet positiveData(positive);
+	EventFinder positiveFinder(positiveData);
+	ASSERT_FLOAT_EQ(0.5,positiveFinder.summarize("saturated").mean);
+	ASSERT_FLOAT_EQ(1,positiveFinder.summarize("npulses").mean);
+	ASSERT_FLOAT_EQ(3000 - ABSOLUTE_OFFSET_ZERO_VOLTAGE,positiveFinder.getFeature("amplitude")[0]);
+	ASSERT_FLOAT_EQ(4 * 50,positiveFinder.getFeature("minimumpos")[0]);
+	ASSERT_FLOAT_EQ(3000 - ABSOLUTE_OFFSET_ZERO_VOLTAGE,positiveFinder.getFeature("integralmin")[0]);
+	ASSERT_FLOAT_EQ(4 * 50,positiveFinder.getFeature("integralminpos")[0]);
+	ASSERT_EQ(2,positiveFinder.listEventNumbers("amplitude > 1000").size());
+	ASSERT_THROW(finder->summarize("charge"),invalid_argument);
+}
+
+TEST_F(EventFinderTest,TestSelection)
+{
+	const vector<float>& driftTime = finder->getFeature("drifttime");
+	const vector<float>& amplitude = finder->getFeature("amplitude");
+	const vector<float>& nPulses = finder->getFeature("npulses");
+	const vector<float>& tot = finder->getFeature("tot");
+
+	vector<unsigned int> expected;
+	for(unsigned int i = 0; i < finder->getSize(); ++i)
+	{
+		if(driftTime[i] > 200 && amplitude[i] < -500 && nPulses[i] >= 2)
+		{
+			expected.push_back(i);
+		}
+	}
+	ASSERT_FALSE(expected.empty());
+	ASSERT_EQ(expected,finder->listEventNumbers("drifttime > 200 && amplitude < -500 && npulses >= 2"));
+
+	expected.clear();
+	for(unsigned int i = 0; i < finder->getSize(); ++i)
+	{
+		if(!(tot[i] == 20 || driftTime[i] < 0) && (amplitude[i] <= -700 || nPulses[i] != 1))
+		{
+			expected.push_back(i);
+		}
+	}
+	ASSERT_FALSE(expected.empty());
+	ASSERT_EQ(expected,finder->listEventNumbers("!(tot==20||drifttime<0) && (amplitude<=-700 || npulses!=1)"));
+
+	vector<uint64_t> bitmap = finder->select(finder->compile("npulses == 0"));
+	ASSERT_EQ((10000 + 63) / 64,bitmap.size());
+	ASSERT_EQ(1000,EventFinder::toEventNumbers(bitmap).size());
+	ASSERT_EQ(0,finder->listEventNumbers("drifttime > 1000").size());
+}
+
+TEST_F(EventFinderTest,TestGetEvents)
+{
+	vector<const Event*> events = finder->getEvents("npulses >= 2");
+	ASSERT_EQ(2500,events.size());
+	ASSERT_EQ(&data->getEvent(4),events[1]);
+	ASSERT_EQ(4,events[1]->getEventNumber());
+}
+
+TEST_F(EventFinderTest,TestErrors)
+{
+	ASSERT_THROW(finder->compile(""),invalid_argument);
+	ASSERT_THROW(finder->compile("charge > 3"),invalid_argument);
+	ASSERT_THROW(finder->compile("drifttime >"),invalid_argument);
+	ASSERT_THROW(finder->compile("drifttime > 3 &&"),invalid_argument);
+	ASSERT_THROW(finder->compile("(drifttime > 3"),invalid_argument);
+	ASSERT_THROW(finder->compile("drifttime > 3)"),invalid_argument);
+	ASSERT_THROW(finder->compile("drifttime = 3"),invalid_argument);
+	ASSERT_THROW(finder->compile("drifttime > amplitude"),invalid_argument);
+	ASSERT_THROW(finder->compile("drifttime > 3 \xc3\xa4"),invalid_argument);
+	ASSERT_EQ(4,finder->compile("drifttime > 3 && !(amplitude < -1e2)").size());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,165 @@
+/*
+ * EventIndex_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../EventIndex.h"
+#include "../EventFinder.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <cstdio>
+
+using namespace std;
+
+class EventIndexTest : public ::testing::Test
+{
+public:
+	EventIndexTest()
+	{
+		//random pulses, every 5th event without signal and every 3rd with an afterpulse
+		mt19937 generator(11);
+		uniform_int_distribution<unsigned int> start(10,120);
+		uniform_int_distribution<unsigned int> length(1,12);
+		uniform_int_distribution<unsigned int> depth(400,1500);
+		vector<unique_ptr<Event>> events;
+		for(unsigned int i = 0; i < 20000; ++i)
+		{
+			unique_ptr<vector<uint16_t>> data(new vector<uint16_t>(200,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+			if(i % 5 != 4)
+			{
+				unsigned int first = start(generator);
+				unsigned int last = first + length(generator);
+				uint16_t value = ABSOLUTE_OFFSET_ZERO_VOLTAGE - depth(generator);
+				for(unsigned int bin = first; bin < last; ++bin)
+				{
+					(*data)[bin] = value;
+				}
+				if(i % 3 == 0)
+				{
+					(*data)[160] = value;
+				}
+			}
+			events.push_back(unique_ptr<Event>(new Event(i,move(data))));
+		}
+		data = new DataSet(events);
+		finder = new EventFinder(*data);
+		index = make_shared<EventIndex>(*finder,16);
+	}
+
+	~EventIndexTest()
+	{
+		delete finder;
+		delete data;
+	}
+
+	//reference result of a comparison by scanning the column
+	vector<uint64_t> scan(const unsigned int feature, const uint8_t opcode, const float value)
+	{
+		const vector<float>& column = finder->getFeatures()[feature];
+		vector<uint64_t> bitmap((column.size() + 63) / 64,0);
+		for(size_t i = 0; i < column.size(); ++i)
+		{
+			bool match = opcode == EventFinder::LESS ? column[i] < value : opcode == EventFinder::LESS_EQUAL ? column[i] <= value
+					: opcode == EventFinder::GREATER ? column[i] > value : opcode == EventFinder::GREATER_EQUAL ? column[i] >= value
+					: opcode == EventFinder::EQUAL ? column[i] == value : column[i] != value;
+			bitmap[i / 64] |= (uint64_t)match << (i % 64);
+		}
+		return bitmap;
+	}
+
+protected:
+	DataSet* data;
+	EventFinder* finder;
+	shared_ptr<EventIndex> index;
+};
+
+TEST_F(EventIndexTest,TestSelect)
+{
+	ASSERT_EQ(20000,index->getSize());
+	ASSERT_EQ(9,index->getNumberOfFeatures());
+	ASSERT_EQ(16,index->getNumberOfBins());
+
+	//values below, inside and above the ranges of drifttime, amplitude, npulses and tot
+	const float values[4][5] = {{-1, 0, 100, 260.5, 1000}, {-1600, -900, -700, -400, 0}, {0, 1, 1.5, 2, 3}, {0, 4, 20, 24, 48}};
+	//the bins of the coarse index are stored in dense containers
+	EventIndex coarse(*finder,2);
+	for(const EventIndex* tested : {index.get(), &coarse})
+	{
+		for(unsigned int feature = 0; feature < 4; ++feature)
+		{
+			for(float value : values[feature])
+			{
+				for(uint8_t opcode = EventFinder::LESS; opcode <= EventFinder::NOT_EQUAL; ++opcode)
+				{
+					vector<uint64_t> expected = scan(feature,opcode,value);
+					ASSERT_EQ(expected,tested->select(feature,opcode,value)) << feature << " " << (int)opcode << " " << value;
+					ASSERT_EQ(EventFinder::toEventNumbers(expected).size(),tested->count(feature,opcode,value));
+				}
+			}
+		}
+	}
+}
+
+TEST_F(EventIndexTest,TestEventFinder)
+{
+	//selective expressions are answered by the index, the others by a scan
+	const string expressions[] = {"drifttime >= 100 && drifttime < 108 && npulses >= 2", "amplitude <= -1490 && tot != 4",
+			"tot == 48 || (drifttime == 80 && !(amplitude > -500))", "drifttime >= 100 && drifttime < 200",
+			"npulses >= 2 && !(amplitude < -1000)", "!(drifttime > 40) && (npulses != 1 || tot <= 12)", "drifttime > 1000"};
+	for(const string& expression : expressions)
+	{
+		vector<unsigned int> expected = finder->listEventNumbers(expression);
+		ASSERT_TRUE(finder->setIndex(index));
+		ASSERT_EQ(index.get(),finder->getIndex());
+		ASSERT_EQ(expected,finder->listEventNumbers(expression)) << expression;
+		finder->setIndex(nullptr);
+	}
+}
+
+TEST_F(EventIndexTest,TestPersistence)
+{
+	ASSERT_EQ("run.drift.tube3.index",EventIndex::filename("run.drift",3));
+	string filename = EventIndex::filename("/tmp/EventIndexTest.drift",0);
+	index->save(filename);
+	shared_ptr<EventIndex> loaded = make_shared<EventIndex>(EventIndex::load(filename));
+	remove(filename.c_str());
+	ASSERT_EQ(index->getSize(),loaded->getSize());
+	ASSERT_EQ(index->select(0,EventFinder::GREATER,123),loaded->select(0,EventFinder::GREATER,123));
+	ASSERT_EQ(index->select(1,EventFinder::LESS,-800),loaded->select(1,EventFinder::LESS,-800));
+	ASSERT_EQ(finder->getFingerprint(),loaded->getFingerprint());
+	ASSERT_THROW(EventIndex::load("/tmp/EventIndexTest.missing"),DataPresenceException);
+}
+
+TEST_F(EventIndexTest,TestIndexFile)
+{
+	//the first EventFinder builds and saves the index, the second one loads it
+	string filename = EventIndex::filename("/tmp/EventIndexTest.drift",1);
+	remove(filename.c_str());
+	EventFinder first(*data,filename);
+	ASSERT_NE(nullptr,first.getIndex());
+	EventIndex saved = EventIndex::load(filename);
+	ASSERT_EQ(first.getFingerprint(),saved.getFingerprint());
+	EventFinder second(*data,filename);
+	ASSERT_NE(nullptr,second.getIndex());
+	ASSERT_EQ(finder->listEventNumbers("drifttime >= 100 && drifttime < 108"),second.listEventNumbers("drifttime >= 100 && drifttime < 108"));
+
+	//features of another threshold do not match the index
+	AnalysisConfig config;
+	config.set("threshold","-1000");
+	AnalysisConfig::Scope scope(config);
+	EventFinder other(*data);
+	ASSERT_NE(finder->getFingerprint(),other.getFingerprint());
+	ASSERT_FALSE(other.setIndex(index));
+	ASSERT_EQ(nullptr,other.getIndex());
+	EventFinder rebuilt(*data,filename);
+	ASSERT_EQ(rebuilt.getFingerprint(),EventIndex::load(filename).getFingerprint());
+	remove(filename.c_str());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
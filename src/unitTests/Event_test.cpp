@@ -114,7 +114,7 @@ TEST_F(EventTest, TestCopyConstructor)
 TEST_F(EventTest, TestPolymorphism)
 {
 	Event* e = new Event(*e1);
-	Data<uint16_t>* data = e;
+	Data<uint16_t,ArenaAllocator<uint16_t>>* data = e;
 	ASSERT_TRUE(data != nullptr);
 	delete data;
 }
@@ -151,6 +151,65 @@ TEST_F(EventTest, TestDriftTime)
 
 	ASSERT_EQ(200,e.getDriftTime());
 	ASSERT_EQ(-168,e2.getDriftTime());
+
+	//known drift time bin
+	Event e3(3,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE)),50);
+	ASSERT_EQ(200,e3.getDriftTime());
+}
+
+TEST_F(EventTest, TestBaseline)
+{
+	//baseline drifted by +400 channels with noise of +-20, pulse of depth 250 relative to the baseline at bin 100
+	unique_ptr<vector<uint16_t>> arr(new vector<uint16_t>(800));
+	for(size_t i = 0; i < arr->size(); ++i)
+	{
+		(*arr)[i] = ABSOLUTE_OFFSET_ZERO_VOLTAGE + 400 + (i % 2 ? 20 : -20);
+	}
+	for(size_t i = 100; i < 110; ++i)
+	{
+		(*arr)[i] = ABSOLUTE_OFFSET_ZERO_VOLTAGE + 150;
+	}
+	Event fixed(1,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(*arr)));
+	ASSERT_EQ(-168,fixed.getDriftTime());
+	ASSERT_FLOAT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE,fixed.getBaseline());
+
+	AnalysisConfig config;
+	config.set("baselinebins","50");
+	config.set("threshold","-100");
+	AnalysisConfig::Scope scope(config);
+	Event relative(2,move(arr));
+	ASSERT_FLOAT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE + 400,relative.getBaseline());
+	ASSERT_FLOAT_EQ(20,relative.getNoise());
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE + 400 - 100,relative.getThreshold());
+	ASSERT_EQ(400,relative.getDriftTime());
+
+	//8 times the noise is further from the baseline than the threshold
+	config.set("relativethreshold","-8");
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE + 400 - 160,relative.getThreshold());
+
+	Event copy(relative);
+	ASSERT_FLOAT_EQ(relative.getBaseline(),copy.getBaseline());
+	ASSERT_FLOAT_EQ(relative.getNoise(),copy.getNoise());
+
+	//positive signals on a noisy baseline, 8 times the noise lies above the baseline
+	AnalysisConfig positive;
+	positive.set("polarity","positive");
+	positive.set("threshold","100");
+	positive.set("baselinebins","50");
+	positive.set("relativethreshold","-8");
+	AnalysisConfig::Scope positiveScope(positive);
+	unique_ptr<vector<uint16_t>> samples(new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE - 400));
+	for(size_t i = 0; i < 50; ++i)
+	{
+		(*samples)[i] += i % 2 ? 20 : -20;
+	}
+	for(size_t i = 100; i < 110; ++i)
+	{
+		(*samples)[i] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 400 + 250;
+	}
+	Event rising(3,move(samples));
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE - 400 + 160,rising.getThreshold());
+	ASSERT_EQ(400,rising.getDriftTime());
 }
 
 TEST_F(EventTest, TestNormalized)
@@ -0,0 +1,85 @@
+/*
+ * LegendreTrackFinder_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../LegendreTrackFinder.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace std;
+
+class LegendreTrackFinderTest : public ::testing::Test
+{
+public:
+	LegendreTrackFinderTest()
+	{
+		//staggered chamber of 8 layers with 8 tubes each, the track has the normal angle 0.2 rad and distance 150 mm
+		const double c = cos(0.2), s = sin(0.2);
+		for(unsigned int layer = 0; layer < 8; ++layer)
+		{
+			for(unsigned int tube = 0; tube < 8; ++tube)
+			{
+				DriftCircle circle;
+				circle.x = 42.0 * tube + 21.0 * (layer % 2);
+				circle.y = 36.4 * layer;
+				double distance = fabs(circle.x * c + circle.y * s - 150.0);
+				if(distance < DRIFT_TUBE_RADIUS)
+				{
+					circle.radius = distance;
+					circles.push_back(circle);
+				}
+				else if((layer + tube) % 5 == 0)
+				{
+					//noise hit
+					circle.radius = 9.0;
+					noise.push_back(circle);
+				}
+			}
+		}
+		finder = new LegendreTrackFinder();
+	}
+
+	~LegendreTrackFinderTest()
+	{
+		delete finder;
+	}
+
+protected:
+	vector<DriftCircle> circles;
+	vector<DriftCircle> noise;
+	LegendreTrackFinder* finder;
+};
+
+TEST_F(LegendreTrackFinderTest,TestFindCandidate)
+{
+	Track candidate = finder->findCandidate(circles.data(),circles.size());
+	ASSERT_TRUE(candidate.isValid());
+	ASSERT_NEAR(0.2,candidate.getTheta(),0.01);
+	ASSERT_NEAR(150.0,candidate.getDistance(),1.0);
+
+	ASSERT_FALSE(finder->findCandidate(circles.data(),2).isValid());
+	ASSERT_FALSE(finder->findCandidate(circles.data(),0).isValid());
+}
+
+TEST_F(LegendreTrackFinderTest,TestFindWithNoise)
+{
+	ASSERT_TRUE(circles.size() > TRACK_MAX_COMBINATORIAL_HITS);
+	vector<DriftCircle> hits(circles);
+	hits.insert(hits.end(),noise.begin(),noise.end());
+
+	Track track = finder->find(hits.data(),hits.size());
+	ASSERT_TRUE(track.isValid());
+	ASSERT_EQ(circles.size(),track.getNumberOfHits());
+	ASSERT_NEAR(0.2,track.getTheta(),1e-6);
+	ASSERT_NEAR(150.0,track.getDistance(),1e-6);
+	ASSERT_NEAR(0.0,track.getChi2(),1e-9);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
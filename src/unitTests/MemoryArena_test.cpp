@@ -0,0 +1,134 @@
+/*
+ * MemoryArena_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../MemoryArena.h"
+#include "../Event.h"
+#include "../DataSet.h"
+#include <gtest/gtest.h>
+
+using namespace std;
+
+class MemoryArenaTest : public ::testing::Test
+{
+public:
+	MemoryArenaTest()
+	{
+		arena = new MemoryArena(1024);
+	}
+
+	~MemoryArenaTest()
+	{
+		delete arena;
+	}
+
+protected:
+	MemoryArena* arena;
+};
+
+TEST_F(MemoryArenaTest,TestAllocate)
+{
+	ASSERT_EQ(0,arena->getBytesReserved());
+	char* a = (char*)arena->allocate(10,1);
+	char* b = (char*)arena->allocate(8,8);
+	ASSERT_EQ(18,arena->getBytesAllocated());
+	ASSERT_EQ(1024,arena->getBytesReserved());
+	ASSERT_EQ(0,(uintptr_t)b % 8);
+	ASSERT_TRUE(b >= a + 10);
+
+	//larger than a block
+	char* c = (char*)arena->allocate(4096,16);
+	ASSERT_EQ(0,(uintptr_t)c % 16);
+	ASSERT_TRUE(arena->getBytesReserved() >= 1024 + 4096);
+	c[4095] = 1;
+}
+
+TEST_F(MemoryArenaTest,TestReset)
+{
+	void* a = arena->allocate(100);
+	arena->allocate(2000);
+	size_t reserved = arena->getBytesReserved();
+	arena->reset();
+	ASSERT_EQ(0,arena->getBytesAllocated());
+	//memory is reused, no new block is requested
+	ASSERT_EQ(a,arena->allocate(100));
+	arena->allocate(2000);
+	ASSERT_EQ(reserved,arena->getBytesReserved());
+	arena->release();
+	ASSERT_EQ(0,arena->getBytesReserved());
+}
+
+TEST_F(MemoryArenaTest,TestHugePages)
+{
+	MemoryArena huge(1000,true);
+	ASSERT_TRUE(huge.usesHugePages());
+	int* arr = (int*)huge.allocate(1000 * sizeof(int),alignof(int));
+	arr[999] = 42;
+	ASSERT_EQ(2 << 20,huge.getBytesReserved());
+}
+
+TEST_F(MemoryArenaTest,TestScope)
+{
+	ASSERT_EQ(nullptr,MemoryArena::current());
+	{
+		MemoryArena::Scope scope(arena);
+		ASSERT_EQ(arena,MemoryArena::current());
+		{
+			MemoryArena::Scope heap(nullptr);
+			ASSERT_EQ(nullptr,MemoryArena::current());
+		}
+		ASSERT_EQ(arena,MemoryArena::current());
+	}
+	ASSERT_EQ(nullptr,MemoryArena::current());
+}
+
+TEST_F(MemoryArenaTest,TestEventsInArena)
+{
+	shared_ptr<MemoryArena> eventArena = make_shared<MemoryArena>(1 << 16);
+	vector<unique_ptr<Event>> events;
+	{
+		MemoryArena::Scope scope(eventArena.get());
+		for(unsigned int i = 0; i < 10; ++i)
+		{
+			events.push_back(unique_ptr<Event>(new Event(i,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(800,i)))));
+		}
+	}
+	//the samples are in the arena of their Event
+	ASSERT_TRUE(eventArena->getBytesAllocated() >= 10 * (sizeof(Event) + 800 * sizeof(uint16_t)));
+	ASSERT_EQ(eventArena.get(),events[0]->getData().get_allocator().getArena());
+
+	//a heap event and an arena event can both be deleted the usual way
+	unique_ptr<Event> heapEvent(new Event(42,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(800,42))));
+	ASSERT_EQ(nullptr,heapEvent->getData().get_allocator().getArena());
+	events[9].reset();
+
+	//the DataSet keeps the arena alive
+	DataSet set(events,eventArena);
+	eventArena.reset();
+	ASSERT_EQ(10,set.getSize());
+	ASSERT_EQ(8,set[8][0]);
+	ASSERT_EQ(42,(*heapEvent)[0]);
+}
+
+TEST_F(MemoryArenaTest,TestAllocator)
+{
+	vector<int,ArenaAllocator<int>> numbers{ArenaAllocator<int>(arena)};
+	for(int i = 0; i < 100; ++i)
+	{
+		numbers.push_back(i);
+	}
+	ASSERT_EQ(99,numbers[99]);
+	ASSERT_TRUE(arena->getBytesAllocated() >= 100 * sizeof(int));
+
+	vector<int,ArenaAllocator<int>> heapNumbers(100,1);
+	ASSERT_EQ(100,heapNumbers.size());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,83 @@
+/*
+ * NoiseSpectrum_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../NoiseSpectrum.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace std;
+
+class NoiseSpectrumTest : public ::testing::Test
+{
+public:
+	NoiseSpectrumTest()
+	{
+		//pickup with amplitude 20 at 8 / 128 of the sampling frequency and uniform noise of +-5 channels
+		srand(42);
+		samples = new vector<uint16_t>(800);
+		for(size_t i = 0; i < samples->size(); ++i)
+		{
+			(*samples)[i] = lround(ABSOLUTE_OFFSET_ZERO_VOLTAGE + 20 * sin(2 * M_PI * 8 * i / 128) + (rand() % 11) - 5);
+		}
+	}
+
+	~NoiseSpectrumTest()
+	{
+		delete samples;
+	}
+
+protected:
+	vector<uint16_t>* samples;
+};
+
+TEST_F(NoiseSpectrumTest,TestAccumulate)
+{
+	NoiseSpectrum spectrum(128);
+	ASSERT_EQ(65,spectrum.getSize());
+	ASSERT_TRUE(spectrum.findLines().empty());
+	spectrum.accumulate(samples->data(),samples->size());
+	ASSERT_EQ(11,spectrum.getSegments());
+
+	vector<size_t> lines = spectrum.findLines();
+	ASSERT_EQ(1,lines.size());
+	ASSERT_EQ(8,lines[0]);
+	ASSERT_DOUBLE_EQ(1000.0 * 8 / (128 * ADC_BINS_TO_TIME),spectrum.getFrequency(8));
+	//sine 200, noise 10
+	ASSERT_NEAR(210,spectrum.getVariance(),20);
+	ASSERT_GT(spectrum.getPower(8),100);
+	ASSERT_THROW(NoiseSpectrum(100),invalid_argument);
+}
+
+TEST_F(NoiseSpectrumTest,TestDataSet)
+{
+	//one event without signal, one with a pulse at bin 400, of which the 392 bins before the guard are used
+	vector<uint16_t> withPulse(*samples);
+	for(size_t i = 400; i < 420; ++i)
+	{
+		withPulse[i] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 500;
+	}
+	vector<unique_ptr<Event>> events;
+	events.push_back(unique_ptr<Event>(new Event(0,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(*samples)),-42,ABSOLUTE_OFFSET_ZERO_VOLTAGE,0)));
+	events.push_back(unique_ptr<Event>(new Event(1,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(withPulse)),400,ABSOLUTE_OFFSET_ZERO_VOLTAGE,0)));
+	DataSet data(events);
+
+	NoiseSpectrum spectrum(128);
+	spectrum.accumulate(data);
+	ASSERT_EQ(11 + 5,spectrum.getSegments());
+	vector<size_t> lines = spectrum.findLines();
+	ASSERT_EQ(1,lines.size());
+	ASSERT_EQ(8,lines[0]);
+	ASSERT_NEAR(210,spectrum.getVariance(),20);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
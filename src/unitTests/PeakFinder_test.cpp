@@ -0,0 +1,105 @@
+/*
+ * PeakFinder_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../PeakFinder.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace std;
+
+class PeakFinderTest : public ::testing::Test
+{
+public:
+	PeakFinderTest()
+	{
+		//single pulse of depth 500 at bins [100,110) with a small wiggle, two piled up pulses of depth 600 at [200,210)
+		//and 400 at [215,225) with a valley of depth 300 between them, noise spike of depth 100 at bin 300
+		samples = new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE);
+		for(size_t i = 100; i < 110; ++i)
+		{
+			(*samples)[i] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 500;
+		}
+		(*samples)[105] += 10;
+		for(size_t i = 200; i < 225; ++i)
+		{
+			(*samples)[i] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - (i < 210 ? 600 : (i < 215 ? 300 : 400));
+		}
+		(*samples)[300] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 100;
+	}
+
+	~PeakFinderTest()
+	{
+		delete samples;
+	}
+
+protected:
+	vector<uint16_t>* samples;
+};
+
+TEST_F(PeakFinderTest,TestFind)
+{
+	PeakFinder finder(true);
+	vector<Peak> peaks;
+	const uint16_t threshold = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 300;
+	ASSERT_EQ(3,finder.find(samples->data(),samples->size(),ABSOLUTE_OFFSET_ZERO_VOLTAGE,threshold,peaks));
+
+	ASSERT_EQ(100,peaks[0].bin);
+	ASSERT_EQ(500,peaks[0].amplitude);
+	ASSERT_EQ(10,peaks[0].width);
+	ASSERT_EQ(0,peaks[0].piledUp);
+
+	ASSERT_EQ(200,peaks[1].bin);
+	ASSERT_EQ(600,peaks[1].amplitude);
+	ASSERT_EQ(10,peaks[1].width);
+	ASSERT_EQ(1,peaks[1].piledUp);
+
+	ASSERT_EQ(215,peaks[2].bin);
+	ASSERT_EQ(400,peaks[2].amplitude);
+	ASSERT_EQ(15,peaks[2].width);
+	ASSERT_EQ(1,peaks[2].piledUp);
+
+	//with a prominence above the valley, the piled up pulses are one peak
+	PeakFinder coarse(true,0.5,400);
+	ASSERT_EQ(2,coarse.find(samples->data(),samples->size(),ABSOLUTE_OFFSET_ZERO_VOLTAGE,threshold,peaks));
+	ASSERT_EQ(25,peaks[1].width);
+	ASSERT_EQ(0,peaks[1].piledUp);
+
+	//without pulses, the list is cleared
+	vector<uint16_t> flat(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE);
+	ASSERT_EQ(0,finder.find(flat.data(),flat.size(),ABSOLUTE_OFFSET_ZERO_VOLTAGE,threshold,peaks));
+	ASSERT_TRUE(peaks.empty());
+}
+
+TEST_F(PeakFinderTest,TestPolarity)
+{
+	for(uint16_t& sample : *samples)
+	{
+		sample = 2 * ABSOLUTE_OFFSET_ZERO_VOLTAGE - sample;
+	}
+	PeakFinder finder(false);
+	vector<Peak> peaks;
+	ASSERT_EQ(3,finder.find(samples->data(),samples->size(),ABSOLUTE_OFFSET_ZERO_VOLTAGE,ABSOLUTE_OFFSET_ZERO_VOLTAGE + 300,peaks));
+	ASSERT_EQ(215,peaks[2].bin);
+	ASSERT_EQ(400,peaks[2].amplitude);
+}
+
+TEST_F(PeakFinderTest,TestEvent)
+{
+	Event event(0,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(*samples)),100,ABSOLUTE_OFFSET_ZERO_VOLTAGE,0);
+	PeakFinder finder;
+	vector<Peak> peaks;
+	ASSERT_EQ(3,finder.find(event,peaks));
+	ASSERT_EQ(200,peaks[1].bin);
+
+	ASSERT_THROW(PeakFinder(true,1.5),invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
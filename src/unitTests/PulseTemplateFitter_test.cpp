@@ -0,0 +1,174 @@
+/*
+ * PulseTemplateFitter_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../PulseTemplateFitter.h"
+#include "../DataPresenceException.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+class PulseTemplateFitterTest : public ::testing::Test
+{
+public:
+	PulseTemplateFitterTest()
+	{
+		//gaussian pulse shape with a width of 3 bins, extremum at bin 12 of 32
+		shape = new vector<float>(32);
+		for(size_t k = 0; k < shape->size(); ++k)
+		{
+			(*shape)[k] = pulse(k,12,1);
+		}
+	}
+
+	~PulseTemplateFitterTest()
+	{
+		delete shape;
+	}
+
+	static float pulse(const double bin, const double time, const double amplitude)
+	{
+		return amplitude * exp(-(bin - time) * (bin - time) / 18);
+	}
+
+	//negative pulses on the offset, clipped to the range of the FADC
+	static Event* createEvent(const unsigned int number, const vector<pair<double,double>>& pulses)
+	{
+		unique_ptr<vector<uint16_t>> data(new vector<uint16_t>(800));
+		for(size_t i = 0; i < data->size(); ++i)
+		{
+			double value = ABSOLUTE_OFFSET_ZERO_VOLTAGE;
+			for(const pair<double,double>& p : pulses)
+			{
+				value -= pulse(i,p.first,p.second);
+			}
+			(*data)[i] = value < 0 ? 0 : (uint16_t)lround(value);
+		}
+		return new Event(number,move(data),0,ABSOLUTE_OFFSET_ZERO_VOLTAGE,0);
+	}
+
+protected:
+	vector<float>* shape;
+};
+
+TEST_F(PulseTemplateFitterTest,TestFit)
+{
+	PulseTemplateFitter fitter(32,12,true);
+	unique_ptr<Event> event(createEvent(0,{{100.3,500},{300,400}}));
+	PeakFinder finder(true);
+	vector<Peak> peaks;
+	ASSERT_EQ(2,finder.find(*event,peaks));
+	vector<PulseFit> fits;
+	ASSERT_THROW(fitter.fit(*event,peaks,fits),DataPresenceException);
+
+	fitter.setTemplate(*shape);
+	fitter.setAfterpulseStartBin(200);
+	ASSERT_EQ(2,fitter.fit(*event,peaks,fits));
+	ASSERT_NEAR(500,fits[0].amplitude,5);
+	ASSERT_NEAR(100.3,fits[0].time,0.05);
+	ASSERT_LT(fits[0].deviation,0.01);
+	ASSERT_EQ(PulseTemplateFitter::SIGNAL,fits[0].type);
+	ASSERT_EQ(0,fits[0].saturated);
+	ASSERT_NEAR(400,fits[1].amplitude,4);
+	ASSERT_NEAR(300,fits[1].time,0.05);
+	ASSERT_EQ(PulseTemplateFitter::AFTERPULSE,fits[1].type);
+
+	//a second pulse before the afterpulse start bin is a signal as well
+	fits.clear();
+	fitter.setAfterpulseStartBin(400);
+	fitter.fit(*event,peaks,fits);
+	ASSERT_EQ(PulseTemplateFitter::SIGNAL,fits[1].type);
+}
+
+TEST_F(PulseTemplateFitterTest,TestSaturation)
+{
+	PulseTemplateFitter fitter(32,12,true);
+	fitter.setTemplate(*shape);
+	//the pulse undershoots the range of the FADC by 800 channels
+	unique_ptr<Event> event(createEvent(0,{{150,3000}}));
+	PeakFinder finder(true);
+	vector<Peak> peaks;
+	ASSERT_EQ(1,finder.find(*event,peaks));
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE,peaks[0].amplitude);
+	vector<PulseFit> fits;
+	fitter.fit(*event,peaks,fits);
+	ASSERT_EQ(SATURATION_MARGIN,fitter.getSaturationLevel());
+	ASSERT_EQ(1,fits[0].saturated);
+	ASSERT_NEAR(3000,fits[0].amplitude,30);
+	ASSERT_NEAR(150,fits[0].time,0.1);
+	ASSERT_EQ(PulseTemplateFitter::SIGNAL,fits[0].type);
+}
+
+TEST_F(PulseTemplateFitterTest,TestClassification)
+{
+	PulseTemplateFitter fitter(32,12,true);
+	fitter.setTemplate(*shape);
+	PeakFinder finder(true);
+	vector<Peak> peaks;
+	vector<PulseFit> fits;
+
+	//pulses 8 bins apart share one pulse
+	unique_ptr<Event> pileUp(createEvent(0,{{100,500},{108,500}}));
+	ASSERT_EQ(2,finder.find(*pileUp,peaks));
+	fitter.fit(*pileUp,peaks,fits);
+	ASSERT_EQ(PulseTemplateFitter::PILE_UP,fits[0].type);
+	ASSERT_EQ(PulseTemplateFitter::PILE_UP,fits[1].type);
+
+	//a rectangular pulse does not have the shape of the template
+	unique_ptr<vector<uint16_t>> data(new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+	for(size_t i = 100; i < 120; ++i)
+	{
+		(*data)[i] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 500;
+	}
+	Event rectangular(1,move(data),100,ABSOLUTE_OFFSET_ZERO_VOLTAGE,0);
+	ASSERT_EQ(1,finder.find(rectangular,peaks));
+	fits.clear();
+	fitter.fit(rectangular,peaks,fits);
+	ASSERT_EQ(PulseTemplateFitter::DISTORTED,fits[0].type);
+	ASSERT_GT(fits[0].deviation,fitter.getMaxDeviation());
+}
+
+TEST_F(PulseTemplateFitterTest,TestBuildTemplate)
+{
+	vector<unique_ptr<Event>> events;
+	for(unsigned int i = 0; i < 10; ++i)
+	{
+		events.push_back(unique_ptr<Event>(createEvent(i,{{100.0 + 10 * i,400.0 + 50 * i}})));
+	}
+	//pile-up and saturated pulses are not used
+	events.push_back(unique_ptr<Event>(createEvent(10,{{100,500},{108,500}})));
+	events.push_back(unique_ptr<Event>(createEvent(11,{{100,3000}})));
+	DataSet data(events);
+
+	PulseTemplateFitter fitter(32,12,true);
+	ASSERT_EQ(10,fitter.buildTemplate(data));
+	ASSERT_FLOAT_EQ(1,fitter.getTemplate()[12]);
+	for(size_t k = 0; k < shape->size(); ++k)
+	{
+		ASSERT_NEAR((*shape)[k],fitter.getTemplate()[k],0.01);
+	}
+
+	vector<PulseFit> fits;
+	ASSERT_EQ(13,fitter.fit(data,fits));
+	ASSERT_EQ(PulseTemplateFitter::SIGNAL,fits[0].type);
+	ASSERT_NEAR(400,fits[0].amplitude,4);
+	ASSERT_EQ(11,fits.back().event);
+	ASSERT_EQ(1,fits.back().saturated);
+
+	vector<unique_ptr<Event>> empty;
+	DataSet noPulses(empty);
+	ASSERT_THROW(fitter.buildTemplate(noPulses),DataPresenceException);
+	ASSERT_THROW(PulseTemplateFitter(2,0),invalid_argument);
+	ASSERT_THROW(fitter.setTemplate(vector<float>(32,1)),invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,80 @@
+/*
+ * RealFFT_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../RealFFT.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+class RealFFTTest : public ::testing::Test
+{
+public:
+	RealFFTTest()
+	{
+		samples = new vector<float>(64);
+		for(size_t i = 0; i < samples->size(); ++i)
+		{
+			(*samples)[i] = sin(0.7 * i * i) + 0.25 * i;
+		}
+	}
+
+	~RealFFTTest()
+	{
+		delete samples;
+	}
+
+protected:
+	vector<float>* samples;
+};
+
+TEST_F(RealFFTTest,TestTransform)
+{
+	const size_t n = samples->size();
+	RealFFT fft(n);
+	vector<complex<float>> result(n / 2 + 1);
+	fft.transform(samples->data(),result.data());
+	for(size_t k = 0; k <= n / 2; ++k)
+	{
+		complex<double> expected = 0;
+		for(size_t j = 0; j < n; ++j)
+		{
+			expected += (double)(*samples)[j] * polar(1.0,-2 * M_PI * j * k / n);
+		}
+		ASSERT_NEAR(expected.real(),result[k].real(),1e-3);
+		ASSERT_NEAR(expected.imag(),result[k].imag(),1e-3);
+	}
+}
+
+TEST_F(RealFFTTest,TestPower)
+{
+	//cosine with frequency bin 3 and amplitude 2 in two segments
+	vector<float> data(32);
+	for(size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = 2 * cos(2 * M_PI * 3 * (i % 16) / 16);
+	}
+	RealFFT fft(16);
+	vector<float> spectrum(9,0);
+	fft.addPower(data.data(),2,16,spectrum.data());
+	for(size_t k = 0; k < spectrum.size(); ++k)
+	{
+		ASSERT_NEAR(k == 3 ? 2 * 16 * 16 : 0,spectrum[k],1e-2);
+	}
+	fft.power(data.data(),spectrum.data());
+	ASSERT_NEAR(16 * 16,spectrum[3],1e-2);
+
+	ASSERT_THROW(RealFFT(12),invalid_argument);
+	ASSERT_THROW(RealFFT(2),invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,121 @@
+/*
+ * RtCalibrator_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../RtCalibrator.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <cmath>
+
+using namespace std;
+
+//true rt-relation of the simulated tubes, the maximum drift time is 600 ns
+static double trueRadius(const double driftTime)
+{
+	return driftTime >= 600 ? DRIFT_TUBE_RADIUS : DRIFT_TUBE_RADIUS * pow(driftTime / 600, 0.7);
+}
+
+class RtCalibratorTest : public ::testing::Test
+{
+public:
+	RtCalibratorTest()
+	{
+		//staggered chamber of 4 layers with 8 tubes each, crossed by 1500 random tracks
+		const unsigned int nTriggers = 1500;
+		const unsigned int nBins = 200;
+		vector<array<double,2>> wires;
+		for(unsigned int layer = 0; layer < 4; ++layer)
+		{
+			for(unsigned int tube = 0; tube < 8; ++tube)
+			{
+				wires.push_back({{2 * DRIFT_TUBE_RADIUS * tube + DRIFT_TUBE_RADIUS * (layer % 2), 31.5 * layer}});
+			}
+		}
+		vector<vector<unique_ptr<Event>>> events(wires.size());
+		mt19937 generator(42);
+		uniform_real_distribution<double> angle(-0.4,0.4);
+		uniform_real_distribution<double> position(40,230);
+		for(unsigned int trigger = 0; trigger < nTriggers; ++trigger)
+		{
+			double theta = angle(generator);
+			double distance = position(generator) * cos(theta);
+			for(unsigned int tube = 0; tube < wires.size(); ++tube)
+			{
+				unique_ptr<vector<uint16_t>> data(new vector<uint16_t>(nBins,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+				double radius = fabs(wires[tube][0] * cos(theta) + wires[tube][1] * sin(theta) - distance);
+				if(radius < DRIFT_TUBE_RADIUS)
+				{
+					size_t bin = lround(600 * pow(radius / DRIFT_TUBE_RADIUS, 1 / 0.7) / ADC_BINS_TO_TIME);
+					for(size_t i = bin; i < bin + 5; ++i)
+					{
+						(*data)[i] = 1500;
+					}
+				}
+				events[tube].push_back(unique_ptr<Event>(new Event(trigger,move(data))));
+			}
+		}
+		for(unsigned int tube = 0; tube < wires.size(); ++tube)
+		{
+			tubes.push_back(unique_ptr<Drifttube>(new Drifttube(wires[tube][0],wires[tube][1],unique_ptr<DataSet>(new DataSet(events[tube])))));
+		}
+		hits = new TriggerEventCollection(tubes);
+
+		//linear start value
+		unique_ptr<vector<double>> rt(new vector<double>(nBins));
+		for(unsigned int bin = 0; bin < nBins; ++bin)
+		{
+			(*rt)[bin] = min(DRIFT_TUBE_RADIUS,DRIFT_TUBE_RADIUS * bin * ADC_BINS_TO_TIME / 600);
+		}
+		linear = new RtRelation(move(rt));
+	}
+
+	~RtCalibratorTest()
+	{
+		delete hits;
+		delete linear;
+	}
+
+	double meanDeviation(const RtRelation& rt)
+	{
+		double sum = 0;
+		for(unsigned int bin = 5; bin < 140; ++bin)
+		{
+			sum += fabs(rt[bin] - trueRadius(bin * ADC_BINS_TO_TIME));
+		}
+		return sum / 135;
+	}
+
+protected:
+	vector<unique_ptr<Drifttube>> tubes;
+	TriggerEventCollection* hits;
+	RtRelation* linear;
+};
+
+TEST_F(RtCalibratorTest,TestCalibrate)
+{
+	RtCalibrator calibrator(*hits,vector<const RtRelation*>(tubes.size(),linear));
+	ASSERT_TRUE(meanDeviation(calibrator.getRtRelation(0)) > 1.0);
+
+	unsigned int iterations = calibrator.calibrate(30,0.01);
+	ASSERT_TRUE(iterations > 1);
+	ASSERT_TRUE(calibrator.getNumberOfTracks() > 1000);
+	ASSERT_EQ(iterations,calibrator.getResidualRMS().size());
+	ASSERT_TRUE(calibrator.getResidualRMS().back() < calibrator.getResidualRMS().front());
+	for(unsigned int tube = 0; tube < tubes.size(); ++tube)
+	{
+		ASSERT_TRUE(meanDeviation(calibrator.getRtRelation(tube)) < 0.3);
+	}
+
+	//the start values are not changed
+	ASSERT_DOUBLE_EQ(DRIFT_TUBE_RADIUS * 100 * ADC_BINS_TO_TIME / 600,(*linear)[100]);
+	ASSERT_EQ(tubes.size(),calibrator.getRtRelations().size());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -55,6 +55,32 @@ TEST_F(RtRelationTest,TestAssignmentOperator)
 	}
 }
 
+TEST_F(RtRelationTest,TestFindBin)
+{
+	//0.1 mm per bin with a plateau from bin 10 to 19
+	unique_ptr<vector<double>> data(new vector<double>(100));
+	for(size_t i = 0; i < data->size(); ++i)
+	{
+		(*data)[i] = 0.1 * (i < 10 ? i : (i < 20 ? 10 : i - 10));
+	}
+	RtRelation rt(move(data));
+	ASSERT_EQ(0,rt.findBin(0));
+	ASSERT_EQ(10,rt.findBin(1.0));
+	ASSERT_EQ(21,rt.findBin(1.05));
+	ASSERT_EQ(100,rt.findBin(10));
+
+	vector<double> radii = {0, 0.55, 1.0, 1.05, 8.95, 10};
+	vector<size_t> bins;
+	rt.findBins(radii,bins);
+	ASSERT_EQ(radii.size(),bins.size());
+	for(size_t i = 0; i < radii.size(); ++i)
+	{
+		ASSERT_EQ(rt.findBin(radii[i]),bins[i]);
+	}
+	ASSERT_EQ(0,rt2->findBin(0));
+	ASSERT_EQ(800,rt2->findBin(1));
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
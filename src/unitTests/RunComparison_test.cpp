@@ -0,0 +1,152 @@
+/*
+ * RunComparison_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../RunComparison.h"
+#include "../DataPresenceException.h"
+#include "../globals.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+class RunComparisonTest : public ::testing::Test
+{
+public:
+	RunComparisonTest()
+	{
+		//two runs with the same drift times, one run with drift times shifted by 20 bins
+		same = new vector<unique_ptr<Drifttube>>();
+		other = new vector<unique_ptr<Drifttube>>();
+		shifted = new vector<unique_ptr<Drifttube>>();
+		same->push_back(createTube(0));
+		other->push_back(createTube(0));
+		shifted->push_back(createTube(20));
+	}
+
+	~RunComparisonTest()
+	{
+		delete same;
+		delete other;
+		delete shifted;
+	}
+
+protected:
+	unique_ptr<Drifttube> createTube(const short shift)
+	{
+		vector<unique_ptr<Event>> events;
+		for(unsigned int i = 0; i < 500; ++i)
+		{
+			unique_ptr<vector<uint16_t>> samples(new vector<uint16_t>(200,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+			events.push_back(unique_ptr<Event>(new Event(i,move(samples),(short)(ADC_TRIGGERPOS_BIN + i % 50 + shift))));
+		}
+		return unique_ptr<Drifttube>(new Drifttube(0,0,unique_ptr<DataSet>(new DataSet(events))));
+	}
+
+	vector<unique_ptr<Drifttube>>* same;
+	vector<unique_ptr<Drifttube>>* other;
+	vector<unique_ptr<Drifttube>>* shifted;
+};
+
+TEST_F(RunComparisonTest,TestCompare)
+{
+	RunComparison comparison;
+	comparison.add("same",*same);
+	comparison.add("other",*other);
+	comparison.add("shifted",*shifted);
+	ASSERT_EQ(3,comparison.getRuns().size());
+	ASSERT_EQ("other",comparison.getRuns()[1].filename);
+	ASSERT_DOUBLE_EQ(DRIFT_TUBE_RADIUS,comparison.getRuns()[0].radii[0]);
+
+	vector<RunDifference> differences = comparison.compare();
+	ASSERT_EQ(2,differences.size());
+	ASSERT_EQ(1,differences[0].run);
+	ASSERT_EQ(0,differences[0].tube);
+	ASSERT_DOUBLE_EQ(0,differences[0].chi2);
+	ASSERT_EQ(49,differences[0].ndf);
+	ASSERT_DOUBLE_EQ(0,differences[0].ksDistance);
+	ASSERT_DOUBLE_EQ(1,differences[0].ksProbability);
+	ASSERT_DOUBLE_EQ(0,differences[0].rtDifference);
+
+	//20 of 50 bins shifted out of the common range
+	ASSERT_EQ(2,differences[1].run);
+	ASSERT_EQ(69,differences[1].ndf);
+	//40 bins with 10 entries in one spectrum only: 40 * (500 * 10)^2 / 10 / (500 * 500)
+	ASSERT_DOUBLE_EQ(400,differences[1].chi2);
+	ASSERT_NEAR(0.4,differences[1].ksDistance,1e-9);
+	ASSERT_LT(differences[1].ksProbability,1e-6);
+	ASSERT_NEAR(0.4 * DRIFT_TUBE_RADIUS,differences[1].rtDifference,1e-9);
+
+	ASSERT_THROW(comparison.compare(3),invalid_argument);
+}
+
+TEST_F(RunComparisonTest,TestLinearity)
+{
+	//r = 0.01 mm/ns * t
+	unique_ptr<vector<double>> data(new vector<double>(800));
+	for(size_t i = 0; i < data->size(); ++i)
+	{
+		(*data)[i] = 0.01 * i * ADC_BINS_TO_TIME;
+	}
+	RtRelation rt(move(data));
+	vector<double> deviations;
+	RunComparison::linearity(rt,DRIFT_TUBE_RADIUS,deviations);
+	ASSERT_EQ((size_t)ceil(DRIFT_TUBE_RADIUS / 0.1) - 1,deviations.size());
+	for(size_t k = 9; k < deviations.size(); ++k)
+	{
+		//the measured time is at most one bin after the line
+		ASSERT_GE(deviations[k],-1e-9);
+		ASSERT_LE(deviations[k],ADC_BINS_TO_TIME / (0.1 * (k + 1) / 0.01) + 1e-6);
+	}
+
+	unique_ptr<vector<double>> flat(new vector<double>(800,0));
+	RunComparison::linearity(RtRelation(move(flat)),DRIFT_TUBE_RADIUS,deviations);
+	ASSERT_TRUE(deviations.empty());
+}
+
+TEST_F(RunComparisonTest,TestLoad)
+{
+	string filename = "RunComparisonTest.drift";
+	{
+		ofstream file(filename, ios::out | ios::binary);
+		uint32_t header[3] = {1,3,100};
+		file.write((char*)header,sizeof(header));
+		for(uint32_t i = 0; i < 3; ++i)
+		{
+			vector<uint16_t> samples(100,ABSOLUTE_OFFSET_ZERO_VOLTAGE);
+			samples[20 + i] = ABSOLUTE_OFFSET_ZERO_VOLTAGE + 2 * ABSOLUTE_EVENT_THRESHOLD_VOLTAGE;
+			file.write((char*)samples.data(),samples.size() * sizeof(uint16_t));
+		}
+	}
+	string listname = "RunComparisonTest.list";
+	{
+		ofstream list(listname);
+		list << "# runs" << endl << filename << endl << endl << "  missing.drift  " << endl << filename << endl;
+	}
+	vector<string> filenames = RunComparison::readList(listname);
+	remove(listname.c_str());
+	ASSERT_EQ(3,filenames.size());
+	ASSERT_EQ("missing.drift",filenames[1]);
+
+	RunComparison comparison;
+	comparison.load(filenames);
+	remove(filename.c_str());
+	ASSERT_EQ(2,comparison.getRuns().size());
+	ASSERT_EQ(1,comparison.getFailed().size());
+	ASSERT_EQ("missing.drift",comparison.getFailed()[0]);
+	ASSERT_EQ(1,comparison.getRuns()[1].spectra[0][20 - ADC_TRIGGERPOS_BIN + 2]);
+	ASSERT_DOUBLE_EQ(0,comparison.compare()[0].chi2);
+	ASSERT_THROW(RunComparison::readList(listname),DataPresenceException);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc,argv);
+	return RUN_ALL_TESTS();
+}
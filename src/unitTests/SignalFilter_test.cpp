@@ -0,0 +1,164 @@
+/*
+ * SignalFilter_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../SignalFilter.h"
+#include "../DataProcessor.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+class SignalFilterTest : public ::testing::Test
+{
+public:
+	SignalFilterTest()
+	{
+		//noise spike of one bin at bin 10, pulse of depth 400 at bins [100,120)
+		samples = new vector<uint16_t>(400,ABSOLUTE_OFFSET_ZERO_VOLTAGE);
+		(*samples)[10] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 400;
+		for(size_t i = 100; i < 120; ++i)
+		{
+			(*samples)[i] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 400;
+		}
+	}
+
+	~SignalFilterTest()
+	{
+		delete samples;
+	}
+
+protected:
+	vector<uint16_t>* samples;
+};
+
+TEST_F(SignalFilterTest,TestMovingAverage)
+{
+	const uint16_t threshold = ABSOLUTE_OFFSET_ZERO_VOLTAGE + ABSOLUTE_EVENT_THRESHOLD_VOLTAGE;
+	ASSERT_EQ(10,DataProcessor::findDriftTimeBin(samples->data(),samples->size(),threshold));
+
+	SignalFilter filter;
+	filter.addMovingAverage(5);
+	filter.apply(samples->data(),samples->size());
+	//the spike is spread to 80 channels, the pulse is crossed where 4 of 5 samples are in it
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE - 80,(*samples)[10]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE - 400,(*samples)[110]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE - 240,(*samples)[100]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE,(*samples)[0]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE,(*samples)[399]);
+	ASSERT_EQ(101,DataProcessor::findDriftTimeBin(samples->data(),samples->size(),threshold));
+}
+
+TEST_F(SignalFilterTest,TestFir)
+{
+	vector<uint16_t> original(*samples);
+	SignalFilter identity;
+	identity.addFir({0,1,0});
+	identity.apply(samples->data(),samples->size());
+	ASSERT_EQ(original,*samples);
+
+	//taps are normalised, the spike is spread over three bins
+	SignalFilter smooth;
+	smooth.addFir({1,2,1});
+	ASSERT_FLOAT_EQ(0.5,smooth.getStages()[0].taps[1]);
+	smooth.apply(samples->data(),samples->size());
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE - 100,(*samples)[9]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE - 200,(*samples)[10]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE - 100,(*samples)[11]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE - 400,(*samples)[110]);
+}
+
+TEST_F(SignalFilterTest,TestDerivative)
+{
+	SignalFilter filter;
+	filter.addDerivative(2);
+	filter.apply(samples->data(),samples->size());
+	//the leading edge undershoots, the trailing edge overshoots, the flat pulse vanishes
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE - 400,(*samples)[100]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE - 400,(*samples)[101]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE,(*samples)[110]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE + 400,(*samples)[120]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE,(*samples)[0]);
+}
+
+TEST_F(SignalFilterTest,TestPoleZero)
+{
+	//AC coupling with decay constant 50 bins: the pulse decays and is followed by an undershoot
+	const float tau = 50;
+	const float decay = exp(-1 / tau);
+	vector<uint16_t> coupled(samples->size());
+	float output = 0;
+	for(size_t i = 0; i < samples->size(); ++i)
+	{
+		float input = (float)(*samples)[i] - ABSOLUTE_OFFSET_ZERO_VOLTAGE;
+		float previous = i > 0 ? (float)(*samples)[i - 1] - ABSOLUTE_OFFSET_ZERO_VOLTAGE : 0;
+		output = decay * (output + input - previous);
+		coupled[i] = (uint16_t)lround(output + ABSOLUTE_OFFSET_ZERO_VOLTAGE);
+	}
+	ASSERT_GT(coupled[125],ABSOLUTE_OFFSET_ZERO_VOLTAGE + 50);
+
+	SignalFilter filter;
+	filter.addPoleZero(tau);
+	filter.apply(coupled.data(),coupled.size());
+	ASSERT_NEAR(ABSOLUTE_OFFSET_ZERO_VOLTAGE - 400 * decay,coupled[119],5);
+	ASSERT_NEAR(ABSOLUTE_OFFSET_ZERO_VOLTAGE,coupled[125],5);
+	ASSERT_NEAR(ABSOLUTE_OFFSET_ZERO_VOLTAGE,coupled[300],5);
+}
+
+TEST_F(SignalFilterTest,TestPoleZeroBaseline)
+{
+	//baseline 20 channels above the offset, without a baseline estimate the difference is integrated into a ramp
+	const float tau = 250;
+	vector<uint16_t> shifted(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE + 20);
+	vector<uint16_t> unrestored(shifted);
+	SignalFilter offsetFilter;
+	offsetFilter.addPoleZero(tau);
+	offsetFilter.apply(unrestored.data(),unrestored.size());
+	ASSERT_GT(unrestored[799],ABSOLUTE_OFFSET_ZERO_VOLTAGE + 20 + 50);
+
+	SignalFilter filter = SignalFilter::parse("polezero:250",ABSOLUTE_OFFSET_ZERO_VOLTAGE,50);
+	filter.apply(shifted.data(),shifted.size());
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE + 20,shifted[50]);
+	ASSERT_EQ(ABSOLUTE_OFFSET_ZERO_VOLTAGE + 20,shifted[799]);
+}
+
+TEST_F(SignalFilterTest,TestChunk)
+{
+	SignalFilter filter = SignalFilter::parse("average:5+derivative:1");
+	ASSERT_EQ(2,filter.getNumberOfStages());
+	ASSERT_EQ(SignalFilter::MOVING_AVERAGE,filter.getStages()[0].type);
+	ASSERT_EQ(SignalFilter::DERIVATIVE,filter.getStages()[1].type);
+
+	//three copies of the event in one buffer give the same result as the single event
+	vector<uint16_t> buffer;
+	for(int i = 0; i < 3; ++i)
+	{
+		buffer.insert(buffer.end(),samples->begin(),samples->end());
+	}
+	filter.apply(buffer.data(),3,samples->size());
+	filter.apply(samples->data(),samples->size());
+	for(int i = 0; i < 3; ++i)
+	{
+		ASSERT_TRUE(equal(samples->begin(),samples->end(),buffer.begin() + i * samples->size()));
+	}
+
+	ASSERT_TRUE(SignalFilter::parse("").empty());
+	ASSERT_THROW(SignalFilter::parse("median:3"),invalid_argument);
+	ASSERT_THROW(SignalFilter::parse("average"),invalid_argument);
+	ASSERT_THROW(SignalFilter::parse("fir:1,x"),invalid_argument);
+	ASSERT_THROW(SignalFilter::parse("polezero:-3"),invalid_argument);
+	ASSERT_THROW(SignalFilter::parse("average:-3"),invalid_argument);
+	ASSERT_THROW(SignalFilter::parse("average:2.7"),invalid_argument);
+	ASSERT_THROW(SignalFilter::parse("average:4"),invalid_argument);
+	ASSERT_THROW(SignalFilter::parse("derivative:0.5"),invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,135 @@
+/*
+ * ThresholdScan_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../ThresholdScan.h"
+#include "../DataProcessor.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace std;
+
+class ThresholdScanTest : public ::testing::Test
+{
+public:
+	ThresholdScanTest()
+	{
+		//pulses of depth 400 to 1500 at bin 20 + i % 100, every 3rd event with an afterpulse of depth 400 at bin 180
+		vector<unique_ptr<Event>> events;
+		for(unsigned int i = 0; i < 1200; ++i)
+		{
+			unique_ptr<vector<uint16_t>> data(new vector<uint16_t>(200,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+			for(unsigned int bin = 20 + i % 100; bin < 28 + i % 100; ++bin)
+			{
+				(*data)[bin] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 400 - i % 12 * 100;
+			}
+			if(i % 3 == 0)
+			{
+				(*data)[180] = (*data)[181] = ABSOLUTE_OFFSET_ZERO_VOLTAGE - 400;
+			}
+			events.push_back(unique_ptr<Event>(new Event(i,move(data))));
+		}
+		tube = new Drifttube(0,0,unique_ptr<DataSet>(new DataSet(events)));
+	}
+
+	~ThresholdScanTest()
+	{
+		delete tube;
+	}
+
+protected:
+	Drifttube* tube;
+};
+
+TEST_F(ThresholdScanTest,TestScan)
+{
+	ThresholdScan scan = ThresholdScan::scan(*tube,{-1000, -100, -600, ABSOLUTE_EVENT_THRESHOLD_VOLTAGE});
+	const vector<int> sorted = {-100, ABSOLUTE_EVENT_THRESHOLD_VOLTAGE, -600, -1000};
+	ASSERT_EQ(sorted,scan.getThresholds());
+	ASSERT_EQ(1200,scan.getNumberOfEvents());
+	ASSERT_EQ(4,scan.getHistogram().size());
+
+	//depths are 400 + 100 * (i % 12), a threshold is crossed if the depth is larger
+	ASSERT_DOUBLE_EQ(1.0,scan.getEfficiency(0));
+	ASSERT_DOUBLE_EQ(1.0,scan.getEfficiency(1));
+	ASSERT_DOUBLE_EQ(9.0 / 12,scan.getEfficiency(2));
+	ASSERT_DOUBLE_EQ(5.0 / 12,scan.getEfficiency(3));
+
+	//the default threshold reproduces the drift time spectrum and the afterpulses of the tube
+	ASSERT_EQ(tube->getDataSet().getDriftTimeHistogram(),scan.getHistogram()[1]);
+	ASSERT_EQ(DataProcessor::countAfterpulses(*tube),scan.getAfterpulses(1));
+	//pulses still in progress at the maximum drift time count as well, the afterpulses of depth 400 vanish at -600
+	ASSERT_EQ(scan.getAfterpulses(1),scan.getAfterpulses(0));
+	ASSERT_TRUE(scan.getAfterpulses(1) >= scan.getAfterpulses(2) + 400);
+	ASSERT_DOUBLE_EQ(scan.getAfterpulses(1) / 1200.0,scan.getAfterpulseProbability(1));
+
+	DriftTimeSpectrum spectrum = scan.getDriftTimeSpectrum(3);
+	ASSERT_EQ(1200,spectrum.getEntries());
+	ASSERT_EQ(700,spectrum.getRejected());
+	//events 0, 100, ... 1100 start at bin 20, only those with i % 12 == 8 are deeper than 1000
+	ASSERT_EQ(4,spectrum[20]);
+}
+
+TEST_F(ThresholdScanTest,TestMerge)
+{
+	ThresholdScan first = ThresholdScan::scan(*tube,{-300, -600});
+	ThresholdScan second = ThresholdScan::scan(*tube,{-600, -300});
+	first.merge(second);
+	ASSERT_EQ(2400,first.getNumberOfEvents());
+	ASSERT_DOUBLE_EQ(9.0 / 12,first.getEfficiency(1));
+	ASSERT_EQ(2 * second.getHistogram()[0][50],first.getHistogram()[0][50]);
+
+	ThresholdScan other(vector<int>{-300},0);
+	ASSERT_THROW(first.merge(other),invalid_argument);
+}
+
+TEST_F(ThresholdScanTest,TestPolarityAndBaseline)
+{
+	//positive pulses of height 400 or 800 on a baseline 1000 channels above the offset
+	AnalysisConfig config;
+	config.set("polarity","positive");
+	config.set("threshold","300");
+	AnalysisConfig::Scope scope(config);
+	const uint16_t baseline = ABSOLUTE_OFFSET_ZERO_VOLTAGE + 1000;
+	vector<unique_ptr<Event>> events;
+	for(unsigned int i = 0; i < 100; ++i)
+	{
+		vector<uint16_t> samples(200,baseline);
+		samples[30 + i % 10] = baseline + 400 + i % 2 * 400;
+		events.push_back(unique_ptr<Event>(new Event(i,samples.data(),samples.size(),0,baseline,0)));
+	}
+	DataSet data(events);
+	ThresholdScan scan({600, 300, 1000},0);
+	const vector<int> sorted = {300, 600, 1000};
+	ASSERT_EQ(sorted,scan.getThresholds());
+	scan.fill(data);
+	ASSERT_DOUBLE_EQ(1.0,scan.getEfficiency(0));
+	ASSERT_DOUBLE_EQ(0.5,scan.getEfficiency(1));
+	ASSERT_DOUBLE_EQ(0.0,scan.getEfficiency(2));
+	ASSERT_EQ(10,scan.getHistogram()[0][30 + 3 - ADC_TRIGGERPOS_BIN]);
+	//every pulse starts after bin 0
+	ASSERT_EQ(100,scan.getAfterpulses(0));
+}
+
+TEST_F(ThresholdScanTest,TestZeroSuppression)
+{
+	vector<unique_ptr<Event>> events;
+	events.push_back(unique_ptr<Event>(new Event(0,unique_ptr<vector<uint16_t>>(new vector<uint16_t>(200,ABSOLUTE_OFFSET_ZERO_VOLTAGE)))));
+	events.push_back(nullptr);
+	DataSet data(events);
+	ThresholdScan loose({-100, -600},0);
+	ASSERT_THROW(loose.fill(data),invalid_argument);
+	ThresholdScan strict({-600, ABSOLUTE_EVENT_THRESHOLD_VOLTAGE},0);
+	strict.fill(data);
+	ASSERT_EQ(2,strict.getNumberOfEvents());
+	ASSERT_DOUBLE_EQ(0.0,strict.getEfficiency(0));
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -7,13 +7,28 @@
 
 #include "../Track.h"
 #include <gtest/gtest.h>
+#include <cmath>
+
+using namespace std;
 
 class TrackTest : public ::testing::Test
 {
 public:
 	TrackTest()
 	{
-
+		//wires next to the line with normal angle 2.0 rad and distance 5 mm, alternating sides
+		const double radii[] = {3.0, 12.5, 7.25, 16.0, 0.5, 9.0};
+		const double c = cos(2.0), s = sin(2.0);
+		for(unsigned int i = 0; i < 6; ++i)
+		{
+			double along = 42.0 * i - 100.0;
+			double side = i % 2 == 0 ? 1 : -1;
+			DriftCircle circle;
+			circle.x = 5.0 * c - along * s + side * radii[i] * c;
+			circle.y = 5.0 * s + along * c + side * radii[i] * s;
+			circle.radius = radii[i];
+			circles.push_back(circle);
+		}
 	}
 
 	void SetUp()
@@ -32,6 +47,7 @@ public:
 	}
 
 protected:
+	vector<DriftCircle> circles;
 };
 
 TEST_F(TrackTest,Dummy)
@@ -39,9 +55,57 @@ TEST_F(TrackTest,Dummy)
 	ASSERT_TRUE(true);
 }
 
+TEST_F(TrackTest,TestFit)
+{
+	Track track = Track::fit(circles.data(),circles.size());
+	ASSERT_TRUE(track.isValid());
+	ASSERT_EQ(6,track.getNumberOfHits());
+	ASSERT_NEAR(2.0,track.getTheta(),1e-6);
+	ASSERT_NEAR(5.0,track.getDistance(),1e-6);
+	ASSERT_NEAR(0.0,track.getChi2(),1e-9);
+	for(const DriftCircle& circle : circles)
+	{
+		ASSERT_NEAR(0.0,track.residual(circle),1e-6);
+	}
+}
+
+TEST_F(TrackTest,TestTooFewHits)
+{
+	ASSERT_FALSE(Track::fit(circles.data(),2).isValid());
+	ASSERT_FALSE(Track().isValid());
+	ASSERT_TRUE(Track::fit(circles.data(),3).isValid());
+}
+
+TEST_F(TrackTest,TestNormalize)
+{
+	Track track(2.0 + M_PI,-5.0);
+	ASSERT_NEAR(2.0,track.getTheta(),1e-12);
+	ASSERT_NEAR(5.0,track.getDistance(),1e-12);
+	ASSERT_NEAR(-5.0,track.distanceTo(0,0),1e-12);
+}
+
+TEST_F(TrackTest,TestDriftRadius)
+{
+	unique_ptr<vector<double>> rt(new vector<double>{0.0, 1.0, 3.0});
+	RtRelation rtRelation(move(rt));
+	ASSERT_DOUBLE_EQ(0.0,Track::driftRadius(rtRelation,-168));
+	ASSERT_DOUBLE_EQ(0.5,Track::driftRadius(rtRelation,0.5 * ADC_BINS_TO_TIME));
+	ASSERT_DOUBLE_EQ(2.0,Track::driftRadius(rtRelation,1.5 * ADC_BINS_TO_TIME));
+	ASSERT_DOUBLE_EQ(3.0,Track::driftRadius(rtRelation,100 * ADC_BINS_TO_TIME));
+}
+
+TEST_F(TrackTest,TestFitFromSeed)
+{
+	Track seed(2.01,5.3);
+	Track track = Track::fit(circles.data(),circles.size(),seed);
+	ASSERT_TRUE(track.isValid());
+	ASSERT_NEAR(2.0,track.getTheta(),1e-6);
+	ASSERT_NEAR(5.0,track.getDistance(),1e-6);
+	ASSERT_FALSE(Track::fit(circles.data(),2,seed).isValid());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
 }
-
@@ -8,12 +8,32 @@
 #include "../TriggerEventCollection.h"
 #include <gtest/gtest.h>
 
+using namespace std;
+
 class TriggerEventCollectionTest : public ::testing::Test
 {
 public:
 	TriggerEventCollectionTest()
 	{
-
+		//tube 0 has a pulse in every event, tube 1 only in even events
+		for(unsigned int tube = 0; tube < 2; ++tube)
+		{
+			vector<unique_ptr<Event>> events;
+			for(unsigned int i = 0; i < 600; ++i)
+			{
+				unique_ptr<vector<uint16_t>> data(new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+				if(tube == 0 || i % 2 == 0)
+				{
+					for(unsigned int bin = 100 + tube; bin < 110 + tube; ++bin)
+					{
+						(*data)[bin] = 1500;
+					}
+				}
+				events.push_back(unique_ptr<Event>(new Event(i,move(data))));
+			}
+			tubes.push_back(unique_ptr<Drifttube>(new Drifttube(tube * 42,10,unique_ptr<DataSet>(new DataSet(events)))));
+		}
+		collection = new TriggerEventCollection(tubes);
 	}
 
 	void SetUp()
@@ -28,10 +48,12 @@ public:
 
 	~TriggerEventCollectionTest()
 	{
-
+		delete collection;
 	}
 
 protected:
+	vector<unique_ptr<Drifttube>> tubes;
+	TriggerEventCollection* collection;
 };
 
 TEST_F(TriggerEventCollectionTest,Dummy)
@@ -39,9 +61,100 @@ TEST_F(TriggerEventCollectionTest,Dummy)
 	ASSERT_TRUE(true);
 }
 
+TEST_F(TriggerEventCollectionTest,TestDimensions)
+{
+	ASSERT_EQ(600,collection->getNumberOfTriggers());
+	ASSERT_EQ(2,collection->getNumberOfTubes());
+	ASSERT_EQ(1200,collection->getData().size());
+	ASSERT_EQ(42.0,collection->getTubePositions()[1][0]);
+	ASSERT_EQ(10.0,collection->getTubePositions()[1][1]);
+}
+
+TEST_F(TriggerEventCollectionTest,TestHits)
+{
+	const Hit& hit = collection->getHit(0,0);
+	ASSERT_TRUE(TriggerEventCollection::isHit(hit));
+	ASSERT_EQ(400,hit.driftTime);
+	ASSERT_EQ(1500 - ABSOLUTE_OFFSET_ZERO_VOLTAGE,hit.amplitude);
+	ASSERT_EQ(40,hit.tot);
+
+	ASSERT_EQ(404,collection->getHit(0,1).driftTime);
+	ASSERT_FALSE(TriggerEventCollection::isHit(collection->getHit(1,1)));
+	ASSERT_EQ(0,collection->getHit(1,1).amplitude);
+}
+
+TEST_F(TriggerEventCollectionTest,TestTriggerBin)
+{
+	//drift times of the hits are relative to the trigger like the drift time spectrum
+	AnalysisConfig config;
+	config.set("triggerbin","20");
+	AnalysisConfig::Scope scope(config);
+	TriggerEventCollection shifted(tubes);
+	ASSERT_EQ(400 - 20 * config.getBinsToTime(),shifted.getHit(0,0).driftTime);
+	ASSERT_EQ(40,shifted.getHit(0,0).tot);
+	ASSERT_EQ(600,DataProcessor::calculateDriftTimeSpectrum(tubes[0]->getDataSet(),1)[(size_t)(shifted.getHit(0,0).driftTime / config.getBinsToTime())]);
+	ASSERT_FALSE(TriggerEventCollection::isHit(shifted.getHit(1,1)));
+
+	//hits before the trigger are set to the trigger time
+	config.set("triggerbin","150");
+	AnalysisConfig::Scope early(config);
+	ASSERT_EQ(0,TriggerEventCollection(tubes).getHit(0,0).driftTime);
+}
+
+TEST_F(TriggerEventCollectionTest,TestSubBinTiming)
+{
+	//the interpolated drift time is before the bin of the threshold crossing, the time over threshold starts there
+	AnalysisConfig config;
+	config.set("timing","interpolated");
+	AnalysisConfig::Scope scope(config);
+	unique_ptr<vector<uint16_t>> data(new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+	for(unsigned int bin = 100; bin < 110; ++bin)
+	{
+		(*data)[bin] = 1500;
+	}
+	vector<unique_ptr<Event>> events;
+	events.push_back(unique_ptr<Event>(new Event(0,move(data))));
+	const double driftTime = events[0]->getDriftTime();
+	vector<unique_ptr<Drifttube>> interpolated;
+	interpolated.push_back(unique_ptr<Drifttube>(new Drifttube(0,0,unique_ptr<DataSet>(new DataSet(events)))));
+	Hit hit = TriggerEventCollection(interpolated).getHit(0,0);
+	ASSERT_LT(driftTime,400);
+	ASSERT_FLOAT_EQ(driftTime,hit.driftTime);
+	ASSERT_EQ(40,hit.tot);
+}
+
+TEST_F(TriggerEventCollectionTest,TestPositivePolarity)
+{
+	AnalysisConfig config;
+	config.set("polarity","positive");
+	AnalysisConfig::Scope scope(config);
+	unique_ptr<vector<uint16_t>> data(new vector<uint16_t>(800,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+	for(unsigned int bin = 100; bin < 110; ++bin)
+	{
+		(*data)[bin] = ABSOLUTE_OFFSET_ZERO_VOLTAGE + 700;
+	}
+	vector<unique_ptr<Event>> events;
+	events.push_back(unique_ptr<Event>(new Event(0,move(data))));
+	vector<unique_ptr<Drifttube>> positive;
+	positive.push_back(unique_ptr<Drifttube>(new Drifttube(0,0,unique_ptr<DataSet>(new DataSet(events)))));
+	Hit hit = TriggerEventCollection(positive).getHit(0,0);
+	ASSERT_EQ(700,hit.amplitude);
+	ASSERT_FLOAT_EQ(400,hit.driftTime);
+	ASSERT_EQ(40,hit.tot);
+}
+
+TEST_F(TriggerEventCollectionTest,TestTriggerOrder)
+{
+	for(unsigned int trigger = 0; trigger < collection->getNumberOfTriggers(); ++trigger)
+	{
+		const Hit* hits = (*collection)[trigger];
+		ASSERT_EQ(&collection->getHit(trigger,0),hits);
+		ASSERT_EQ(trigger % 2 == 0 ? 2 : 1,collection->countHits(trigger));
+	}
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
 }
-
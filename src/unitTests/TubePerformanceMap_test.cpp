@@ -0,0 +1,153 @@
+/*
+ * TubePerformanceMap_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: bieschke
+ */
+
+#include "../TubePerformanceMap.h"
+#include "../DataProcessor.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+//true rt-relation of the simulated tubes, the maximum drift time is 600 ns
+static double trueRadius(const double driftTime)
+{
+	return driftTime >= 600 ? DRIFT_TUBE_RADIUS : DRIFT_TUBE_RADIUS * pow(driftTime / 600, 0.7);
+}
+
+class TubePerformanceMapTest : public ::testing::Test
+{
+public:
+	TubePerformanceMapTest()
+	{
+		//staggered chamber of 4 layers with 8 tubes each, tube 5 only sees every second track
+		const unsigned int nTriggers = 1000;
+		const unsigned int nBins = 200;
+		vector<TubeGeometry> wires;
+		for(unsigned int layer = 0; layer < 4; ++layer)
+		{
+			for(unsigned int tube = 0; tube < 8; ++tube)
+			{
+				TubeGeometry wire = {layer * 8 + tube, 2 * DRIFT_TUBE_RADIUS * tube + DRIFT_TUBE_RADIUS * (layer % 2), 31.5 * layer, DRIFT_TUBE_RADIUS};
+				wires.push_back(wire);
+			}
+		}
+		vector<vector<unique_ptr<Event>>> events(wires.size());
+		mt19937 generator(7);
+		uniform_real_distribution<double> angle(-0.4,0.4);
+		uniform_real_distribution<double> position(40,230);
+		for(unsigned int trigger = 0; trigger < nTriggers; ++trigger)
+		{
+			double theta = angle(generator);
+			double distance = position(generator) * cos(theta);
+			for(unsigned int tube = 0; tube < wires.size(); ++tube)
+			{
+				unique_ptr<vector<uint16_t>> data(new vector<uint16_t>(nBins,ABSOLUTE_OFFSET_ZERO_VOLTAGE));
+				double radius = fabs(wires[tube].x * cos(theta) + wires[tube].y * sin(theta) - distance);
+				if(radius < DRIFT_TUBE_RADIUS && (tube != 5 || trigger % 2 == 0))
+				{
+					size_t bin = lround(600 * pow(radius / DRIFT_TUBE_RADIUS, 1 / 0.7) / ADC_BINS_TO_TIME);
+					for(size_t i = bin; i < bin + 5; ++i)
+					{
+						(*data)[i] = 1500;
+					}
+				}
+				events[tube].push_back(unique_ptr<Event>(new Event(trigger,move(data))));
+			}
+		}
+		for(unsigned int tube = 0; tube < wires.size(); ++tube)
+		{
+			tubes.push_back(unique_ptr<Drifttube>(new Drifttube(wires[tube].x,wires[tube].y,unique_ptr<DataSet>(new DataSet(events[tube])))));
+		}
+		hits = new TriggerEventCollection(tubes);
+		geometry = new ChamberGeometry(wires);
+
+		unique_ptr<vector<double>> rt(new vector<double>(nBins));
+		for(unsigned int bin = 0; bin < nBins; ++bin)
+		{
+			(*rt)[bin] = trueRadius(bin * ADC_BINS_TO_TIME);
+		}
+		rtRelation = new RtRelation(move(rt));
+		rtRelations.assign(tubes.size(),rtRelation);
+		tracks = DataProcessor::reconstructTracks(*hits,rtRelations);
+	}
+
+	~TubePerformanceMapTest()
+	{
+		delete hits;
+		delete geometry;
+		delete rtRelation;
+	}
+
+protected:
+	vector<unique_ptr<Drifttube>> tubes;
+	TriggerEventCollection* hits;
+	ChamberGeometry* geometry;
+	RtRelation* rtRelation;
+	vector<const RtRelation*> rtRelations;
+	vector<Track> tracks;
+};
+
+TEST_F(TubePerformanceMapTest,TestEfficiency)
+{
+	TubePerformanceMap map(tubes.size());
+	map.fill(*hits,tracks,*geometry,rtRelations);
+	ASSERT_EQ(tubes.size(),map.getNumberOfTubes());
+	ASSERT_EQ(36,map.getNumberOfBins());
+	ASSERT_DOUBLE_EQ(DRIFT_TUBE_RADIUS / 36,map.getBinWidth());
+
+	unsigned long crossed = 0;
+	for(unsigned int bin = 0; bin < map.getNumberOfBins(); ++bin)
+	{
+		crossed += map.getCrossed(5,bin);
+		ASSERT_TRUE(map.getHits(5,bin) <= map.getCrossed(5,bin));
+	}
+	ASSERT_TRUE(crossed > 50);
+	ASSERT_NEAR(0.5,map.getEfficiency(5),0.15);
+	//tracks with wrong left-right ambiguities fake some crossings, mostly at the tube walls
+	for(unsigned int tube = 9; tube < 15; ++tube)
+	{
+		ASSERT_TRUE(map.getEfficiency(tube) > 0.9);
+	}
+}
+
+TEST_F(TubePerformanceMapTest,TestResolution)
+{
+	TubePerformanceMap map(tubes.size(),18);
+	map.fill(*hits,tracks,*geometry,rtRelations);
+	for(unsigned int bin = 2; bin < 16; ++bin)
+	{
+		if(map.getHits(12,bin) > 10)
+		{
+			ASSERT_TRUE(map.getResolution(12,bin) < 0.3);
+			ASSERT_NEAR(0,map.getMeanResidual(12,bin),0.2);
+		}
+	}
+}
+
+TEST_F(TubePerformanceMapTest,TestMerge)
+{
+	TubePerformanceMap first(tubes.size());
+	TubePerformanceMap second(tubes.size());
+	first.fill(*hits,tracks,*geometry,rtRelations);
+	second.fill(*hits,tracks,*geometry,rtRelations);
+	unsigned long crossed = first.getCrossed(10,20);
+	double resolution = first.getResolution(10,20);
+	first.merge(second);
+	ASSERT_EQ(2 * crossed,first.getCrossed(10,20));
+	ASSERT_NEAR(resolution,first.getResolution(10,20),1e-9);
+
+	TubePerformanceMap other(tubes.size(),18);
+	ASSERT_THROW(first.merge(other),invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}